@@ -1,7 +1,8 @@
 #include "exercises.h"
+#include "ThreadPool.h"
+#include "Trace.h"
 
 #include <limits>
-#include <thread>
 #include <algorithm>
 #include <cmath>
 
@@ -47,10 +48,12 @@ static int numThreads = 1;
 
 void setNumThreads(int num) {
     numThreads = num;
+    ThreadPool::setGlobalNumThreads(num);
 }
 
 // Auxiliary functions to sort vector of points by X or Y axis.
 static void sortByX(std::vector<Point> &v, int left, int right) {
+    TRACE_SCOPE("closest_pair_sort_x");
     std::sort(v.begin() + left, v.begin() + right + 1,
               [](Point p, Point q) { return p.x < q.x || (p.x == q.x && p.y < q.y); });
 }
@@ -81,28 +84,25 @@ Result nearestPoints_BF_SortByX(std::vector<Point> &vp) {
     return res;
 }
 
-// O(Nlog^2N)
-Result nearestPoints_DCRecursive(std::vector<Point> &vp, int leftIdx, int rightIdx) {
-    // Base Cases
-    if (leftIdx >= rightIdx) {      // 0 or 1 points (no possible pair)
-        return {};
-    }
-    if (leftIdx == rightIdx - 1) {  // 2 points
-        return {vp.at(leftIdx).distance(vp.at(rightIdx)), vp.at(leftIdx), vp.at(rightIdx)};
-    }
-
-    // Split
-    int middleIdx = (int) round((leftIdx + rightIdx) / 2.0);
-    Result nearestPointsLeft = nearestPoints_DCRecursive(vp, leftIdx, middleIdx);
-    Result nearestPointsRight = nearestPoints_DCRecursive(vp, middleIdx + 1, rightIdx);
+/**
+ * Merges (and subproblems) smaller than this are not traced, they would flood the trace.
+ */
+static const int MIN_POINTS_TRACED = 4096;
 
-    // Merge
-    Result nearestPoints{};
-    nearestPoints.dmin = std::min(nearestPointsLeft.dmin, nearestPointsRight.dmin);
+/*
+ * Merge step shared by both divide-and-conquer versions: starts from the best
+ * of the two halves and checks the pairs of [leftIdx, rightIdx] that are closer
+ * than that in the Y axis.
+ * Only touches its own range, so sibling subproblems can be merged concurrently.
+ */
+static Result mergeNearestPoints(std::vector<Point> &vp, int leftIdx, int rightIdx,
+                                 const Result &nearestPointsLeft, const Result &nearestPointsRight) {
+    TRACE_SCOPE_IF(rightIdx - leftIdx >= MIN_POINTS_TRACED, "closest_pair_merge");
+    Result nearestPoints = nearestPointsLeft.dmin <= nearestPointsRight.dmin ? nearestPointsLeft : nearestPointsRight;
 
     sortByY(vp, leftIdx, rightIdx);
-    for (int i = 0; i < rightIdx; ++i) {
-        for (int j = i + 1; j < rightIdx; ++j) {
+    for (int i = leftIdx; i <= rightIdx; ++i) {
+        for (int j = i + 1; j <= rightIdx; ++j) {
             if (std::abs(vp.at(i).y - vp.at(j).y) > nearestPoints.dmin) {
                 break;
             } else {
@@ -116,16 +116,10 @@ Result nearestPoints_DCRecursive(std::vector<Point> &vp, int leftIdx, int rightI
     }
 
     return nearestPoints;
-
 }
 
-
-Result nearestPoints_DC(std::vector<Point> &vp) {
-    sortByX(vp, 0, vp.size() - 1);
-    return nearestPoints_DCRecursive(vp, 0, vp.size() - 1);
-}
-
-Result nearestPoints_DCRecursive(std::vector<Point> &vp, int leftIdx, int rightIdx, int threads) {
+// O(Nlog^2N)
+Result nearestPoints_DCRecursive(std::vector<Point> &vp, int leftIdx, int rightIdx) {
     // Base Cases
     if (leftIdx >= rightIdx) {      // 0 or 1 points (no possible pair)
         return {};
@@ -136,46 +130,48 @@ Result nearestPoints_DCRecursive(std::vector<Point> &vp, int leftIdx, int rightI
 
     // Split
     int middleIdx = (int) round((leftIdx + rightIdx) / 2.0);
-    Result nearestPointsLeft;
-    Result nearestPointsRight;
-    if (numThreads > 2) { // multi-thread
-        std::thread leftThread([&nearestPointsLeft, &vp, leftIdx, middleIdx]() {
-            nearestPointsLeft = nearestPoints_DCRecursive(vp, leftIdx, middleIdx);
-        });
-        std::thread rightThread([&nearestPointsRight, &vp, rightIdx, middleIdx]() {
-            nearestPointsRight = nearestPoints_DCRecursive(vp, middleIdx + 1, rightIdx);
-        });
-        leftThread.join();
-        rightThread.join();
-
-    } else {
-        nearestPointsLeft = nearestPoints_DCRecursive(vp, leftIdx, middleIdx);
-        nearestPointsRight = nearestPoints_DCRecursive(vp, middleIdx + 1, rightIdx);
-    }
+    Result nearestPointsLeft = nearestPoints_DCRecursive(vp, leftIdx, middleIdx);
+    Result nearestPointsRight = nearestPoints_DCRecursive(vp, middleIdx + 1, rightIdx);
 
     // Merge
-    Result nearestPoints{};
-    nearestPoints.dmin = std::min(nearestPointsLeft.dmin, nearestPointsRight.dmin);
+    return mergeNearestPoints(vp, leftIdx, rightIdx, nearestPointsLeft, nearestPointsRight);
+}
 
-    sortByY(vp, leftIdx, rightIdx);
-    for (int i = 0; i < rightIdx; ++i) {
-        for (int j = i + 1; j < rightIdx; ++j) {
-            if (std::abs(vp.at(i).y - vp.at(j).y) > nearestPoints.dmin) {
-                break;
-            } else {
-                if (vp.at(i).distance(vp.at(j)) < nearestPoints.dmin) {
-                    nearestPoints.dmin = vp.at(i).distance(vp.at(j));
-                    nearestPoints.p1 = vp.at(i);
-                    nearestPoints.p2 = vp.at(j);
-                }
-            }
-        }
+
+Result nearestPoints_DC(std::vector<Point> &vp) {
+    sortByX(vp, 0, vp.size() - 1);
+    TRACE_SCOPE("closest_pair_recursion");
+    return nearestPoints_DCRecursive(vp, 0, vp.size() - 1);
+}
+
+/**
+ * Subproblems smaller than this are not worth a task of their own.
+ */
+static const int MIN_POINTS_PER_TASK = 1024;
+
+Result nearestPoints_DCRecursive(std::vector<Point> &vp, int leftIdx, int rightIdx, int threads) {
+    if (threads <= 1 || rightIdx - leftIdx < MIN_POINTS_PER_TASK) {
+        TRACE_SCOPE_IF(rightIdx - leftIdx >= MIN_POINTS_TRACED, "closest_pair_sequential_task");
+        return nearestPoints_DCRecursive(vp, leftIdx, rightIdx);
     }
 
-    return nearestPoints;
+    // Split: the left half becomes a task of the shared pool, the right half runs here
+    int middleIdx = (int) round((leftIdx + rightIdx) / 2.0);
+    Result nearestPointsLeft;
+    Result nearestPointsRight;
+    TaskGroup group;
+    group.spawn([&nearestPointsLeft, &vp, leftIdx, middleIdx, threads]() {
+        nearestPointsLeft = nearestPoints_DCRecursive(vp, leftIdx, middleIdx, threads / 2);
+    });
+    nearestPointsRight = nearestPoints_DCRecursive(vp, middleIdx + 1, rightIdx, threads - threads / 2);
+    group.sync();
+
+    // Merge
+    return mergeNearestPoints(vp, leftIdx, rightIdx, nearestPointsLeft, nearestPointsRight);
 }
 
 Result nearestPoints_DC_MT(std::vector<Point> &vp) {
+    sortByX(vp, 0, vp.size() - 1);
     return nearestPoints_DCRecursive(vp, 0, vp.size() - 1, numThreads);
 }
 
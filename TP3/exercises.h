@@ -44,7 +44,8 @@ Result nearestPoints_BF_SortByX(std::vector<Point> &vp);
 // Divide-and-conquer with a single thread
 Result nearestPoints_DC(std::vector<Point> &vp);
 
-// Divide-and-conquer with multiple threads (number of threads is set using setNumThreads).
+// Divide-and-conquer with multiple threads, run on the shared ThreadPool
+// (number of threads is set using setNumThreads).
 Result nearestPoints_DC_MT(std::vector<Point> &vp);
 
 // Pointer to function that computes nearest points
@@ -154,42 +154,6 @@ int maxSubsequenceDC(int A[], unsigned int n, unsigned int &i, unsigned int &j)
     return maxSubsequenceDCRec(A, 0, n - 1, i, j);
 }
 
-#include <chrono>
-#include <iostream>
-
-
-void testPerformanceMaxSubsequence() {
-    srand(time(NULL));
-    const unsigned long N_ITERATIONS = 5;
-    const unsigned long MIN_SIZE = 0;
-    const unsigned long MAX_SIZE = 10000;
-    const unsigned long STEP_SIZE = 500;
-    int A[MAX_SIZE];
-    std::cout << "n; DP time (s); DC time (s)" << std::endl;
-    for (unsigned long size = MIN_SIZE; size < MAX_SIZE; size += STEP_SIZE) {
-        auto elapsedDP = std::chrono::duration<double>::zero();
-        auto elapsedDC = std::chrono::duration<double>::zero();
-        for (unsigned long k = 0; k < N_ITERATIONS; ++k) {
-            for (unsigned long i = 0; i < size; ++i) {
-                A[i] = rand() % (10 * size) - (5 * size);
-            }
-
-            unsigned i, j;
-            auto start = std::chrono::high_resolution_clock::now();
-            maxSubsequenceDP(A, size, i, j);
-            auto end = std::chrono::high_resolution_clock::now();
-            elapsedDP += (end - start);
-
-            start = std::chrono::high_resolution_clock::now();
-            maxSubsequenceDC(A, size, i, j);
-            end = std::chrono::high_resolution_clock::now();
-            elapsedDC += (end - start);
-        }
-        std::cout << size << ";" << (elapsedDP.count() / N_ITERATIONS) << ";" << (elapsedDC.count() / N_ITERATIONS)
-                  << std::endl;
-    }
-}
-
 /// TESTS ///
 #include <gtest/gtest.h>
 
@@ -218,6 +182,4 @@ TEST(TP4_Ex6, testMaxSubsequence) {
     EXPECT_EQ(maxSubsequenceDP(A4, n4, i, j), 6);
     EXPECT_EQ(i, 3);
     EXPECT_EQ(j, 6);
-
-    testPerformanceMaxSubsequence();
 }
\ No newline at end of file
@@ -39,6 +39,6 @@ int maxSubsequenceBF(int A[], unsigned int n, unsigned int &i, unsigned int &j);
 
 int maxSubsequenceDC(int A[], unsigned int n, unsigned int &i, unsigned int &j);
 
-void testPerformanceMaxSubsequence();
+// The DP and DC versions are compared in bench/TP4_bench.cpp
 
 #endif //CAL_TP4_CLASSES_EXERCISES_H
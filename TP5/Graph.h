@@ -1,112 +1,78 @@
 /*
  * Graph.h
+ * Fp05 interface over the common graph library (common/graph).
  */
 #ifndef GRAPH_H_
 #define GRAPH_H_
 
 #include <vector>
 #include <queue>
-#include <algorithm>
+#include "graph/Graph.h"
+#include "graph/Centrality.h"
+#include "graph/Components.h"
+#include "graph/DynamicTopologicalOrder.h"
+#include "graph/PageRank.h"
+#include "graph/Reachability.h"
+#include "graph/Traversal.h"
+#include "graph/Triangles.h"
 
-template<class T>
-class Edge;
+// W: type of the edge weights (see graph/WeightTraits.h)
+template<class T, class W = double>
+using Vertex = cal::Vertex<T, cal::Weight<W>>;
 
-template<class T>
-class Graph;
+template<class T, class W = double>
+using Edge = cal::Edge<T, cal::Weight<W>>;
 
-template<class T>
-class Vertex;
+template<class T, class W = double>
+class Graph : public cal::Graph<T, cal::Weight<W>> {
+    using Base = cal::Graph<T, cal::Weight<W>>;
 
-
-/****************** Provided structures  ********************/
-
-template<class T>
-class Vertex {
-    T info;                // contents
-    std::vector<Edge<T> > adj;  // list of outgoing edges
-    bool visited;          // auxiliary field used by dfs and bfs
-    bool processing;       // auxiliary field used by isDAG
-    int indegree;          // auxiliary field used by topsort
-
-    void addEdge(Vertex<T> *dest, double w);
-
-    bool removeEdgeTo(Vertex<T> *d);
-
-public:
-    explicit Vertex(T in);
-
-    friend class Graph<T>;
-};
-
-template<class T>
-class Edge {
-    Vertex<T> *dest;      // destination vertex
-    double weight;         // edge weight
-public:
-    Edge(Vertex<T> *d, double w);
-
-    friend class Graph<T>;
-
-    friend class Vertex<T>;
-};
-
-template<class T>
-class Graph {
-    std::vector<Vertex<T> *> vertexSet;    // vertex set
-
-    void dfsVisit(Vertex<T> *v, std::vector<T> &res) const;
-
-    Vertex<T> *findVertex(const T &in) const;
-
-    bool dfsIsDAG(Vertex<T> *v) const;
+protected:
+    std::vector<T> infos(const std::vector<unsigned> &ids) const;
 
 public:
-    int getNumVertex() const;
-
     bool addVertex(const T &in);
 
-    bool removeVertex(const T &in);
+    bool addEdge(const T &sourc, const T &dest, W w);
 
-    bool addEdge(const T &sourc, const T &dest, double w);
+    /*
+     * The searches keep their state in a SearchContext (by default, the one of the calling
+     * thread), so they can run concurrently on the same graph.
+     */
+    std::vector<T> dfs(SearchContext &ctx = SearchContext::local()) const;
 
-    bool removeEdge(const T &sourc, const T &dest);
+    std::vector<T> bfs(const T &source, SearchContext &ctx = SearchContext::local()) const;
 
-    std::vector<T> dfs() const;
+    std::vector<T> topsort(SearchContext &ctx = SearchContext::local()) const;
 
-    std::vector<T> bfs(const T &source) const;
+    int maxNewChildren(const T &source, T &inf, SearchContext &ctx = SearchContext::local()) const;
 
-    std::vector<T> topsort() const;
+    bool isDAG(SearchContext &ctx = SearchContext::local()) const;
 
-    int maxNewChildren(const T &source, T &inf) const;
+    std::vector<std::vector<T>> stronglyConnectedComponents() const;
 
-    bool isDAG() const;
-};
+    Graph<std::vector<T>, W> condensation() const;
 
-/****************** Provided constructors and functions ********************/
+    cal::ReachabilityIndex reachabilityIndex(
+            cal::ReachabilityIndex::Mode mode = cal::ReachabilityIndex::Mode::Auto) const;
 
-template<class T>
-Vertex<T>::Vertex(T in): info(in) {
-}
+    std::vector<double> betweennessCentrality(unsigned samples = 0, unsigned seed = 0) const;
 
-template<class T>
-Edge<T>::Edge(Vertex<T> *d, double w): dest(d), weight(w) {
-}
+    std::vector<double> pageRank(double damping = 0.85, double tolerance = 1e-6) const;
 
+    std::vector<std::pair<T, double>> personalizedPageRank(const T &seed, double damping = 0.85,
+                                                           double epsilon = 1e-7) const;
 
-template<class T>
-int Graph<T>::getNumVertex() const {
-    return vertexSet.size();
-}
+    cal::Triangles triangles() const;
+};
 
-/*
- * Auxiliary function to find a vertex with a given content.
- */
-template<class T>
-Vertex<T> *Graph<T>::findVertex(const T &in) const {
-    for (auto v : vertexSet)
-        if (v->info == in)
-            return v;
-    return NULL;
+template<class T, class W>
+std::vector<T> Graph<T, W>::infos(const std::vector<unsigned> &ids) const {
+    std::vector<T> res;
+    res.reserve(ids.size());
+    for (unsigned id : ids)
+        res.push_back(this->getInfo(id));
+    return res;
 }
 
 /****************** 1a) addVertex ********************/
@@ -115,14 +81,9 @@ Vertex<T> *Graph<T>::findVertex(const T &in) const {
  *  Adds a vertex with a given content/info (in) to a graph (this).
  *  Returns true if successful, and false if a vertex with that content already exists.
  */
-template<class T>
-bool Graph<T>::addVertex(const T &in) {
-    if (findVertex(in) != NULL) {
-        return false;
-    }
-    auto *v = new Vertex<T>(in);
-    this->vertexSet.push_back(v);
-    return false;
+template<class T, class W>
+bool Graph<T, W>::addVertex(const T &in) {
+    return Base::addVertex(in) != nullptr;
 }
 
 /****************** 1b) addEdge ********************/
@@ -132,117 +93,24 @@ bool Graph<T>::addVertex(const T &in) {
  * destination (dest) vertices and the edge weight (w).
  * Returns true if successful, and false if the source or destination vertex does not exist.
  */
-template<class T>
-bool Graph<T>::addEdge(const T &sourc, const T &dest, double w) {
-    Vertex<T> *srcV = findVertex(sourc);
-    if (srcV == NULL) return false;
-    Vertex<T> *destV = findVertex(dest);
-    if (destV == NULL) return false;
-    srcV->addEdge(destV, w);
-    return true;
-}
-
-/*
- * Auxiliary function to add an outgoing edge to a vertex (this),
- * with a given destination vertex (d) and edge weight (w).
- */
-template<class T>
-void Vertex<T>::addEdge(Vertex<T> *d, double w) {
-    Edge<T> e(d, w);
-    this->adj.push_back(e);
-}
-
-
-/****************** 1c) removeEdge ********************/
-
-/*
- * Removes an edge from a graph (this).
- * The edge is identified by the source (sourc) and destination (dest) contents.
- * Returns true if successful, and false if such edge does not exist.
- */
-template<class T>
-bool Graph<T>::removeEdge(const T &sourc, const T &dest) {
-    Vertex<T> *srcV = findVertex(sourc);
-    if (srcV == NULL) return false;
-    Vertex<T> *destV = findVertex(dest);
-    if (destV == NULL) return false;
-    return srcV->removeEdgeTo(destV);
+template<class T, class W>
+bool Graph<T, W>::addEdge(const T &sourc, const T &dest, W w) {
+    return Base::addEdge(sourc, dest, w) != nullptr;
 }
 
-/*
- * Auxiliary function to remove an outgoing edge (with a given destination (d))
- * from a vertex (this).
- * Returns true if successful, and false if such edge does not exist.
- */
-template<class T>
-bool Vertex<T>::removeEdgeTo(Vertex<T> *d) {
-    for (auto it = adj.begin(); it != adj.end(); ++it) {
-        if (it->dest == d) {
-            adj.erase(it);
-            return true;
-        }
-    }
-    return false;
-}
-
-
-/****************** 1d) removeVertex ********************/
-
-/*
- *  Removes a vertex with a given content (in) from a graph (this), and
- *  all outgoing and incoming edges.
- *  Returns true if successful, and false if such vertex does not exist.
- */
-template<class T>
-bool Graph<T>::removeVertex(const T &in) {
-    for (auto it = vertexSet.begin(); it != vertexSet.end(); ++it) {
-        if (in == (*it)->info) {
-            for (auto toIt = vertexSet.begin(); toIt != vertexSet.end(); ++toIt) {
-                (*toIt)->removeEdgeTo(*it);
-            }
-            delete *it;
-            vertexSet.erase(it);
-            return true;
-        }
-    }
-    return false;
-}
+/****************** 1c) removeEdge, 1d) removeVertex ********************/
 
+// See cal::Graph::removeEdge and cal::Graph::removeVertex
 
 /****************** 2a) dfs ********************/
 
 /*
  * Performs a depth-first search (dfs) in a graph (this).
  * Returns a vector with the contents of the vertices by dfs order.
- * Follows the algorithm described in theoretical classes.
  */
-template<class T>
-std::vector<T> Graph<T>::dfs() const {
-    for (auto vert : vertexSet) {
-        vert->visited = false;
-    }
-    std::vector<T> res;
-    for (auto vert : vertexSet) {
-        if (!vert->visited) {
-            this->dfsVisit(vert, res);
-        }
-    }
-    return res;
-}
-
-/*
- * Auxiliary function that visits a vertex (v) and its adjacent not yet visited, recursively.
- * Updates a parameter with the list of visited node contents.
- */
-template<class T>
-void Graph<T>::dfsVisit(Vertex<T> *v, std::vector<T> &res) const {
-    v->visited = true;
-    res.push_back(v->info);
-    for (auto e : v->adj) {
-        if (!e.dest->visited) {
-            dfsVisit(e.dest, res);
-        }
-    }
+template<class T, class W>
+std::vector<T> Graph<T, W>::dfs(SearchContext &ctx) const {
+    return infos(cal::dfsOrder(*this, ctx));
 }
 
 /****************** 2b) bfs ********************/
@@ -250,34 +118,14 @@ void Graph<T>::dfsVisit(Vertex<T> *v, std::vector<T> &res) const {
 /*
  * Performs a breadth-first search (bfs) in a graph (this), starting
  * from the vertex with the given source contents (source).
- * Returns a vector with the contents of the vertices by dfs order.
- * Follows the algorithm described in theoretical classes.
+ * Returns a vector with the contents of the vertices by bfs order.
  */
-template<class T>
-std::vector<T> Graph<T>::bfs(const T &source) const {
-    std::vector<T> res;
-    for (auto vert : vertexSet) {
-        vert->visited = false;
-    }
-    Vertex<T> *s = findVertex(source);
-    if (s == NULL) {
-        return res;
-    }
-    s->visited = true;
-    std::queue<Vertex<T> *> Q;
-    Q.push(s);
-    while (!Q.empty()) {
-        Vertex<T> *a = Q.front();
-        res.push_back(a->info);
-        Q.pop();
-        for (auto edge : a->adj) {
-            if (!edge.dest->visited) {
-                Q.push(edge.dest);
-                edge.dest->visited = true;
-            }
-        }
-    }
-    return res;
+template<class T, class W>
+std::vector<T> Graph<T, W>::bfs(const T &source, SearchContext &ctx) const {
+    int s = this->findVertexId(source);
+    if (s < 0)
+        return {};
+    return infos(cal::bfsOrder(*this, s, ctx));
 }
 
 /****************** 2c) toposort ********************/
@@ -286,43 +134,10 @@ std::vector<T> Graph<T>::bfs(const T &source) const {
  * Performs a topological sorting of the vertices of a graph (this).
  * Returns a vector with the contents of the vertices by topological order.
  * If the graph has cycles, returns an empty vector.
- * Follows the algorithm described in theoretical classes.
  */
-
-template<class T>
-std::vector<T> Graph<T>::topsort() const {
-    std::vector<T> res;
-    for (Vertex<T> *vertex : vertexSet) {
-        vertex->indegree = 0;
-    }
-    for (Vertex<T> *v : vertexSet) {
-        for (Edge<T> w : v->adj) {
-            w.dest->indegree++;
-        }
-    }
-    std::queue<Vertex<T> *> queue{
-    };
-    for (Vertex<T> *vertex : vertexSet) {
-        if (vertex->indegree == 0) {
-            queue.push(vertex);
-        }
-    }
-    while (!queue.empty()) {
-        Vertex<T> *v = queue.front();
-        queue.pop();
-        res.push_back(v->info);
-        for (Edge<T> edge : v->adj) {
-            edge.dest->indegree--;
-            if (edge.dest->indegree == 0) {
-                queue.push(edge.dest);
-            }
-        }
-    }
-    if (res.size() != vertexSet.size()) {
-        return {
-        };
-    }
-    return res;
+template<class T, class W>
+std::vector<T> Graph<T, W>::topsort(SearchContext &ctx) const {
+    return infos(cal::topologicalOrder(*this, ctx));
 }
 
 /****************** 3a) maxNewChildren (HOME WORK)  ********************/
@@ -334,42 +149,35 @@ std::vector<T> Graph<T>::topsort() const {
  * of new children (adjacent not previously visited), and returns the
  * contents of that vertex (inf) and the number of new children (return value).
  */
-
-template<class T>
-int Graph<T>::maxNewChildren(const T &source, T &inf) const {
-    int maxChildren = 0;
-    Vertex<T> *vertex = findVertex(source);
-    if (vertex == nullptr) {
-        inf = T{
-        };
+template<class T, class W>
+int Graph<T, W>::maxNewChildren(const T &source, T &inf, SearchContext &ctx) const {
+    int s = this->findVertexId(source);
+    if (s < 0) {
+        inf = T{};
         return 0;
     }
-
-    for (Vertex<T> *v : vertexSet) {
-        v->visited = false;
-    }
-
-    vertex->visited = true;
-    std::queue<Vertex<T> *> toVisit{};
-    toVisit.push(vertex);
-
+    int maxChildren = 0;
+    ctx.reset(this->getNumVertex());
+    ctx[s].visited = true;
+    std::queue<unsigned> toVisit;
+    toVisit.push(s);
     while (!toVisit.empty()) {
-        Vertex<T> *found = toVisit.front();
+        unsigned u = toVisit.front();
         toVisit.pop();
         int childCount = 0;
-        for (Edge<T> adjEdge : found->adj) {
-            if (!adjEdge.dest->visited) {
-                toVisit.push(adjEdge.dest);
-                adjEdge.dest->visited = true;
+        for (auto e : this->out(u)) {
+            unsigned v = this->target(e);
+            if (!ctx[v].visited) {
+                toVisit.push(v);
+                ctx[v].visited = true;
                 ++childCount;
             }
         }
         if (childCount > maxChildren) {
             maxChildren = childCount;
-            inf = found->info;
+            inf = this->getInfo(u);
         }
     }
-
     return maxChildren;
 }
 
@@ -378,38 +186,201 @@ int Graph<T>::maxNewChildren(const T &source, T &inf) const {
 /*
  * Performs a depth-first search in a graph (this), to determine if the graph
  * is acyclic (acyclic directed graph or DAG).
- * During the search, a cycle is found if an edge connects to a vertex
- * that is being processed in the the stack of recursive calls (see theoretical classes).
  * Returns true if the graph is acyclic, and false otherwise.
  */
+template<class T, class W>
+bool Graph<T, W>::isDAG(SearchContext &ctx) const {
+    return cal::isAcyclic(*this, ctx);
+}
 
-template<class T>
-bool Graph<T>::isDAG() const {
-    for (Vertex<T> *vertex : vertexSet) {
-        vertex->processing = false;
-        vertex->visited = false;
-    }
-    return std::all_of(vertexSet.begin(), vertexSet.end(), [this](Vertex<T>* vertex){
-        return vertex->visited || dfsIsDAG(vertex);
-    });
+/****************** 4) strongly connected components ********************/
+
+/*
+ * Strongly connected components of a graph (this), with Tarjan's algorithm.
+ * Returns the contents of the vertices of each component; the components come in
+ * topological order (edges between components go to a later one).
+ */
+template<class T, class W>
+std::vector<std::vector<T>> Graph<T, W>::stronglyConnectedComponents() const {
+    std::vector<std::vector<T>> res;
+    for (const auto &members : cal::tarjanScc(*this).members())
+        res.push_back(infos(members));
+    return res;
 }
 
-/**
- * Auxiliary function that visits a vertex (v) and its adjacent not yet visited, recursively.
- * Returns false (not acyclic) if an edge to a vertex in the stack is found.
+/*
+ * Condensation of a graph (this): the DAG with a vertex for each strongly connected
+ * component (its content is the contents of its vertices, as in stronglyConnectedComponents)
+ * and an edge between two components if there is any edge between their vertices
+ * (with the minimum weight of those edges).
  */
-template<class T>
-bool Graph<T>::dfsIsDAG(Vertex<T> *v) const {
-    v->processing = true;
-    v->visited = true;
-    for (Edge<T> adjEdge : v->adj) {
-        if (adjEdge.dest->processing) return false;
-        if (!adjEdge.dest->visited) {
-            if (!dfsIsDAG(adjEdge.dest)) return false;
-        }
-    }
-    v->processing = false;
+template<class T, class W>
+Graph<std::vector<T>, W> Graph<T, W>::condensation() const {
+    cal::Components scc = cal::tarjanScc(*this);
+    auto dag = cal::condensation(*this, scc);
+    Graph<std::vector<T>, W> res;
+    for (const auto &members : scc.members())
+        res.appendVertex(infos(members));
+    for (auto v : dag.getVertexSet())
+        for (auto e : v->getAdj())
+            res.addEdgeById(v->getId(), e->getDest()->getId(), e->getWeight());
+    return res;
+}
+
+/*
+ * Index for "is there a path from u to v" queries on a graph (this), given the ids of the
+ * vertices (see graph/Reachability.h): bit sets of the transitive closure for moderate sizes,
+ * interval labels for large graphs. It is not updated when the graph changes.
+ */
+template<class T, class W>
+cal::ReachabilityIndex Graph<T, W>::reachabilityIndex(cal::ReachabilityIndex::Mode mode) const {
+    return cal::ReachabilityIndex(*this, mode);
+}
+
+/*
+ * Betweenness centrality of each vertex (by id, as in getVertexSet), counting the shortest
+ * paths in number of edges (see graph/Centrality.h). With samples > 0, an estimate from
+ * that many random sources, for large networks.
+ */
+template<class T, class W>
+std::vector<double> Graph<T, W>::betweennessCentrality(unsigned samples, unsigned seed) const {
+    return cal::betweenness(*this, samples, seed);
+}
+
+/*
+ * PageRank of each vertex (by id, as in getVertexSet), by power iteration until the ranks
+ * change less than tolerance (see graph/PageRank.h, which also has a float version).
+ */
+template<class T, class W>
+std::vector<double> Graph<T, W>::pageRank(double damping, double tolerance) const {
+    cal::PageRankOptions options;
+    options.damping = damping;
+    options.tolerance = tolerance;
+    return cal::PageRank(*this).run(options).rank;
+}
+
+/*
+ * PageRank of the walks that restart at seed, for the vertices near it (highest first).
+ * Returns an empty vector if there is no vertex with the content seed.
+ */
+template<class T, class W>
+std::vector<std::pair<T, double>> Graph<T, W>::personalizedPageRank(const T &seed, double damping,
+                                                                    double epsilon) const {
+    std::vector<std::pair<T, double>> res;
+    int s = this->findVertexId(seed);
+    if (s < 0)
+        return res;
+    for (const auto &p : cal::personalizedPageRank(*this, s, damping, epsilon))
+        res.emplace_back(this->getInfo(p.first), p.second);
+    return res;
+}
+
+/*
+ * Triangles through each vertex (by id, as in getVertexSet) and local clustering coefficients,
+ * ignoring the direction of the edges (see graph/Triangles.h).
+ */
+template<class T, class W>
+cal::Triangles Graph<T, W>::triangles() const {
+    return cal::countTriangles(*this);
+}
+
+/****************** 5) DAG with a dynamic topological order ********************/
+
+/*
+ * Graph that stays acyclic: addEdge rejects the edges that would close a cycle, and keeps
+ * a topological order up to date as edges are added (see graph/DynamicTopologicalOrder.h),
+ * instead of checking the whole graph with isDAG or topsort after each edge.
+ * The graph is inherited privately: only the read-only accessors are public (and graph(),
+ * to pass it where a Graph is expected), so that every insertion goes through addArc.
+ */
+template<class T, class W = double>
+class DAG : private Graph<T, W> {
+    cal::DynamicTopologicalOrder order;
+
+    bool addArc(unsigned u, unsigned v, W w);
+
+public:
+    using Graph<T, W>::getNumVertex;
+    using Graph<T, W>::getVertexSet;
+    using Graph<T, W>::getVertex;
+    using Graph<T, W>::findVertex;
+    using Graph<T, W>::findVertexId;
+    using Graph<T, W>::getInfo;
+    using Graph<T, W>::memoryBytes;
+    using Graph<T, W>::dfs;
+    using Graph<T, W>::bfs;
+    using Graph<T, W>::isDAG;
+    using Graph<T, W>::reachabilityIndex;
+
+    const Graph<T, W> &graph() const { return *this; }
+
+    bool addVertex(const T &in);
+
+    bool addEdge(const T &sourc, const T &dest, W w);
+
+    bool removeEdge(const T &sourc, const T &dest);
+
+    bool removeVertex(const T &in);
+
+    std::vector<T> topsort() const;
+};
+
+template<class T, class W>
+bool DAG<T, W>::addVertex(const T &in) {
+    if (!Graph<T, W>::addVertex(in))
+        return false;
+    order.addVertex();
+    return true;
+}
+
+/*
+ * Adds the edge u -> v, unless it closes a cycle. Only the vertices between v and u in the
+ * topological order are visited (and possibly moved).
+ */
+template<class T, class W>
+bool DAG<T, W>::addArc(unsigned u, unsigned v, W w) {
+    if (!order.addEdge(u, v))
+        return false;
+    this->addEdgeById(u, v, w);
     return true;
 }
 
+/*
+ * Returns false if the source or destination vertex does not exist, or the edge closes a cycle.
+ */
+template<class T, class W>
+bool DAG<T, W>::addEdge(const T &sourc, const T &dest, W w) {
+    int u = this->findVertexId(sourc);
+    int v = this->findVertexId(dest);
+    return u >= 0 && v >= 0 && addArc(u, v, w);
+}
+
+template<class T, class W>
+bool DAG<T, W>::removeEdge(const T &sourc, const T &dest) {
+    int u = this->findVertexId(sourc);
+    int v = this->findVertexId(dest);
+    if (u < 0 || v < 0 || !Graph<T, W>::removeEdge(sourc, dest))
+        return false;
+    order.removeEdge(u, v);
+    return true;
+}
+
+template<class T, class W>
+bool DAG<T, W>::removeVertex(const T &in) {
+    int v = this->findVertexId(in);
+    if (v < 0)
+        return false;
+    Graph<T, W>::removeVertex(in);
+    order.removeVertex(v);
+    return true;
+}
+
+/*
+ * The contents of the vertices in the topological order kept by the graph.
+ */
+template<class T, class W>
+std::vector<T> DAG<T, W>::topsort() const {
+    return this->infos(order.getOrder());
+}
+
 #endif /* GRAPH_H_ */
@@ -0,0 +1,114 @@
+#include "Graph.h"
+
+#include <random>
+
+// Strongly connected components and condensation (graph/Components.h)
+
+/// TESTS ///
+#include <gtest/gtest.h>
+
+static Graph<int> createSccGraph() {
+    // Components {1, 2, 5}, {3, 4}, {0}, {6}
+    Graph<int> g;
+    for (int i = 0; i <= 6; i++)
+        g.addVertex(i);
+    g.addEdge(1, 2, 3);
+    g.addEdge(2, 5, 1);
+    g.addEdge(5, 1, 2);
+    g.addEdge(2, 3, 4);
+    g.addEdge(5, 4, 2);
+    g.addEdge(3, 4, 1);
+    g.addEdge(4, 3, 1);
+    g.addEdge(0, 1, 5);
+    g.addEdge(0, 6, 1);
+    g.addEdge(4, 6, 7);
+    return g;
+}
+
+/*
+ * True if both partitions have the same components (whatever their ids).
+ */
+static bool samePartition(const cal::Components &a, const cal::Components &b) {
+    if (a.count != b.count || a.component.size() != b.component.size())
+        return false;
+    std::vector<int> map(a.count, -1);
+    for (size_t v = 0; v < a.component.size(); v++) {
+        int &m = map[a.component[v]];
+        if (m == -1)
+            m = b.component[v];
+        else if (m != (int) b.component[v])
+            return false;
+    }
+    return true;
+}
+
+TEST(TP5_Ex4, test_stronglyConnectedComponents) {
+    Graph<int> g = createSccGraph();
+    std::vector<std::vector<int>> scc = g.stronglyConnectedComponents();
+    ASSERT_EQ(4u, scc.size());
+    // Topological order: {0} before {1, 2, 5} before {3, 4} before {6}
+    EXPECT_EQ(std::vector<int>({0}), scc[0]);
+    EXPECT_EQ(std::vector<int>({1, 2, 5}), scc[1]);
+    EXPECT_EQ(std::vector<int>({3, 4}), scc[2]);
+    EXPECT_EQ(std::vector<int>({6}), scc[3]);
+
+    Graph<int> dag;
+    dag.addVertex(1);
+    dag.addVertex(2);
+    dag.addEdge(1, 2, 0);
+    EXPECT_EQ(2u, dag.stronglyConnectedComponents().size());
+}
+
+TEST(TP5_Ex4, test_condensation) {
+    Graph<int> g = createSccGraph();
+    Graph<std::vector<int>> dag = g.condensation();
+    EXPECT_EQ(4, dag.getNumVertex());
+    EXPECT_TRUE(dag.isDAG());
+    auto c125 = dag.findVertex({1, 2, 5});
+    ASSERT_NE(nullptr, c125);
+    // Two edges from {1, 2, 5} to {3, 4}: one edge, with the minimum weight
+    ASSERT_EQ(1u, c125->getAdj().size());
+    EXPECT_EQ(std::vector<int>({3, 4}), c125->getAdj()[0]->getDest()->getInfo());
+    EXPECT_EQ(2, c125->getAdj()[0]->getWeight());
+    EXPECT_EQ(2u, dag.findVertex({0})->getAdj().size());
+    EXPECT_EQ(1u, dag.findVertex({3, 4})->getAdj().size());
+    EXPECT_EQ(0u, dag.findVertex({6})->getAdj().size());
+}
+
+TEST(TP5_Ex4, test_parallelScc) {
+    // Clusters of 100 vertices with random edges inside, and edges between clusters in
+    // both directions for some of them
+    cal::Graph<unsigned> g;
+    const unsigned n = 20000, cluster = 100;
+    for (unsigned v = 0; v < n; v++)
+        g.appendVertex(v);
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<unsigned> dis(0, cluster - 1);
+    for (unsigned v = 0; v < n; v++) {
+        unsigned base = v / cluster * cluster;
+        for (int i = 0; i < 2; i++)
+            g.addEdgeById(v, base + dis(gen), 1);
+        if (dis(gen) < 3)
+            g.addEdgeById(v, std::uniform_int_distribution<unsigned>(0, n - 1)(gen), 1);
+    }
+    cal::Components expected = cal::tarjanScc(g);
+    for (unsigned threads : {1, 4}) {
+        ThreadPool pool(threads);
+        EXPECT_TRUE(samePartition(expected, cal::parallelScc(g, pool)));
+    }
+
+    // Tarjan numbers the components in topological order
+    for (unsigned u = 0; u < n; u++)
+        for (auto e : g.out(u))
+            EXPECT_LE(expected.component[u], expected.component[g.target(e)]);
+
+    // Long cycle: one component, without deep recursion
+    cal::Graph<unsigned> cycle;
+    const unsigned length = 200000;
+    for (unsigned v = 0; v < length; v++)
+        cycle.appendVertex(v);
+    for (unsigned v = 0; v < length; v++)
+        cycle.addEdgeById(v, (v + 1) % length, 1);
+    EXPECT_EQ(1u, cal::tarjanScc(cycle).count);
+    EXPECT_EQ(1u, cal::parallelScc(cycle).count);
+}
@@ -0,0 +1,79 @@
+#include "Graph.h"
+
+#include <random>
+
+// DAG with a dynamic topological order (graph/DynamicTopologicalOrder.h)
+
+/// TESTS ///
+#include <gtest/gtest.h>
+
+/*
+ * True if every edge of g goes forward in order.
+ */
+template<class T>
+static bool isTopological(const Graph<T> &g, const std::vector<T> &order) {
+    if ((int) order.size() != g.getNumVertex())
+        return false;
+    std::vector<int> position(g.getNumVertex());
+    for (size_t i = 0; i < order.size(); i++)
+        position[g.findVertexId(order[i])] = i;
+    for (auto v : g.getVertexSet())
+        for (auto e : v->getAdj())
+            if (position[v->getId()] >= position[e->getDest()->getId()])
+                return false;
+    return true;
+}
+
+TEST(TP5_Ex5, test_dagAddEdge) {
+    DAG<int> dag;
+    for (int i = 1; i <= 6; i++)
+        EXPECT_TRUE(dag.addVertex(i));
+    EXPECT_FALSE(dag.addVertex(3));
+    EXPECT_TRUE(dag.addEdge(5, 3, 0));
+    EXPECT_TRUE(dag.addEdge(3, 1, 0));
+    EXPECT_TRUE(dag.addEdge(6, 5, 0));
+    EXPECT_TRUE(dag.addEdge(1, 2, 0));
+    EXPECT_TRUE(isTopological(dag.graph(), dag.topsort()));
+
+    // Cycles are rejected, and the graph does not change
+    EXPECT_FALSE(dag.addEdge(2, 6, 0));
+    EXPECT_FALSE(dag.addEdge(4, 4, 0));
+    EXPECT_FALSE(dag.addEdge(4, 7, 0));
+    EXPECT_TRUE(dag.isDAG());
+    EXPECT_EQ(0u, dag.findVertex(2)->getAdj().size());
+
+    EXPECT_TRUE(dag.removeEdge(1, 2));
+    EXPECT_TRUE(dag.addEdge(2, 6, 0));
+    EXPECT_TRUE(isTopological(dag.graph(), dag.topsort()));
+    EXPECT_TRUE(dag.removeVertex(5));
+    EXPECT_TRUE(dag.addEdge(1, 4, 0));
+    EXPECT_TRUE(dag.addEdge(6, 3, 0));
+    EXPECT_FALSE(dag.addEdge(1, 2, 0));  // 2 -> 6 -> 3 -> 1
+    EXPECT_TRUE(isTopological(dag.graph(), dag.topsort()));
+    EXPECT_EQ(5u, dag.topsort().size());
+}
+
+TEST(TP5_Ex5, test_dagRandomEdges) {
+    // Same edges accepted as adding each edge to a Graph and removing it if isDAG fails
+    const int n = 60;
+    DAG<int> dag;
+    Graph<int> g;
+    for (int i = 0; i < n; i++) {
+        dag.addVertex(i);
+        g.addVertex(i);
+    }
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> dis(0, n - 1);
+    int accepted = 0;
+    for (int i = 0; i < 600; i++) {
+        int u = dis(gen), v = dis(gen);
+        g.addEdge(u, v, 0);
+        bool acyclic = g.isDAG();
+        if (!acyclic)
+            g.removeEdge(u, v);
+        ASSERT_EQ(acyclic, dag.addEdge(u, v, 0));
+        accepted += acyclic;
+        ASSERT_TRUE(isTopological(dag.graph(), dag.topsort()));
+    }
+    EXPECT_GT(accepted, n);
+}
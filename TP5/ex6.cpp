@@ -0,0 +1,59 @@
+#include "Graph.h"
+
+#include <random>
+
+// Reachability index (graph/Reachability.h)
+
+/// TESTS ///
+#include <gtest/gtest.h>
+
+TEST(TP5_Ex6, test_reachabilityIndex) {
+    Graph<int> g;
+    for (int i = 1; i <= 6; i++)
+        g.addVertex(i);
+    g.addEdge(1, 2, 0);
+    g.addEdge(2, 3, 0);
+    g.addEdge(3, 2, 0);
+    g.addEdge(3, 4, 0);
+    g.addEdge(5, 4, 0);
+    for (auto mode : {cal::ReachabilityIndex::Mode::Closure, cal::ReachabilityIndex::Mode::Labels}) {
+        cal::ReachabilityIndex index = g.reachabilityIndex(mode);
+        EXPECT_EQ(mode, index.getMode());
+        EXPECT_EQ(5u, index.getNumComponents());
+        auto reaches = [&](int u, int v) { return index.reaches(g.findVertexId(u), g.findVertexId(v)); };
+        EXPECT_TRUE(reaches(1, 4));
+        EXPECT_TRUE(reaches(3, 2));
+        EXPECT_TRUE(reaches(6, 6));
+        EXPECT_FALSE(reaches(4, 1));
+        EXPECT_FALSE(reaches(1, 5));
+        EXPECT_FALSE(reaches(5, 6));
+    }
+    EXPECT_EQ(cal::ReachabilityIndex::Mode::Closure, g.reachabilityIndex().getMode());
+}
+
+TEST(TP5_Ex6, test_reachabilityRandomGraph) {
+    // Mostly forward edges (a DAG of small cycles), checked against a search from each vertex
+    cal::Graph<unsigned> g;
+    const unsigned n = 400;
+    for (unsigned v = 0; v < n; v++)
+        g.appendVertex(v);
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<unsigned> dis(0, n - 1);
+    for (unsigned i = 0; i < 2 * n; i++) {
+        unsigned u = dis(gen), v = dis(gen);
+        if (u < v || v + 3 > u)
+            g.addEdgeById(u, v, 1);
+    }
+    cal::ReachabilityIndex closure(g, cal::ReachabilityIndex::Mode::Closure);
+    cal::ReachabilityIndex labels(g, cal::ReachabilityIndex::Mode::Labels, 2, 11);
+    SearchContext ctx;
+    for (unsigned u = 0; u < n; u++) {
+        std::vector<bool> reached(n, false);
+        for (unsigned v : cal::bfsOrder(g, u, ctx))
+            reached[v] = true;
+        for (unsigned v = 0; v < n; v++) {
+            ASSERT_EQ(reached[v], closure.reaches(u, v)) << u << " -> " << v;
+            ASSERT_EQ(reached[v], labels.reaches(u, v)) << u << " -> " << v;
+        }
+    }
+}
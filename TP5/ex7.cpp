@@ -0,0 +1,99 @@
+#include "Graph.h"
+#include "Person.h"
+
+#include <random>
+
+// Betweenness centrality (graph/Centrality.h)
+
+/*
+ * Reference: sum over the pairs (s, t) of sigma(s, v) * sigma(v, t) / sigma(s, t), for the
+ * v in a shortest path from s to t, with the distances and path counts of a search from each vertex.
+ */
+static std::vector<double> bruteForceBetweenness(const cal::Graph<unsigned> &g) {
+    unsigned n = g.getNumVertex();
+    std::vector<std::vector<int>> dist(n, std::vector<int>(n, -1));
+    std::vector<std::vector<double>> paths(n, std::vector<double>(n, 0));
+    for (unsigned s = 0; s < n; s++) {
+        std::vector<unsigned> queue{s};
+        dist[s][s] = 0;
+        paths[s][s] = 1;
+        for (size_t head = 0; head < queue.size(); head++) {
+            unsigned u = queue[head];
+            for (const auto &e : g.out(u)) {
+                unsigned v = g.target(e);
+                if (dist[s][v] < 0) {
+                    dist[s][v] = dist[s][u] + 1;
+                    queue.push_back(v);
+                }
+                if (dist[s][v] == dist[s][u] + 1)
+                    paths[s][v] += paths[s][u];
+            }
+        }
+    }
+    std::vector<double> res(n, 0);
+    for (unsigned s = 0; s < n; s++)
+        for (unsigned t = 0; t < n; t++)
+            for (unsigned v = 0; v < n; v++)
+                if (v != s && v != t && s != t && dist[s][t] > 0 && dist[s][v] > 0 && dist[v][t] > 0
+                    && dist[s][v] + dist[v][t] == dist[s][t])
+                    res[v] += paths[s][v] * paths[v][t] / paths[s][t];
+    return res;
+}
+
+/// TESTS ///
+#include <gtest/gtest.h>
+
+TEST(TP5_Ex7, test_betweennessCentrality) {
+    Graph<Person> net1;
+    createNetwork(net1);
+    std::vector<double> c = net1.betweennessCentrality();
+    ASSERT_EQ(7u, c.size());
+    // Ana, Carlos, Filipe, Ines, Maria, Rui, Vasco
+    double expected[] = {10.5, 9, 5, 0, 11, 4.5, 0};
+    for (unsigned i = 0; i < 7; i++)
+        EXPECT_DOUBLE_EQ(expected[i], c[i]);
+
+    // Path 1 - 2 - 3 - 4, in both directions: each pair is counted twice
+    Graph<int> path;
+    for (int i = 1; i <= 4; i++)
+        path.addVertex(i);
+    for (int i = 1; i < 4; i++) {
+        path.addEdge(i, i + 1, 0);
+        path.addEdge(i + 1, i, 0);
+    }
+    std::vector<double> p = path.betweennessCentrality();
+    EXPECT_DOUBLE_EQ(0, p[0]);
+    EXPECT_DOUBLE_EQ(4, p[1]);
+    EXPECT_DOUBLE_EQ(4, p[2]);
+    EXPECT_DOUBLE_EQ(0, p[3]);
+}
+
+TEST(TP5_Ex7, test_betweennessRandomGraph) {
+    cal::Graph<unsigned> g;
+    const unsigned n = 60;
+    for (unsigned v = 0; v < n; v++)
+        g.appendVertex(v);
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<unsigned> vertex(0, n - 1);
+    for (unsigned i = 0; i < 3 * n; i++) {
+        unsigned u = vertex(gen), v = vertex(gen);
+        if (u != v)
+            g.addEdgeById(u, v, 1);
+    }
+    std::vector<double> expected = bruteForceBetweenness(g);
+    std::vector<double> exact = cal::betweenness(g);
+    for (unsigned v = 0; v < n; v++)
+        EXPECT_NEAR(expected[v], exact[v], 1e-9);
+
+    // Sampling every vertex is the exact computation; fewer pivots give an estimate of the same scale
+    std::vector<double> all = cal::betweenness(g, n, 3);
+    for (unsigned v = 0; v < n; v++)
+        EXPECT_NEAR(exact[v], all[v], 1e-9);
+    std::vector<double> sampled = cal::betweenness(g, n / 2, 3);
+    double sumExact = 0, sumSampled = 0;
+    for (unsigned v = 0; v < n; v++) {
+        sumExact += exact[v];
+        sumSampled += sampled[v];
+    }
+    EXPECT_NEAR(sumExact, sumSampled, 0.25 * sumExact);
+}
@@ -0,0 +1,112 @@
+#include "Graph.h"
+#include "Person.h"
+
+#include <random>
+
+// PageRank and personalized PageRank (graph/PageRank.h)
+
+static cal::Graph<unsigned> randomGraph(unsigned n, unsigned m, unsigned seed) {
+    cal::Graph<unsigned> g;
+    for (unsigned v = 0; v < n; v++)
+        g.appendVertex(v);
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<unsigned> vertex(0, n - 1);
+    for (unsigned i = 0; i < m; i++) {
+        unsigned u = vertex(gen), v = vertex(gen);
+        if (u != v)
+            g.addEdgeById(u, v, 1);
+    }
+    return g;
+}
+
+/*
+ * Reference: power iteration of the walk that restarts at seed (also from the vertices without out-edges).
+ */
+static std::vector<double> personalizedReference(const cal::Graph<unsigned> &g, unsigned seed, double damping) {
+    unsigned n = g.getNumVertex();
+    std::vector<double> rank(n, 0), next(n);
+    rank[seed] = 1;
+    for (int it = 0; it < 200; it++) {
+        std::fill(next.begin(), next.end(), 0);
+        next[seed] = 1 - damping;
+        for (unsigned u = 0; u < n; u++) {
+            if (g.out(u).empty()) {
+                next[seed] += damping * rank[u];
+                continue;
+            }
+            for (const auto &e : g.out(u))
+                next[g.target(e)] += damping * rank[u] / g.out(u).size();
+        }
+        rank.swap(next);
+    }
+    return rank;
+}
+
+/// TESTS ///
+#include <gtest/gtest.h>
+
+TEST(TP5_Ex8, test_pageRank) {
+    Graph<int> cycle;
+    for (int i = 1; i <= 3; i++)
+        cycle.addVertex(i);
+    cycle.addEdge(1, 2, 0);
+    cycle.addEdge(2, 3, 0);
+    cycle.addEdge(3, 1, 0);
+    for (double r : cycle.pageRank())
+        EXPECT_NEAR(1.0 / 3, r, 1e-6);
+
+    Graph<Person> net1;
+    createNetwork(net1);
+    std::vector<double> rank = net1.pageRank(0.85, 1e-10);
+    ASSERT_EQ(7u, rank.size());
+    double sum = 0;
+    for (double r : rank)
+        sum += r;
+    EXPECT_NEAR(1, sum, 1e-9);
+    // Ana points to Ines and Filipe to Vasco, and Ana is ranked higher than Filipe
+    EXPECT_GT(rank[0], rank[2]);
+    EXPECT_GT(rank[3], rank[6]);
+    EXPECT_GT(rank[0], rank[3]);
+}
+
+TEST(TP5_Ex8, test_pageRankFloatAndThreads) {
+    cal::Graph<unsigned> g = randomGraph(2000, 10000, 5);
+    cal::PageRank pr(g);
+    EXPECT_EQ(2000u, pr.getNumVertex());
+    cal::PageRankOptions options;
+    options.tolerance = 1e-9;
+    auto exact = pr.run(options);
+    EXPECT_LT(exact.residual, 1e-9);
+    EXPECT_GT(exact.iterations, 1u);
+
+    ThreadPool pool(3);
+    auto parallel = pr.run(options, pool);
+    EXPECT_EQ(exact.iterations, parallel.iterations);
+    options.tolerance = 1e-5;
+    auto single = pr.run<float>(options, pool);
+    for (unsigned v = 0; v < 2000; v++) {
+        EXPECT_NEAR(exact.rank[v], parallel.rank[v], 1e-12);
+        EXPECT_NEAR(exact.rank[v], single.rank[v], 1e-5);
+    }
+}
+
+TEST(TP5_Ex8, test_personalizedPageRank) {
+    cal::Graph<unsigned> g = randomGraph(300, 900, 9);
+    const double epsilon = 1e-8;
+    std::vector<double> expected = personalizedReference(g, 7, 0.85);
+    auto approx = cal::personalizedPageRank(g, 7, 0.85, epsilon);
+    ASSERT_FALSE(approx.empty());
+    EXPECT_EQ(7u, approx[0].first);
+    std::vector<double> found(300, 0);
+    for (const auto &p : approx)
+        found[p.first] = p.second;
+    for (unsigned v = 0; v < 300; v++)
+        EXPECT_NEAR(expected[v], found[v], 1e-5);
+
+    Graph<Person> net1;
+    createNetwork(net1);
+    auto ranked = net1.personalizedPageRank(Person("Filipe", 20));
+    ASSERT_FALSE(ranked.empty());
+    EXPECT_EQ("Filipe", ranked[0].first.getName());
+    EXPECT_TRUE(net1.personalizedPageRank(Person("Nobody", 1)).empty());
+}
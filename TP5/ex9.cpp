@@ -0,0 +1,105 @@
+#include "Graph.h"
+#include "Person.h"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+
+// Triangle counting and clustering coefficients (graph/Triangles.h)
+
+/// TESTS ///
+#include <gtest/gtest.h>
+
+TEST(TP5_Ex9, test_triangles) {
+    // K4 plus a pendant vertex 5, with edges in both directions and a repeated edge
+    Graph<int> g;
+    for (int i = 1; i <= 5; i++)
+        g.addVertex(i);
+    for (int i = 1; i <= 4; i++)
+        for (int j = i + 1; j <= 4; j++)
+            g.addEdge(i, j, 0);
+    g.addEdge(2, 1, 0);
+    g.addEdge(1, 2, 0);
+    g.addEdge(5, 4, 0);
+    cal::Triangles t = g.triangles();
+    EXPECT_EQ(4u, t.total);
+    uint64_t count[] = {3, 3, 3, 3, 0};
+    double clustering[] = {1, 1, 1, 0.5, 0};
+    for (unsigned i = 0; i < 5; i++) {
+        EXPECT_EQ(count[i], t.count[i]);
+        EXPECT_DOUBLE_EQ(clustering[i], t.clustering[i]);
+    }
+    EXPECT_DOUBLE_EQ(3.5 / 5, t.averageClustering());
+
+    // Ana-Carlos-Maria and Carlos-Maria-Rui
+    Graph<Person> net1;
+    createNetwork(net1);
+    cal::Triangles p = net1.triangles();
+    EXPECT_EQ(2u, p.total);
+}
+
+TEST(TP5_Ex9, test_trianglesRandomGraph) {
+    const unsigned n = 300;
+    cal::Graph<unsigned> g;
+    for (unsigned v = 0; v < n; v++)
+        g.appendVertex(v);
+    std::vector<std::vector<bool>> adjacent(n, std::vector<bool>(n, false));
+    std::mt19937 gen(13);
+    std::uniform_int_distribution<unsigned> vertex(0, n - 1);
+    for (unsigned i = 0; i < 4000; i++) {
+        unsigned u = vertex(gen), v = vertex(gen) % (u + 1);  // more edges among the first vertices
+        g.addEdgeById(u, v, 1);
+        if (u != v)
+            adjacent[u][v] = adjacent[v][u] = true;
+    }
+    std::vector<uint64_t> expected(n, 0);
+    uint64_t total = 0;
+    for (unsigned a = 0; a < n; a++)
+        for (unsigned b = a + 1; b < n; b++)
+            for (unsigned c = b + 1; c < n; c++)
+                if (adjacent[a][b] && adjacent[b][c] && adjacent[a][c]) {
+                    expected[a]++;
+                    expected[b]++;
+                    expected[c]++;
+                    total++;
+                }
+    ThreadPool pool(3);
+    cal::Triangles t = cal::countTriangles(g, pool);
+    EXPECT_EQ(total, t.total);
+    EXPECT_EQ(expected, t.count);
+    for (unsigned u = 0; u < n; u++) {
+        unsigned degree = 0;
+        for (unsigned v = 0; v < n; v++)
+            degree += adjacent[u][v];
+        EXPECT_DOUBLE_EQ(degree < 2 ? 0 : 2.0 * expected[u] / (degree * (degree - 1.0)), t.clustering[u]);
+    }
+}
+
+TEST(TP5_Ex9, test_intersectSorted) {
+    // Lists of similar and of very different lengths, with few and with many common elements
+    std::mt19937 gen(21);
+    for (unsigned range : {40u, 400u, 40000u})
+        for (unsigned i = 0; i < 200; i++) {
+            std::vector<unsigned> a, b;
+            std::uniform_real_distribution<double> coin;
+            double pa = coin(gen), pb = i % 4 == 0 ? pa / 50 : coin(gen);
+            for (unsigned x = 0; x < range; x++) {
+                if (coin(gen) < pa)
+                    a.push_back(x);
+                if (coin(gen) < pb)
+                    b.push_back(x);
+            }
+            std::vector<unsigned> expected, merged, found;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+            auto collect = [](std::vector<unsigned> &to) { return [&to](unsigned x) { to.push_back(x); }; };
+            cal::detail::mergeSorted(a.data(), a.size(), b.data(), b.size(), collect(merged));
+            cal::detail::intersectSorted(b.data(), b.size(), a.data(), a.size(), collect(found));
+            ASSERT_EQ(expected, merged);
+            ASSERT_EQ(expected, found);
+#ifdef __SSE2__
+            std::vector<unsigned> blocks;
+            cal::detail::mergeSortedSse2(a.data(), a.size(), b.data(), b.size(), collect(blocks));
+            ASSERT_EQ(expected, blocks);
+#endif
+        }
+}
@@ -1,134 +1,45 @@
 /*
  * Graph.h
+ * Fp06 interface over the common graph library (common/graph).
  */
 #ifndef GRAPH_H_
 #define GRAPH_H_
 
 #include <vector>
-#include <queue>
-#include <list>
 #include <limits>
-#include <cmath>
-#include "MutablePriorityQueue.h"
-#include <algorithm>
 #include <iostream>
-
-
-template<class T>
-class Edge;
-
-template<class T>
-class Graph;
-
-template<class T>
-class Vertex;
+#include "graph/Graph.h"
+#include "graph/KShortestPaths.h"
+#include "graph/ShortestPaths.h"
+#include "graph/Tsp.h"
 
 #define INF std::numeric_limits<double>::max()
 const double MAX_DIST = INF;
 
+// W: type of the edge weights (see graph/WeightTraits.h)
+template<class T, class W = double>
+using Vertex = cal::Vertex<T, cal::Weight<W>>;
 
-/************************* Vertex  **************************/
+template<class T, class W = double>
+using Edge = cal::Edge<T, cal::Weight<W>>;
 
-template<class T>
-class Vertex {
-    T info;                        // content of the vertex
-    std::vector<Edge<T> > adj;        // outgoing edges
+template<class T, class W = double>
+class Graph : public cal::Graph<T, cal::Weight<W>> {
+    using Base = cal::Graph<T, cal::Weight<W>>;
 
-    double dist = 0;
-    Vertex<T> *path = NULL;
-    int queueIndex = 0;        // required by MutablePriorityQueue
-
-    bool visited = false;        // auxiliary field
-    bool processing = false;    // auxiliary field
-
-    void addEdge(Vertex<T> *dest, double w);
+    cal::AllPairsShortestPaths<cal::DistOf<W>> allPairs;    // results of floydWarshallShortestPath
 
 public:
-    Vertex(T in);
-
-    T getInfo() const;
-
-    double getDist() const;
-
-    Vertex *getPath() const;
-
-    bool operator<(Vertex<T> &vertex) const; // // required by MutablePriorityQueue
-    friend class Graph<T>;
-
-    friend class MutablePriorityQueue<Vertex<T>>;
-};
-
-
-template<class T>
-Vertex<T>::Vertex(T in): info(in) {}
-
-/*
- * Auxiliary function to add an outgoing edge to a vertex (this),
- * with a given destination vertex (d) and edge weight (w).
- */
-template<class T>
-void Vertex<T>::addEdge(Vertex<T> *d, double w) {
-    adj.push_back(Edge<T>(d, w));
-}
-
-template<class T>
-bool Vertex<T>::operator<(Vertex<T> &vertex) const {
-    return this->dist < vertex.dist;
-}
-
-template<class T>
-T Vertex<T>::getInfo() const {
-    return this->info;
-}
-
-template<class T>
-double Vertex<T>::getDist() const {
-    return this->dist;
-}
-
-template<class T>
-Vertex<T> *Vertex<T>::getPath() const {
-    return this->path;
-}
-
-/********************** Edge  ****************************/
-
-template<class T>
-class Edge {
-    Vertex<T> *dest;      // destination vertex
-    double weight;         // edge weight
-public:
-    Edge(Vertex<T> *d, double w);
-
-    friend class Graph<T>;
-
-    friend class Vertex<T>;
-};
-
-template<class T>
-Edge<T>::Edge(Vertex<T> *d, double w): dest(d), weight(w) {}
-
-
-/*************************** Graph  **************************/
-
-template<class T>
-class Graph {
-    std::vector<Vertex<T> *> vertexSet;    // vertex set
-    double **adjacencyMatrix;
-    int **dp;
-
-public:
-    Vertex<T> *findVertex(const T &in) const;
+    // Search state of the functions that receive one (SearchContext for double weights)
+    using Context = cal::DistContext<W>;
 
     size_t findVertexIdx(T info) const;
 
     bool addVertex(const T &in);
 
-    bool addEdge(const T &sourc, const T &dest, double w);
-
-    int getNumVertex() const;
+    bool addEdge(const T &sourc, const T &dest, W w);
 
-    std::vector<Vertex<T> *> getVertexSet() const;
+    std::vector<Vertex<T, W> *> getVertexSet() const;
 
     // Fp06 - single source
     void unweightedShortestPath(const T &s);
@@ -139,44 +50,44 @@ public:
 
     std::vector<T> getPath(const T &origin, const T &dest) const;
 
+    // Fp06 - single source, thread-safe on a const graph (one context per thread)
+    void unweightedShortestPath(const T &s, Context &ctx) const;
+
+    void dijkstraShortestPath(const T &s, Context &ctx) const;
+
+    void bellmanFordShortestPath(const T &s, Context &ctx) const;
+
+    std::vector<T> getPath(const T &dest, const Context &ctx) const;
+
+    double getDist(const T &dest, const Context &ctx) const;
+
+    std::vector<T> dijkstraWithin(const T &origin, cal::DistOf<W> maxDist, Context &ctx = Context::local()) const;
+
     // Fp06 - all pairs
     void floydWarshallShortestPath();
 
     std::vector<T> getfloydWarshallPath(const T &origin, const T &dest) const;
 
-};
+    // Alternative routes
+    std::vector<std::vector<T>> getKShortestPaths(const T &origin, const T &dest, unsigned k) const;
 
-template<class T>
-int Graph<T>::getNumVertex() const {
-    return vertexSet.size();
-}
+    // Delivery tours
+    std::vector<T> getTour(const std::vector<T> &stops, unsigned restarts = 1) const;
 
-template<class T>
-std::vector<Vertex<T> *> Graph<T>::getVertexSet() const {
-    return vertexSet;
-}
+};
 
-/*
- * Auxiliary function to find a vertex with a given content.
- */
-template<class T>
-Vertex<T> *Graph<T>::findVertex(const T &in) const {
-    for (auto v : vertexSet)
-        if (v->info == in)
-            return v;
-    return NULL;
+template<class T, class W>
+std::vector<Vertex<T, W> *> Graph<T, W>::getVertexSet() const {
+    return this->vertexSet;
 }
 
 /*
  *  Adds a vertex with a given content or info (in) to a graph (this).
  *  Returns true if successful, and false if a vertex with that content already exists.
  */
-template<class T>
-bool Graph<T>::addVertex(const T &in) {
-    if (findVertex(in) != NULL)
-        return false;
-    vertexSet.push_back(new Vertex<T>(in));
-    return true;
+template<class T, class W>
+bool Graph<T, W>::addVertex(const T &in) {
+    return Base::addVertex(in) != nullptr;
 }
 
 /*
@@ -184,183 +95,194 @@ bool Graph<T>::addVertex(const T &in) {
  * destination vertices and the edge weight (w).
  * Returns true if successful, and false if the source or destination vertex does not exist.
  */
-template<class T>
-bool Graph<T>::addEdge(const T &sourc, const T &dest, double w) {
-    auto v1 = findVertex(sourc);
-    auto v2 = findVertex(dest);
-    if (v1 == NULL || v2 == NULL)
-        return false;
-    v1->addEdge(v2, w);
-    return true;
+template<class T, class W>
+bool Graph<T, W>::addEdge(const T &sourc, const T &dest, W w) {
+    return Base::addEdge(sourc, dest, w) != nullptr;
+}
+
+template<class T, class W>
+size_t Graph<T, W>::findVertexIdx(T info) const {
+    return this->findVertexId(info);
 }
 
 
 /**************** Single Source Shortest Path algorithms ************/
 
-template<class T>
-void Graph<T>::unweightedShortestPath(const T &orig) {
-    for (Vertex<T> *vertex : this->vertexSet) {
-        vertex->dist = MAX_DIST;
-        vertex->path = NULL;
-    }
-    std::queue<Vertex<T> *> vertexQueue;
-    this->findVertex(orig)->dist = 0;
-    vertexQueue.push(this->findVertex(orig));
-
-    while (!vertexQueue.empty()) {
-        Vertex<T> *v = vertexQueue.front();
-        vertexQueue.pop();
-        for (Edge<T> edge : v->adj) {
-            if (edge.dest->dist == MAX_DIST) {
-                edge.dest->dist = v->dist + 1;
-                edge.dest->path = v;
-                vertexQueue.push(edge.dest);
-            }
-        }
-    }
+/*
+ * The functions that receive a SearchContext leave their results (dist and path of
+ * each vertex) in it, and don't modify the graph, so they can run concurrently on the
+ * same graph (with one context per thread). The ones without it keep the old interface:
+ * they run on the context of the calling thread and copy the results to the vertices.
+ */
+
+template<class T, class W>
+void Graph<T, W>::unweightedShortestPath(const T &orig, Context &ctx) const {
+    int s = this->findVertexId(orig);
+    if (s < 0)
+        ctx.reset(this->getNumVertex());
+    else
+        cal::unweightedShortestPaths(*this, s, ctx);
 }
 
+template<class T, class W>
+void Graph<T, W>::unweightedShortestPath(const T &orig) {
+    Context &ctx = Context::local();
+    unweightedShortestPath(orig, ctx);
+    this->publish(ctx);
+}
 
-template<class T>
-void Graph<T>::dijkstraShortestPath(const T &origin) {
-    for (Vertex<T> *vertex : this->vertexSet) {
-        vertex->dist = MAX_DIST;
-        vertex->path = NULL;
-    }
-    Vertex<T> *source = findVertex(origin);
-    if (source == nullptr) return;
-    source->dist = 0;
-    MutablePriorityQueue<Vertex<T> > q;
-    q.insert(source);
-    while (!q.empty()) {
-        Vertex<T> *vertex = q.extractMin();
-        for (Edge<T> edge : vertex->adj) {
-            double oldDist = edge.dest->dist;
-            if (edge.dest->dist > vertex->dist + edge.weight) {
-                edge.dest->dist = vertex->dist + edge.weight;
-                edge.dest->path = vertex;
-                if (oldDist == MAX_DIST) {
-                    q.insert(edge.dest);
-                } else {
-                    q.decreaseKey(edge.dest);
-                }
-            }
-        }
-    }
+
+template<class T, class W>
+void Graph<T, W>::dijkstraShortestPath(const T &origin, Context &ctx) const {
+    int s = this->findVertexId(origin);
+    if (s < 0)
+        ctx.reset(this->getNumVertex());
+    else
+        cal::dijkstra(*this, s, ctx);
 }
 
+template<class T, class W>
+void Graph<T, W>::dijkstraShortestPath(const T &origin) {
+    Context &ctx = Context::local();
+    dijkstraShortestPath(origin, ctx);
+    this->publish(ctx);
+}
 
-template<class T>
-void Graph<T>::bellmanFordShortestPath(const T &orig) {
-    for (Vertex<T> *vertex : this->vertexSet) {
-        vertex->dist = MAX_DIST;
-        vertex->path = NULL;
-    }
-    Vertex<T> *source = findVertex(orig);
-    if (source == nullptr) return;
-    source->dist = 0;
-    for (int i = 1; i < this->vertexSet.size(); ++i) {
-        for (Vertex<T> *vertex : this->vertexSet) {
-            for (Edge<T> edge : vertex->adj) {
-                if (edge.dest->dist > vertex->dist + edge.weight) {
-                    edge.dest->dist = vertex->dist + edge.weight;
-                    edge.dest->path = vertex;
-                }
-            }
-        }
-    }
-    for (Vertex<T> *vertex : this->vertexSet) {
-        for (Edge<T> edge : vertex->adj) {
-            if (vertex->dist + edge.weight < edge.dest->dist) {
-                std::cerr << "there are cycles of negative weight\n";
-            }
-        }
-    }
+
+template<class T, class W>
+void Graph<T, W>::bellmanFordShortestPath(const T &orig, Context &ctx) const {
+    int s = this->findVertexId(orig);
+    if (s < 0)
+        ctx.reset(this->getNumVertex());
+    else if (!cal::bellmanFord(*this, s, ctx))
+        std::cerr << "there are cycles of negative weight\n";
 }
 
+template<class T, class W>
+void Graph<T, W>::bellmanFordShortestPath(const T &orig) {
+    Context &ctx = Context::local();
+    bellmanFordShortestPath(orig, ctx);
+    this->publish(ctx);
+}
 
-template<class T>
-std::vector<T> Graph<T>::getPath(const T &origin, const T &dest) const {
+
+template<class T, class W>
+std::vector<T> Graph<T, W>::getPath(const T &origin, const T &dest) const {
     std::vector<T> res;
-    Vertex<T> *v = this->findVertex(dest);
+    Vertex<T, W> *v = this->findVertex(dest);
 
-    if (v == nullptr || v->dist == INF) {
+    if (v == nullptr || v->getDist() == INF) {
         return res;
     }
-    res.push_back(v->info);
-    while (true) {
-        res.push_back(v->path->info);
-        if (v->path->info == origin) break;
-        v = v->path;
+    for (; v != nullptr; v = v->getPath()) {
+        res.insert(res.begin(), v->getInfo());
+        if (v->getInfo() == origin) break;
     }
-    std::reverse(res.begin(), res.end());
     return res;
 }
 
-/**************** All Pairs Shortest Path  ***************/
+/*
+ * Path from the origin of the last search done with ctx to dest (empty if unreachable).
+ */
+template<class T, class W>
+std::vector<T> Graph<T, W>::getPath(const T &dest, const Context &ctx) const {
+    std::vector<T> res;
+    int v = this->findVertexId(dest);
+    if (v < 0)
+        return res;
+    for (unsigned id : cal::pathTo(ctx, v))
+        res.push_back(this->getInfo(id));
+    return res;
+}
 
-template<class T>
-void Graph<T>::floydWarshallShortestPath() {
-    size_t n = vertexSet.size();
-    /*for (int i = 0; i < n; ++i) {
-        delete [] adjacencyMatrix[i];
-        delete [] dp[i];
-    }
-    delete [] adjacencyMatrix;
-    delete [] dp;*/
-    adjacencyMatrix = new double *[n];
-    dp = new int *[n];
-    for (size_t i = 0; i < n; ++i) {
-        adjacencyMatrix[i] = new double[n];
-        dp[i] = new int[n];
-        for (size_t j = 0; j < n; ++j) {
-            adjacencyMatrix[i][j] = i == j ? 0 : INF;
-            dp[i][j] = -1;
-        }
-        for (Edge<T> edge : this->vertexSet.at(i)->adj) {
-            size_t j = findVertexIdx(edge.dest->info);
-            adjacencyMatrix[i][j] = edge.weight;
-            dp[i][j] = i;
-        }
-    }
-    for (size_t k = 0; k < n; ++k) {
-        for (size_t i = 0; i < n; ++i) {
-            for (size_t j = 0; j < n; ++j) {
-                if (adjacencyMatrix[i][k] == INF || adjacencyMatrix[k][j] == INF) continue;
-                double newDist = adjacencyMatrix[i][k] + adjacencyMatrix[k][j];
-                if (newDist < adjacencyMatrix[i][j]) {
-                    adjacencyMatrix[i][j] = newDist;
-                    dp[i][j] = dp[k][j];
-                }
-            }
-        }
+/*
+ * Distance from the origin of the last search done with ctx to dest (INF if unreachable).
+ */
+template<class T, class W>
+double Graph<T, W>::getDist(const T &dest, const Context &ctx) const {
+    int v = this->findVertexId(dest);
+    return v < 0 ? INF : cal::WeightTraits<W>::toDouble(ctx.get(v).dist);
+}
+
+/*
+ * Contents of the vertices at distance at most maxDist from origin, by increasing distance
+ * (isochrone). Only those vertices are searched; their distances and paths are left in ctx.
+ */
+template<class T, class W>
+std::vector<T> Graph<T, W>::dijkstraWithin(const T &origin, cal::DistOf<W> maxDist, Context &ctx) const {
+    std::vector<T> res;
+    int s = this->findVertexId(origin);
+    if (s < 0) {
+        ctx.reset(this->getNumVertex());
+        return res;
     }
+    for (unsigned id : cal::dijkstraWithin(*this, s, maxDist, ctx))
+        res.push_back(this->getInfo(id));
+    return res;
+}
+
+/**************** All Pairs Shortest Path  ***************/
 
+template<class T, class W>
+void Graph<T, W>::floydWarshallShortestPath() {
+    allPairs = cal::floydWarshall(*this);
 }
 
-template<class T>
-std::vector<T> Graph<T>::getfloydWarshallPath(const T &orig, const T &dest) const {
+template<class T, class W>
+std::vector<T> Graph<T, W>::getfloydWarshallPath(const T &orig, const T &dest) const {
     std::vector<T> res;
-    int i = findVertexIdx(orig);
-    int j = findVertexIdx(dest);
-    if (i == -1 || j == -1 || adjacencyMatrix[i][j] == INF) { // missing or disconnected
+    int i = this->findVertexId(orig);
+    int j = this->findVertexId(dest);
+    if (i == -1 || j == -1 || (unsigned) std::max(i, j) >= allPairs.n) { // missing
         return res;
     }
-    for (; j != -1; j = dp[i][j]) {
-        res.push_back(vertexSet[j]->info);
+    for (unsigned id : allPairs.path(i, j)) {
+        res.push_back(this->getInfo(id));
     }
-    reverse(res.begin(), res.end());
     return res;
 }
 
-template<class T>
-size_t Graph<T>::findVertexIdx(T info) const {
-    for (size_t i = 0; i < this->vertexSet.size(); ++i) {
-        if (this->vertexSet.at(i)->info == info) {
-            return i;
-        }
+/**************** k shortest paths  ***************/
+
+/*
+ * Up to k shortest paths without repeated vertices from origin to dest, by increasing length
+ * (see graph/KShortestPaths.h). Empty if either vertex is missing or dest is unreachable.
+ */
+template<class T, class W>
+std::vector<std::vector<T>> Graph<T, W>::getKShortestPaths(const T &origin, const T &dest, unsigned k) const {
+    std::vector<std::vector<T>> res;
+    int s = this->findVertexId(origin);
+    int t = this->findVertexId(dest);
+    if (s == -1 || t == -1)
+        return res;
+    for (const auto &path : cal::KShortestPaths<Base>(*this).find(s, t, k)) {
+        res.emplace_back();
+        for (unsigned id : path.vertices)
+            res.back().push_back(this->getInfo(id));
+    }
+    return res;
+}
+
+/*
+ * Order in which to visit the stops, from the first one and back to it, to make the route
+ * (by shortest paths between them) short; empty if some stop does not exist.
+ */
+template<class T, class W>
+std::vector<T> Graph<T, W>::getTour(const std::vector<T> &stops, unsigned restarts) const {
+    std::vector<T> res;
+    std::vector<unsigned> ids;
+    for (const T &stop : stops) {
+        int id = this->findVertexId(stop);
+        if (id == -1)
+            return res;
+        ids.push_back(id);
     }
-    return -1;
+    const std::vector<double> costs = cal::distanceMatrix(*this, ids);
+    cal::TspOptions options;
+    options.restarts = restarts;
+    for (unsigned i : cal::TspSolver(costs).solve(options).order)
+        res.push_back(stops[i]);
+    return res;
 }
 
 
@@ -0,0 +1,338 @@
+/*
+ * VersionedGraph.h
+ * Graph with immutable, versioned snapshots: shortest path queries run on a snapshot
+ * while a writer publishes new versions (e.g. road closures).
+ */
+#ifndef VERSIONED_GRAPH_H_
+#define VERSIONED_GRAPH_H_
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "SearchContext.h"
+#include "Trace.h"
+#include "graph/ShortestPaths.h"
+
+template<class T>
+class VersionedGraph;
+
+/************************* GraphSnapshot  **************************/
+
+/**
+ * One version of a VersionedGraph. Never modified after being published, so any number
+ * of threads can query it (each with its own SearchContext).
+ *
+ * Vertices have dense ids (in order of insertion). The adjacency lists and the contents
+ * of the vertices are split in blocks of BLOCK_SIZE vertices, and the index from contents
+ * to ids in sorted blocks of up to 2 * BLOCK_SIZE entries; a new version only copies the
+ * blocks it changes: the others are shared with the previous version.
+ */
+template<class T>
+class GraphSnapshot {
+public:
+    static const unsigned BLOCK_SIZE = 64;
+    using WeightType = double;
+
+    struct Arc {
+        unsigned dest;
+        double weight;
+    };
+
+    unsigned getVersion() const;
+
+    int getNumVertex() const;
+
+    int findVertexId(const T &in) const;
+
+    const T &getInfo(unsigned id) const;
+
+    const std::vector<Arc> &getAdj(unsigned id) const;
+
+    bool sharesAdj(const GraphSnapshot<T> &other, unsigned id) const;
+
+    bool sharesInfo(const GraphSnapshot<T> &other, unsigned id) const;
+
+    // View used by the algorithms of the graph library (see graph/Graph.h)
+    const std::vector<Arc> &out(unsigned id) const { return getAdj(id); }
+
+    unsigned target(const Arc &arc) const { return arc.dest; }
+
+    double weight(const Arc &arc) const { return arc.weight; }
+
+    void dijkstraShortestPath(const T &s, SearchContext &ctx) const;
+
+    std::vector<T> getPath(const T &dest, const SearchContext &ctx) const;
+
+    double getDist(const T &dest, const SearchContext &ctx) const;
+
+private:
+    using Block = std::vector<std::vector<Arc>>;
+    using InfoBlock = std::vector<T>;
+    using IdBlock = std::vector<std::pair<T, unsigned>>;  // sorted by info
+
+    unsigned version = 0;
+    unsigned numVertex = 0;
+    std::vector<std::shared_ptr<const InfoBlock>> infoBlocks;  // by id
+    std::vector<std::shared_ptr<const IdBlock>> idBlocks;      // id of each info, in order of info
+    std::vector<std::shared_ptr<const Block>> blocks;
+
+    /*
+     * Index of the block of idBlocks where in is, or would be inserted (0 if there are none).
+     */
+    size_t idBlockOf(const T &in) const;
+
+    friend class VersionedGraph<T>;
+};
+
+template<class T>
+unsigned GraphSnapshot<T>::getVersion() const {
+    return version;
+}
+
+template<class T>
+int GraphSnapshot<T>::getNumVertex() const {
+    return numVertex;
+}
+
+template<class T>
+size_t GraphSnapshot<T>::idBlockOf(const T &in) const {
+    // Last block whose first info is not after in
+    auto it = std::upper_bound(idBlocks.begin(), idBlocks.end(), in,
+                               [](const T &x, const std::shared_ptr<const IdBlock> &b) { return x < b->front().first; });
+    return it == idBlocks.begin() ? 0 : it - idBlocks.begin() - 1;
+}
+
+/*
+ * Id of the vertex with a given content, or -1 if there is none.
+ */
+template<class T>
+int GraphSnapshot<T>::findVertexId(const T &in) const {
+    if (idBlocks.empty())
+        return -1;
+    const IdBlock &b = *idBlocks[idBlockOf(in)];
+    auto it = std::lower_bound(b.begin(), b.end(), in,
+                               [](const std::pair<T, unsigned> &e, const T &x) { return e.first < x; });
+    return it == b.end() || in < it->first ? -1 : (int) it->second;
+}
+
+template<class T>
+const T &GraphSnapshot<T>::getInfo(unsigned id) const {
+    return (*infoBlocks[id / BLOCK_SIZE])[id % BLOCK_SIZE];
+}
+
+template<class T>
+const std::vector<typename GraphSnapshot<T>::Arc> &GraphSnapshot<T>::getAdj(unsigned id) const {
+    return (*blocks[id / BLOCK_SIZE])[id % BLOCK_SIZE];
+}
+
+/*
+ * True if the outgoing edges of a vertex are stored in the same memory in both snapshots.
+ */
+template<class T>
+bool GraphSnapshot<T>::sharesAdj(const GraphSnapshot<T> &other, unsigned id) const {
+    unsigned b = id / BLOCK_SIZE;
+    return b < blocks.size() && b < other.blocks.size() && blocks[b] == other.blocks[b];
+}
+
+/*
+ * True if the content of a vertex, and its entry in the index of contents, are stored in the
+ * same memory in both snapshots.
+ */
+template<class T>
+bool GraphSnapshot<T>::sharesInfo(const GraphSnapshot<T> &other, unsigned id) const {
+    unsigned b = id / BLOCK_SIZE;
+    if (b >= infoBlocks.size() || b >= other.infoBlocks.size() || infoBlocks[b] != other.infoBlocks[b])
+        return false;
+    const T &in = getInfo(id);
+    return !other.idBlocks.empty() && idBlocks[idBlockOf(in)] == other.idBlocks[other.idBlockOf(in)];
+}
+
+/*
+ * Dijkstra algorithm, with the results left in ctx (see Graph::dijkstraShortestPath).
+ */
+template<class T>
+void GraphSnapshot<T>::dijkstraShortestPath(const T &origin, SearchContext &ctx) const {
+    TRACE_SCOPE("snapshot_dijkstra");
+    int source = findVertexId(origin);
+    if (source < 0)
+        ctx.reset(getNumVertex());
+    else
+        cal::dijkstra(*this, source, ctx);
+}
+
+template<class T>
+std::vector<T> GraphSnapshot<T>::getPath(const T &dest, const SearchContext &ctx) const {
+    std::vector<T> res;
+    int v = findVertexId(dest);
+    if (v < 0 || ctx.get(v).dist == SearchContext::INFINITE_DIST)
+        return res;
+    for (int id = v; id != SearchContext::NONE; id = ctx.get(id).path)
+        res.push_back(getInfo(id));
+    std::reverse(res.begin(), res.end());
+    return res;
+}
+
+template<class T>
+double GraphSnapshot<T>::getDist(const T &dest, const SearchContext &ctx) const {
+    int v = findVertexId(dest);
+    return v < 0 ? SearchContext::INFINITE_DIST : ctx.get(v).dist;
+}
+
+/************************* VersionedGraph  **************************/
+
+/**
+ * Usage:
+ *   VersionedGraph<int> g;
+ *   VersionedGraph<int>::Delta d;
+ *   d.addVertex(1); d.addVertex(2); d.addEdge(1, 2, 5);
+ *   g.commit(d);
+ *   auto snapshot = g.snapshot();   // readers: pins the current version
+ *   snapshot->dijkstraShortestPath(1, ctx);
+ *
+ * Writers are serialized, and publish each version with an atomic pointer swap.
+ * A reader keeps the version it pinned for as long as it holds the pointer, and
+ * a version (with the blocks only it uses) is freed when its last reader drops it.
+ */
+template<class T>
+class VersionedGraph {
+public:
+    using Snapshot = GraphSnapshot<T>;
+
+    /**
+     * Changes to apply in one commit, in order.
+     */
+    class Delta {
+        enum Kind { ADD_VERTEX, ADD_EDGE, REMOVE_EDGE };
+        struct Op {
+            Kind kind;
+            T source, dest;
+            double weight;
+        };
+        std::vector<Op> ops;
+
+        friend class VersionedGraph<T>;
+
+    public:
+        void addVertex(const T &in) { ops.push_back({ADD_VERTEX, in, in, 0}); }
+
+        void addEdge(const T &source, const T &dest, double w) { ops.push_back({ADD_EDGE, source, dest, w}); }
+
+        /*
+         * Removes the edge from source to dest (the first one, if there are several).
+         */
+        void removeEdge(const T &source, const T &dest) { ops.push_back({REMOVE_EDGE, source, dest, 0}); }
+
+        bool empty() const { return ops.empty(); }
+    };
+
+    VersionedGraph();
+
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+    unsigned commit(const Delta &delta);
+
+private:
+    std::shared_ptr<const Snapshot> current;
+    std::mutex writerMutex;
+};
+
+template<class T>
+VersionedGraph<T>::VersionedGraph() {
+    current = std::make_shared<Snapshot>();
+}
+
+/*
+ * Current version (never waits for a commit in progress). The version stays alive
+ * for as long as the caller keeps the pointer.
+ */
+template<class T>
+std::shared_ptr<const GraphSnapshot<T>> VersionedGraph<T>::snapshot() const {
+    return std::atomic_load(&current);
+}
+
+/*
+ * Applies the changes to a copy of the current version and publishes it.
+ * Operations that refer to missing vertices (or edges) and vertices that already
+ * exist are ignored, as in Graph.
+ * Returns the new version number.
+ */
+template<class T>
+unsigned VersionedGraph<T>::commit(const Delta &delta) {
+    TRACE_SCOPE("versioned_graph_commit");
+    std::lock_guard<std::mutex> lock(writerMutex);
+    std::shared_ptr<const Snapshot> old = std::atomic_load(&current);
+    auto next = std::make_shared<Snapshot>(*old);  // shares every block
+    next->version = old->version + 1;
+
+    using Block = typename Snapshot::Block;
+    using InfoBlock = typename Snapshot::InfoBlock;
+    using IdBlock = typename Snapshot::IdBlock;
+    // Blocks already copied in this commit (parallel to those of next)
+    std::vector<std::shared_ptr<Block>> copies(old->blocks.size());
+    std::vector<std::shared_ptr<InfoBlock>> infoCopies(old->infoBlocks.size());
+    std::vector<std::shared_ptr<IdBlock>> idCopies(old->idBlocks.size());
+    // Writable block, copied on its first change
+    auto writable = [](auto &blocks, auto &copies, size_t b) -> auto & {
+        using B = typename std::remove_reference<decltype(copies)>::type::value_type::element_type;
+        if (copies[b] == nullptr) {
+            copies[b] = std::make_shared<B>(*blocks[b]);
+            blocks[b] = copies[b];
+        }
+        return *copies[b];
+    };
+    auto writableBlock = [&](unsigned b) -> Block & { return writable(next->blocks, copies, b); };
+
+    for (const auto &op : delta.ops) {
+        if (op.kind == Delta::ADD_VERTEX) {
+            if (next->findVertexId(op.source) >= 0) continue;
+            unsigned id = next->numVertex++;
+            if (id % Snapshot::BLOCK_SIZE == 0) {
+                copies.push_back(std::make_shared<Block>());
+                next->blocks.push_back(copies.back());
+                infoCopies.push_back(std::make_shared<InfoBlock>());
+                next->infoBlocks.push_back(infoCopies.back());
+            }
+            writableBlock(id / Snapshot::BLOCK_SIZE).emplace_back();
+            writable(next->infoBlocks, infoCopies, id / Snapshot::BLOCK_SIZE).push_back(op.source);
+            // Index: sorted insertion in its block, split in two halves when it gets too large
+            if (next->idBlocks.empty()) {
+                idCopies.push_back(std::make_shared<IdBlock>(1, std::make_pair(op.source, id)));
+                next->idBlocks.push_back(idCopies.back());
+                continue;
+            }
+            size_t b = next->idBlockOf(op.source);
+            IdBlock &ids = writable(next->idBlocks, idCopies, b);
+            auto it = std::lower_bound(ids.begin(), ids.end(), op.source,
+                                       [](const std::pair<T, unsigned> &e, const T &x) { return e.first < x; });
+            ids.insert(it, {op.source, id});
+            if (ids.size() > 2 * Snapshot::BLOCK_SIZE) {
+                auto half = std::make_shared<IdBlock>(ids.begin() + Snapshot::BLOCK_SIZE, ids.end());
+                ids.resize(Snapshot::BLOCK_SIZE);
+                idCopies.insert(idCopies.begin() + b + 1, half);
+                next->idBlocks.insert(next->idBlocks.begin() + b + 1, half);
+            }
+            continue;
+        }
+        int s = next->findVertexId(op.source);
+        int d = next->findVertexId(op.dest);
+        if (s < 0 || d < 0) continue;
+        auto &adj = writableBlock(s / Snapshot::BLOCK_SIZE)[s % Snapshot::BLOCK_SIZE];
+        if (op.kind == Delta::ADD_EDGE) {
+            adj.push_back({(unsigned) d, op.weight});
+        } else {
+            auto it = std::find_if(adj.begin(), adj.end(), [d](const typename Snapshot::Arc &arc) {
+                return arc.dest == (unsigned) d;
+            });
+            if (it != adj.end())
+                adj.erase(it);
+        }
+    }
+
+    std::atomic_store(&current, std::shared_ptr<const Snapshot>(next));
+    return next->version;
+}
+
+#endif /* VERSIONED_GRAPH_H_ */
@@ -0,0 +1,60 @@
+#include "Graph.h"
+#include "TestAux.h"
+
+#include <thread>
+
+// Shortest path queries with a SearchContext, on a graph shared by several threads
+
+/// TESTS ///
+
+TEST(TP6_Concurrent, test_contextQueries) {
+    const Graph<int> myGraph = CreateTestGraph();
+    SearchContext ctx;
+
+    myGraph.dijkstraShortestPath(1, ctx);
+    checkSinglePath(myGraph.getPath(7, ctx), "1 2 4 5 7 ");
+    EXPECT_EQ(8, myGraph.getDist(7, ctx));
+
+    // The same context is reset by the next query
+    myGraph.unweightedShortestPath(5, ctx);
+    checkSinglePath(myGraph.getPath(6, ctx), "5 7 6 ");
+    EXPECT_EQ(2, myGraph.getDist(6, ctx));
+
+    myGraph.bellmanFordShortestPath(7, ctx);
+    checkSinglePath(myGraph.getPath(1, ctx), "7 6 4 3 1 ");
+    checkSinglePath(myGraph.getPath(7, ctx), "7 ");
+}
+
+TEST(TP6_Concurrent, test_concurrentDijkstra) {
+    Graph<std::pair<int, int>> g;
+    const int n = 20;
+    generateRandomGridGraph(n, g);
+
+    // Expected distances, computed sequentially
+    std::vector<std::vector<double>> expected(n, std::vector<double>(n * n));
+    for (int s = 0; s < n; s++) {
+        g.dijkstraShortestPath(std::make_pair(s, s));
+        for (int v = 0; v < n * n; v++)
+            expected[s][v] = g.findVertex(std::make_pair(v / n, v % n))->getDist();
+    }
+
+    const Graph<std::pair<int, int>> &cg = g;
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            SearchContext ctx;
+            for (int round = 0; round < 5; round++)
+                for (int s = t; s < n; s += 2) {
+                    cg.dijkstraShortestPath(std::make_pair(s, s), ctx);
+                    for (int v = 0; v < n * n; v++)
+                        if (cg.getDist(std::make_pair(v / n, v % n), ctx) != expected[s][v])
+                            mismatches[t]++;
+                }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    for (int t = 0; t < 4; t++)
+        EXPECT_EQ(0, mismatches[t]);
+}
@@ -0,0 +1,82 @@
+#include "Graph.h"
+#include "TestAux.h"
+
+#include <set>
+
+// k shortest paths (graph/KShortestPaths.h)
+
+/*
+ * Lengths of all the simple paths from u to t, by depth-first search.
+ */
+static void allPathLengths(const cal::Graph<int, cal::Weight<int>> &g, unsigned u, unsigned t, long length,
+                           std::vector<bool> &onPath, std::vector<long> &lengths) {
+    if (u == t) {
+        lengths.push_back(length);
+        return;
+    }
+    onPath[u] = true;
+    for (const auto &e : g.out(u))
+        if (!onPath[g.target(e)])
+            allPathLengths(g, g.target(e), t, length + g.weight(e), onPath, lengths);
+    onPath[u] = false;
+}
+
+/// TESTS ///
+
+TEST(TP6_Ex5, test_kShortestPaths) {
+    Graph<int> myGraph = CreateTestGraph();
+    std::vector<std::vector<int>> paths = myGraph.getKShortestPaths(1, 7, 10);
+    ASSERT_EQ(5u, paths.size());
+    checkSinglePath(paths[0], "1 2 4 5 7 ");
+    std::set<std::vector<int>> second{paths[1], paths[2]};
+    EXPECT_EQ((std::set<std::vector<int>>{{1, 2, 5, 7}, {1, 2, 4, 7}}), second);
+    checkSinglePath(paths[3], "1 4 5 7 ");
+    checkSinglePath(paths[4], "1 4 7 ");
+    EXPECT_EQ(2u, myGraph.getKShortestPaths(1, 7, 2).size());
+    EXPECT_TRUE(myGraph.getKShortestPaths(1, 8, 3).empty());
+}
+
+TEST(TP6_Ex5, test_kShortestPathsRandomGraph) {
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int> weight(1, 20);
+    for (int round = 0; round < 10; round++) {
+        const unsigned n = 10;
+        cal::Graph<int, cal::Weight<int>> g;
+        for (unsigned v = 0; v < n; v++)
+            g.appendVertex(v);
+        std::set<std::pair<unsigned, unsigned>> edges;  // no parallel edges: paths are vertex sequences
+        for (unsigned i = 0; i < 30; i++) {
+            unsigned u = gen() % n, v = gen() % n;
+            if (u != v && edges.insert({u, v}).second)
+                g.addEdgeById(u, v, weight(gen));
+        }
+        std::vector<long> expected;
+        std::vector<bool> onPath(n, false);
+        allPathLengths(g, 0, n - 1, 0, onPath, expected);
+        std::sort(expected.begin(), expected.end());
+        cal::KShortestPaths<cal::Graph<int, cal::Weight<int>>> k(g);
+        for (bool reuseTree : {true, false}) {
+            auto paths = k.find(0, n - 1, 15, reuseTree);
+            ASSERT_EQ(std::min<size_t>(15, expected.size()), paths.size());
+            for (size_t i = 0; i < paths.size(); i++) {
+                EXPECT_EQ(expected[i], paths[i].length);
+                // A simple path of g with that length
+                std::vector<unsigned> vertices = paths[i].vertices;
+                EXPECT_EQ(0u, vertices.front());
+                EXPECT_EQ(n - 1, vertices.back());
+                long length = 0;
+                for (size_t j = 0; j + 1 < vertices.size(); j++) {
+                    long best = -1;
+                    for (const auto &e : g.out(vertices[j]))
+                        if (g.target(e) == vertices[j + 1] && (best < 0 || g.weight(e) < best))
+                            best = g.weight(e);
+                    ASSERT_GE(best, 0);
+                    length += best;
+                }
+                EXPECT_EQ(expected[i], length);
+                std::sort(vertices.begin(), vertices.end());
+                EXPECT_TRUE(std::unique(vertices.begin(), vertices.end()) == vertices.end());
+            }
+        }
+    }
+}
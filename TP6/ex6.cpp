@@ -0,0 +1,42 @@
+#include "Graph.h"
+#include "TestAux.h"
+
+// Isochrones: Dijkstra bounded by a distance (graph/ShortestPaths.h)
+
+/// TESTS ///
+
+TEST(TP6_Ex6, test_dijkstraWithin) {
+    Graph<int> myGraph = CreateTestGraph();
+    Graph<int>::Context ctx;
+    checkSinglePath(myGraph.dijkstraWithin(1, 5, ctx), "1 2 4 ");
+    EXPECT_EQ(5, myGraph.getDist(4, ctx));
+    EXPECT_EQ(INF, myGraph.getDist(5, ctx));
+    checkSinglePath(myGraph.getPath(4, ctx), "1 2 4 ");
+    checkSinglePath(myGraph.dijkstraWithin(1, 0, ctx), "1 ");
+    EXPECT_EQ(7u, myGraph.dijkstraWithin(1, 100, ctx).size());
+    EXPECT_TRUE(myGraph.dijkstraWithin(8, 100, ctx).empty());
+}
+
+TEST(TP6_Ex6, test_dijkstraWithinGrid) {
+    Graph<std::pair<int, int>> g;
+    generateRandomGridGraph(30, g);
+    Graph<std::pair<int, int>>::Context full, bounded;
+    const auto source = std::make_pair(12, 17);
+    g.dijkstraShortestPath(source, full);
+    for (double bound : {0.0, 10.0, 40.0, 100.0}) {
+        std::vector<std::pair<int, int>> ball = g.dijkstraWithin(source, bound, bounded);
+        size_t inside = 0;
+        for (auto v : g.getVertexSet()) {
+            double d = g.getDist(v->getInfo(), full);
+            if (d <= bound) {
+                inside++;
+                EXPECT_EQ(d, g.getDist(v->getInfo(), bounded));
+            } else {
+                EXPECT_EQ(INF, g.getDist(v->getInfo(), bounded));
+            }
+        }
+        EXPECT_EQ(inside, ball.size());
+        for (size_t i = 1; i < ball.size(); i++)
+            EXPECT_LE(g.getDist(ball[i - 1], bounded), g.getDist(ball[i], bounded));
+    }
+}
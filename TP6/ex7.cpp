@@ -0,0 +1,159 @@
+#include "Graph.h"
+#include "TestAux.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// Delivery tours: traveling salesman heuristics (graph/Tsp.h)
+
+/*
+ * Costs between n random points of the unit square (Euclidean distances), scaled by
+ * asymmetry in one direction (1 for symmetric costs).
+ */
+static std::vector<double> randomCosts(unsigned n, unsigned seed, double asymmetry = 1) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coordinate(0, 1);
+    std::vector<std::pair<double, double>> points(n);
+    for (auto &p : points)
+        p = {coordinate(gen), coordinate(gen)};
+    std::vector<double> costs(n * n);
+    for (unsigned i = 0; i < n; i++)
+        for (unsigned j = 0; j < n; j++)
+            costs[i * n + j] = std::hypot(points[i].first - points[j].first, points[i].second - points[j].second)
+                               * (i < j ? asymmetry : 1);
+    return costs;
+}
+
+static bool isTour(const std::vector<unsigned> &order, unsigned n) {
+    std::vector<unsigned> sorted(order);
+    std::sort(sorted.begin(), sorted.end());
+    for (unsigned i = 0; i < n; i++)
+        if (i >= sorted.size() || sorted[i] != i)
+            return false;
+    return sorted.size() == n && order[0] == 0;
+}
+
+static double optimalTourCost(const std::vector<double> &costs, unsigned n) {
+    std::vector<unsigned> order(n);
+    for (unsigned i = 0; i < n; i++)
+        order[i] = i;
+    double best = INF;
+    do {
+        double cost = 0;
+        for (unsigned k = 0; k < n; k++)
+            cost += costs[order[k] * n + order[(k + 1) % n]];
+        best = std::min(best, cost);
+    } while (std::next_permutation(order.begin() + 1, order.end()));
+    return best;
+}
+
+/// TESTS ///
+
+TEST(TP6_Ex7, test_tspCircle) {
+    // Points on a circle, numbered at random: the best tour goes around it
+    const unsigned n = 40;
+    std::vector<unsigned> angle(n);
+    for (unsigned i = 0; i < n; i++)
+        angle[i] = i;
+    std::shuffle(angle.begin() + 1, angle.end(), std::mt19937(3));
+    std::vector<double> costs(n * n);
+    for (unsigned i = 0; i < n; i++)
+        for (unsigned j = 0; j < n; j++)
+            costs[i * n + j] = 2 * std::sin(M_PI * std::abs((int) angle[i] - (int) angle[j]) / n);
+    const double perimeter = n * 2 * std::sin(M_PI / n);
+    cal::TspSolver solver(costs, 8);
+    for (auto construction : {cal::TspConstruction::NearestNeighbour, cal::TspConstruction::GreedyEdge}) {
+        cal::TspOptions options;
+        options.construction = construction;
+        cal::TspTour tour = solver.solve(options);
+        ASSERT_TRUE(isTour(tour.order, n));
+        EXPECT_NEAR(perimeter, tour.cost, 1e-9);
+        EXPECT_NEAR(solver.tourCost(tour.order), tour.cost, 1e-9);
+    }
+}
+
+TEST(TP6_Ex7, test_tspAgainstOptimum) {
+    const unsigned n = 9;
+    for (unsigned seed = 0; seed < 10; seed++)
+        for (double asymmetry : {1.0, 1.5}) {
+            std::vector<double> costs = randomCosts(n, seed, asymmetry);
+            cal::TspSolver solver(costs, 5);
+            double optimum = optimalTourCost(costs, n);
+            for (auto construction : {cal::TspConstruction::NearestNeighbour, cal::TspConstruction::GreedyEdge}) {
+                std::vector<unsigned> initial = solver.construct(construction);
+                ASSERT_TRUE(isTour(initial, n));
+                std::vector<unsigned> improved = initial;
+                solver.improve(improved);
+                std::rotate(improved.begin(), std::find(improved.begin(), improved.end(), 0u), improved.end());
+                ASSERT_TRUE(isTour(improved, n));
+                EXPECT_LE(solver.tourCost(improved), solver.tourCost(initial) + 1e-9);
+                cal::TspOptions options;
+                options.construction = construction;
+                options.restarts = 8;
+                cal::TspTour tour = solver.solve(options);
+                ASSERT_TRUE(isTour(tour.order, n));
+                EXPECT_GE(tour.cost, optimum - 1e-9);
+                EXPECT_LE(tour.cost, optimum * 1.1);
+            }
+        }
+}
+
+TEST(TP6_Ex7, test_tspMissingConnections) {
+    // Two groups of stops, only connected through the stops 0 and 4 (0 -> 4 and 4 -> 0)
+    const unsigned n = 8;
+    std::vector<double> costs(n * n, INFINITY);
+    for (unsigned i = 0; i < n; i++)
+        for (unsigned j = 0; j < n; j++)
+            if (i / 4 == j / 4)
+                costs[i * n + j] = i == j ? 0 : 1 + (i + j) % 3;
+    costs[0 * n + 4] = costs[4 * n + 0] = 10;
+    cal::TspSolver solver(costs, 3);
+    cal::TspTour tour = solver.solve();
+    ASSERT_TRUE(isTour(tour.order, n));
+    EXPECT_EQ(INFINITY, tour.cost);
+
+    // A few missing connections between random points are avoided
+    const unsigned m = 30;
+    std::vector<double> random = randomCosts(m, 4);
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<unsigned> stop(0, m - 1);
+    for (int i = 0; i < 20; i++) {
+        unsigned a = stop(gen), b = stop(gen);
+        if (a != b)
+            random[a * m + b] = random[b * m + a] = INFINITY;
+    }
+    cal::TspTour avoiding = cal::TspSolver(random).solve();
+    ASSERT_TRUE(isTour(avoiding.order, m));
+    EXPECT_LT(avoiding.cost, INFINITY);
+}
+
+TEST(TP6_Ex7, test_getTour) {
+    Graph<std::pair<int, int>> g;
+    generateRandomGridGraph(20, g);
+    std::vector<std::pair<int, int>> stops;
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> coordinate(0, 19);
+    while (stops.size() < 30) {
+        auto stop = std::make_pair(coordinate(gen), coordinate(gen));
+        if (std::find(stops.begin(), stops.end(), stop) == stops.end())
+            stops.push_back(stop);
+    }
+    std::vector<std::pair<int, int>> tour = g.getTour(stops, 4);
+    ASSERT_EQ(stops.size(), tour.size());
+    EXPECT_EQ(stops[0], tour[0]);
+    EXPECT_TRUE(std::is_permutation(stops.begin(), stops.end(), tour.begin()));
+
+    // The costs are the shortest path distances
+    std::vector<unsigned> ids;
+    for (const auto &stop : stops)
+        ids.push_back(g.findVertexIdx(stop));
+    std::vector<double> costs = cal::distanceMatrix(g, ids);
+    Graph<std::pair<int, int>>::Context ctx;
+    for (unsigned i = 0; i < stops.size(); i += 7) {
+        g.dijkstraShortestPath(stops[i], ctx);
+        for (unsigned j = 0; j < stops.size(); j++)
+            EXPECT_EQ(g.getDist(stops[j], ctx), costs[i * stops.size() + j]);
+    }
+    EXPECT_TRUE(g.getTour({stops[0], std::make_pair(-1, -1)}).empty());
+}
@@ -0,0 +1,121 @@
+#include "Graph.h"
+#include "TestAux.h"
+
+// Storage and ownership of the common graph library (graph/Graph.h) under the Fp06 interface
+
+/// TESTS ///
+
+TEST(TP6_GraphLibrary, test_csrShortestPaths) {
+    Graph<std::pair<int, int>> g;
+    const int n = 20;
+    generateRandomGridGraph(n, g);
+    const cal::Graph<std::pair<int, int>, cal::Weight<>, cal::Directed, cal::Csr> csr(g);
+    EXPECT_EQ(g.getNumVertex(), csr.getNumVertex());
+
+    SearchContext expected, ctx;
+    for (int s = 0; s < n * n; s += 37) {
+        cal::dijkstra(g, s, expected);
+        cal::dijkstra(csr, s, ctx);
+        for (int v = 0; v < n * n; v++) {
+            EXPECT_EQ(expected.get(v).dist, ctx.get(v).dist);
+            EXPECT_EQ(expected.get(v).path, ctx.get(v).path);
+        }
+    }
+}
+
+TEST(TP6_GraphLibrary, test_copyAndRemove) {
+    Graph<int> myGraph = CreateTestGraph();
+    Graph<int> copy = myGraph;
+
+    EXPECT_TRUE(copy.removeVertex(4));
+    EXPECT_FALSE(copy.removeEdge(3, 4));
+    EXPECT_TRUE(copy.removeEdge(3, 1));
+    EXPECT_EQ(6, copy.getNumVertex());
+    EXPECT_EQ(7, myGraph.getNumVertex());
+
+    // The original graph is not affected by the changes to the copy
+    myGraph.dijkstraShortestPath(3);
+    checkSinglePath(myGraph.getPath(3, 7), "3 1 2 4 5 7 ");
+    copy.dijkstraShortestPath(3);
+    checkSinglePath(copy.getPath(3, 6), "3 6 ");
+    EXPECT_EQ(INF, copy.findVertex(7)->getDist());
+}
+
+TEST(TP6_GraphLibrary, test_weightTypes) {
+    Graph<int> doubles = CreateTestGraph();
+    Graph<int, uint32_t> integers;
+    Graph<int, cal::Fixed<8>> fixed;
+    for (auto v : doubles.getVertexSet()) {
+        integers.addVertex(v->getInfo());
+        fixed.addVertex(v->getInfo());
+    }
+    for (auto v : doubles.getVertexSet())
+        for (auto e : v->getAdj()) {
+            integers.addEdge(v->getInfo(), e->getDest()->getInfo(), (uint32_t) e->getWeight());
+            fixed.addEdge(v->getInfo(), e->getDest()->getInfo(), e->getWeight() / 4);
+        }
+
+    // Exact integer and fixed point distances (a quarter of the weights: 1/4 is exact in Fixed<8>)
+    cal::DistContext<uint32_t> integerCtx;
+    cal::DistContext<cal::Fixed<8>> fixedCtx;
+    for (int s = 1; s <= 7; s++) {
+        doubles.dijkstraShortestPath(s);
+        integers.dijkstraShortestPath(s, integerCtx);
+        fixed.dijkstraShortestPath(s, fixedCtx);
+        for (int v = 1; v <= 7; v++) {
+            EXPECT_EQ(doubles.findVertex(v)->getDist(), integers.getDist(v, integerCtx));
+            EXPECT_EQ(doubles.findVertex(v)->getDist() / 4, fixed.getDist(v, fixedCtx));
+        }
+    }
+
+    // Path lengths saturate at infinity instead of overflowing
+    using Traits = cal::WeightTraits<uint32_t>;
+    EXPECT_EQ(Traits::infinity(), Traits::add(Traits::infinity() - 1, 2));
+    EXPECT_EQ(INF, Traits::toDouble(Traits::infinity()));
+}
+
+TEST(TP6_GraphLibrary, test_reorder) {
+    Graph<std::pair<int, int>> g;
+    const int n = 15;
+    generateRandomGridGraph(n, g);
+    std::vector<std::pair<double, double>> coordinates;
+    for (auto v : g.getVertexSet())
+        coordinates.emplace_back(v->getInfo().first, v->getInfo().second);
+    SearchContext expected, ctx;
+    const auto source = std::make_pair(n / 2, 3);
+    cal::dijkstra(g, g.findVertexId(source), expected);
+
+    for (auto strategy : {cal::VertexOrder::Bfs, cal::VertexOrder::ReverseCuthillMcKee, cal::VertexOrder::Hilbert}) {
+        Graph<std::pair<int, int>> copy = g;
+        std::vector<unsigned> order = copy.reorder(strategy, coordinates);
+        ASSERT_EQ((size_t) n * n, order.size());
+        EXPECT_TRUE(std::is_permutation(order.begin(), order.end(), cal::bfsOrdering(g).begin()));
+        cal::dijkstra(copy, copy.findVertexId(source), ctx);
+        for (int id = 0; id < n * n; id++) {
+            auto v = copy.getVertex(id);
+            EXPECT_EQ(id, v->getId());
+            EXPECT_EQ(g.getVertex(order[id])->getInfo(), v->getInfo());
+            EXPECT_EQ(g.getVertex(order[id])->getAdj().size(), v->getAdj().size());
+            EXPECT_EQ(expected.get(order[id]).dist, ctx.get(id).dist);
+        }
+    }
+    // Hilbert order needs the coordinates
+    EXPECT_TRUE(g.reorder(cal::VertexOrder::Hilbert).empty());
+
+    // Undirected edges keep their reverse edges
+    cal::Graph<int, cal::Weight<>, cal::Undirected> u;
+    for (int i = 0; i < 5; i++)
+        u.addVertex(i);
+    for (int i = 0; i < 5; i++)
+        u.addEdge(i, (i + 2) % 5, i);
+    u.reorder(cal::VertexOrder::ReverseCuthillMcKee);
+    for (auto v : u.getVertexSet()) {
+        ASSERT_EQ(2u, v->getAdj().size());
+        for (auto e : v->getAdj()) {
+            ASSERT_NE(nullptr, e->getReverse());
+            EXPECT_EQ(e, e->getReverse()->getReverse());
+            EXPECT_EQ(v, e->getReverse()->getDest());
+            EXPECT_EQ(e->getWeight(), e->getReverse()->getWeight());
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#include "VersionedGraph.h"
+#include "TestAux.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+// Snapshots of a VersionedGraph: isolation, shared blocks and queries during commits
+
+/// TESTS ///
+
+static VersionedGraph<int>::Delta testGraphDelta() {
+    VersionedGraph<int>::Delta d;
+    for (int i = 1; i <= 7; i++)
+        d.addVertex(i);
+    d.addEdge(1, 2, 2);
+    d.addEdge(1, 4, 7);
+    d.addEdge(2, 4, 3);
+    d.addEdge(2, 5, 5);
+    d.addEdge(3, 1, 2);
+    d.addEdge(3, 6, 5);
+    d.addEdge(4, 3, 1);
+    d.addEdge(4, 5, 1);
+    d.addEdge(4, 6, 6);
+    d.addEdge(4, 7, 4);
+    d.addEdge(5, 7, 2);
+    d.addEdge(6, 4, 3);
+    d.addEdge(7, 6, 4);
+    return d;
+}
+
+TEST(TP6_Versioned, test_snapshotIsolation) {
+    VersionedGraph<int> g;
+    EXPECT_EQ(1u, g.commit(testGraphDelta()));
+    auto v1 = g.snapshot();
+    SearchContext ctx;
+    v1->dijkstraShortestPath(1, ctx);
+    checkSinglePath(v1->getPath(7, ctx), "1 2 4 5 7 ");
+
+    // Closes 4->5: the new version takes 1 2 4 7, the pinned one is unchanged
+    VersionedGraph<int>::Delta closure;
+    closure.removeEdge(4, 5);
+    EXPECT_EQ(2u, g.commit(closure));
+    auto v2 = g.snapshot();
+    v2->dijkstraShortestPath(1, ctx);
+    checkSinglePath(v2->getPath(7, ctx), "1 2 4 7 ");
+    EXPECT_EQ(9, v2->getDist(7, ctx));
+    v1->dijkstraShortestPath(1, ctx);
+    checkSinglePath(v1->getPath(7, ctx), "1 2 4 5 7 ");
+    EXPECT_EQ(1u, v1->getVersion());
+    EXPECT_EQ(2u, v2->getVersion());
+}
+
+TEST(TP6_Versioned, test_sharedBlocks) {
+    VersionedGraph<int> g;
+    VersionedGraph<int>::Delta d;
+    const int n = 4 * GraphSnapshot<int>::BLOCK_SIZE;
+    for (int i = 0; i < n; i++)
+        d.addVertex(i);
+    for (int i = 0; i + 1 < n; i++)
+        d.addEdge(i, i + 1, 1);
+    g.commit(d);
+    auto before = g.snapshot();
+
+    VersionedGraph<int>::Delta change;
+    change.removeEdge(0, 1);
+    change.addEdge(0, 2, 1);
+    g.commit(change);
+    auto after = g.snapshot();
+
+    // Only the first block was copied
+    EXPECT_FALSE(after->sharesAdj(*before, 0));
+    for (int id = GraphSnapshot<int>::BLOCK_SIZE; id < n; id += GraphSnapshot<int>::BLOCK_SIZE)
+        EXPECT_TRUE(after->sharesAdj(*before, id));
+    EXPECT_EQ(1u, before->getAdj(0).size());
+    EXPECT_EQ(1u, before->getAdj(0)[0].dest);
+    EXPECT_EQ(2u, after->getAdj(0)[0].dest);
+}
+
+TEST(TP6_Versioned, test_sharedInfos) {
+    // Contents in shuffled order, so the index of contents has many blocks
+    const int n = 20 * GraphSnapshot<int>::BLOCK_SIZE;
+    std::vector<int> infos(n);
+    for (int i = 0; i < n; i++)
+        infos[i] = 3 * i;
+    std::shuffle(infos.begin(), infos.end(), std::mt19937(1));
+    VersionedGraph<int> g;
+    VersionedGraph<int>::Delta d;
+    for (int in : infos)
+        d.addVertex(in);
+    g.commit(d);
+    auto before = g.snapshot();
+
+    VersionedGraph<int>::Delta change;
+    change.addVertex(3 * n / 2 + 1);
+    change.addVertex(infos[0]);  // already there: ignored
+    g.commit(change);
+    auto after = g.snapshot();
+
+    ASSERT_EQ(n, before->getNumVertex());
+    ASSERT_EQ(n + 1, after->getNumVertex());
+    for (int id = 0; id < n; id++) {
+        EXPECT_EQ(infos[id], after->getInfo(id));
+        EXPECT_EQ(id, after->findVertexId(infos[id]));
+        EXPECT_EQ(id, before->findVertexId(infos[id]));
+    }
+    EXPECT_EQ(n, after->findVertexId(3 * n / 2 + 1));
+    EXPECT_EQ(-1, before->findVertexId(3 * n / 2 + 1));
+    EXPECT_EQ(-1, after->findVertexId(1));
+
+    // Only the last block of contents and one block of the index were copied
+    int copied = 0;
+    for (int id = 0; id < n; id++)
+        copied += !after->sharesInfo(*before, id);
+    EXPECT_GT(copied, 0);
+    EXPECT_LE(copied, 3 * (int) GraphSnapshot<int>::BLOCK_SIZE);
+}
+
+TEST(TP6_Versioned, test_queriesDuringCommits) {
+    // A path 0 -> 1 -> ... -> n-1 whose total length is n-1 in every version:
+    // each commit moves one unit of weight from one edge to the next one
+    const int n = 200;
+    VersionedGraph<int> g;
+    VersionedGraph<int>::Delta d;
+    for (int i = 0; i < n; i++)
+        d.addVertex(i);
+    for (int i = 0; i + 1 < n; i++)
+        d.addEdge(i, i + 1, 1);
+    g.commit(d);
+
+    std::atomic<bool> stop(false);
+    std::thread writer([&]() {
+        std::vector<double> w(n - 1, 1);
+        for (int c = 0; !stop; c++) {
+            int i = c % (n - 2);
+            VersionedGraph<int>::Delta change;
+            change.removeEdge(i, i + 1);
+            change.removeEdge(i + 1, i + 2);
+            change.addEdge(i, i + 1, w[i] - 0.5);
+            change.addEdge(i + 1, i + 2, w[i + 1] + 0.5);
+            w[i] -= 0.5;
+            w[i + 1] += 0.5;
+            g.commit(change);
+        }
+    });
+    int mismatches = 0;
+    SearchContext ctx;
+    for (int q = 0; q < 200; q++) {
+        auto snapshot = g.snapshot();
+        snapshot->dijkstraShortestPath(0, ctx);
+        if (snapshot->getDist(n - 1, ctx) != n - 1)
+            mismatches++;
+    }
+    stop = true;
+    writer.join();
+    EXPECT_EQ(0, mismatches);
+}
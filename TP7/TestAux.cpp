@@ -1,5 +1,6 @@
 #include "Graph.h"
 #include "TestAux.h"
+#include <queue>
 
 /**
  * Auxiliary functions to tests...
@@ -79,7 +80,7 @@ double spanningTreeCost(const std::vector<Vertex<int>*> &res){
     for(const Vertex<int> *v: res){
         const Vertex<int> *u = v->getPath();
         if(u == nullptr) continue;
-        for(const Edge<int> *e: u->adj){
+        for(const Edge<int> *e: u->getAdj()){
             if(e->getDest()->getInfo() == v->getInfo()){
                 ret += e->getWeight();
                 break;
@@ -23,20 +23,19 @@ TEST(TP7_Ex1, test_prim) {
     EXPECT_EQ(spanningTreeCost(res), 11);
 }
 
-TEST(TP7_Ex1, test_performance_prim) {
-    //TODO: Change these const parameters as needed
-    const int MIN_SIZE = 10;
-    const int MAX_SIZE = 100; //Try with 100
-    const int STEP_SIZE = 10;
-    const int N_REPETITIONS = 50;
-    for (int n = MIN_SIZE; n <= MAX_SIZE; n += STEP_SIZE) {
-        Graph< std::pair<int,int> > g;
-        generateRandomGridGraph(n, g);
-        auto start = std::chrono::high_resolution_clock::now();
-        for (int i = 1; i <= N_REPETITIONS; i++)
-            g.calculatePrim();
-        auto finish = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
-        std::cout << "Processing grid (Prim) " << n << " x " << n << " average time (milliseconds)=" << (elapsed / N_REPETITIONS) << std::endl;
-    }
+TEST(TP7_Ex1, test_primEmptyGraph) {
+    Graph<int> graph;
+    EXPECT_TRUE(graph.calculatePrim().empty());
+    EXPECT_TRUE(graph.calculateKruskal().empty());
+
+    // A root that is not a vertex: no tree, and no forest either
+    Graph<int> other = CreateTestGraph();
+    cal::DistContext<double> ctx;
+    unsigned n = other.getNumVertex();
+    cal::prim(other, n, ctx);
+    for (unsigned v = 0; v < n; v++)
+        EXPECT_FALSE(ctx[v].visited);
+    cal::kruskal(other, n, ctx);
+    for (unsigned v = 0; v < n; v++)
+        EXPECT_FALSE(ctx[v].visited);
 }
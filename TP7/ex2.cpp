@@ -22,20 +22,3 @@ TEST(TP7_Ex2, test_kruskal) {
     EXPECT_TRUE(isSpanningTree(res));
     EXPECT_EQ(spanningTreeCost(res), 11);
 }
-
-TEST(TP7_Ex2, test_performance_kruskal) {
-    const int MIN_SIZE = 10;
-    const int MAX_SIZE = 30; //Try with 100
-    const int STEP_SIZE = 10;
-    const int N_REPETITIONS = 50;
-    for (int n = MIN_SIZE; n <= MAX_SIZE; n += STEP_SIZE) {
-        Graph< std::pair<int,int> > g;
-        generateRandomGridGraph(n, g);
-        auto start = std::chrono::high_resolution_clock::now();
-        for (int i = 1; i <= N_REPETITIONS; i++)
-            g.calculateKruskal();
-        auto finish = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
-        std::cout << "Processing grid (Kruskal) " << n << " x " << n << " average time (milliseconds)=" << (elapsed / N_REPETITIONS) << std::endl;
-    }
-}
@@ -0,0 +1,73 @@
+#include "Graph.h"
+#include "TestAux.h"
+
+#include <random>
+
+// Connected components (graph/Components.h) and spanning forests
+
+/// TESTS ///
+
+static Graph<int> createForestGraph() {
+    // Components {1, 2, 3, 4}, {5, 6} and {7}
+    Graph<int> g;
+    for (int i = 1; i <= 7; i++)
+        g.addVertex(i);
+    g.addBidirectionalEdge(1, 2, 3);
+    g.addBidirectionalEdge(2, 3, 1);
+    g.addBidirectionalEdge(1, 3, 1);
+    g.addBidirectionalEdge(4, 3, 5);
+    g.addBidirectionalEdge(6, 5, 2);
+    return g;
+}
+
+TEST(TP7_Ex3, test_connectedComponents) {
+    Graph<int> g = createForestGraph();
+    std::vector<std::vector<int>> components = g.connectedComponents();
+    ASSERT_EQ(3u, components.size());
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), components[0]);
+    EXPECT_EQ(std::vector<int>({5, 6}), components[1]);
+    EXPECT_EQ(std::vector<int>({7}), components[2]);
+}
+
+TEST(TP7_Ex3, test_kruskalForest) {
+    Graph<int> g = createForestGraph();
+    std::vector<Vertex<int> *> res = g.calculateKruskal();
+    double cost = 0;
+    int roots = 0;
+    for (auto v : res) {
+        if (v->getPath() == nullptr)
+            roots++;
+        else
+            cost += v->getDist();
+    }
+    EXPECT_EQ(3, roots);
+    EXPECT_EQ(1 + 1 + 5 + 2, cost);
+    EXPECT_EQ(nullptr, g.findVertex(1)->getPath());
+    EXPECT_EQ(nullptr, g.findVertex(5)->getPath());
+    EXPECT_EQ(5, g.findVertex(6)->getPath()->getInfo());
+}
+
+TEST(TP7_Ex3, test_parallelConnectedComponents) {
+    // Random graphs around the connectivity threshold, so that there are many components
+    const unsigned n = 20000;
+    std::mt19937 gen(9);
+    std::uniform_int_distribution<unsigned> dis(0, n - 1);
+    cal::Graph<unsigned, cal::Weight<>, cal::Undirected> undirected;
+    cal::Graph<unsigned> directed;
+    for (unsigned v = 0; v < n; v++) {
+        undirected.appendVertex(v);
+        directed.appendVertex(v);
+    }
+    for (unsigned i = 0; i < n / 2 + n / 4; i++) {
+        undirected.addEdgeById(dis(gen), dis(gen), 1);
+        directed.addEdgeById(dis(gen), dis(gen), 1);
+    }
+    ThreadPool pool(4);
+    cal::Components expected = cal::connectedComponents(undirected);
+    EXPECT_GT(expected.count, 100u);
+    EXPECT_EQ(expected.component, cal::parallelConnectedComponents(undirected, pool).component);
+    EXPECT_EQ(expected.count, cal::parallelConnectedComponents(undirected, pool).count);
+    // Weakly connected components of a directed graph
+    expected = cal::connectedComponents(directed);
+    EXPECT_EQ(expected.component, cal::parallelConnectedComponents(directed, pool).component);
+}
@@ -0,0 +1,121 @@
+#include "Graph.h"
+#include "TestAux.h"
+#include "graph/RoadMap.h"
+#include "graph/SpatialIndex.h"
+
+#include <random>
+
+// Snapping coordinates to the vertices and edges of a map (graph/SpatialIndex.h)
+
+/// TESTS ///
+
+/*
+ * Random map of n vertices around (41.15, -8.61), about 5 km wide, with edges from each vertex
+ * to two of the next ten.
+ */
+static cal::Graph<unsigned> createRandomMap(unsigned n, std::vector<std::pair<double, double>> &coordinates,
+                                            std::mt19937 &gen) {
+    std::uniform_real_distribution<double> offset(-0.025, 0.025);
+    cal::Graph<unsigned> g;
+    coordinates.clear();
+    for (unsigned v = 0; v < n; v++) {
+        g.appendVertex(v);
+        coordinates.emplace_back(41.15 + offset(gen), -8.61 + offset(gen));
+    }
+    std::uniform_int_distribution<unsigned> next(1, 10);
+    for (unsigned u = 0; u < n; u++)
+        for (int i = 0; i < 2; i++) {
+            unsigned v = (u + next(gen)) % n;
+            g.addEdgeById(u, v, 1);
+        }
+    return g;
+}
+
+/*
+ * Distance in meters from p to the segment ab and the fraction of ab where it is closest, with
+ * the projection of the index around the latitude lat0 (the middle of the map).
+ */
+static double segmentDistance(const std::pair<double, double> &p, const std::pair<double, double> &a,
+                              const std::pair<double, double> &b, double lat0, double &fraction) {
+    const double scaleY = 6371000 * M_PI / 180, scaleX = scaleY * std::cos(lat0 * M_PI / 180);
+    double px = p.second * scaleX, py = p.first * scaleY;
+    double ax = a.second * scaleX, ay = a.first * scaleY, dx = b.second * scaleX - ax, dy = b.first * scaleY - ay;
+    double length2 = dx * dx + dy * dy;
+    fraction = length2 == 0 ? 0 : std::min(1.0, std::max(0.0, ((px - ax) * dx + (py - ay) * dy) / length2));
+    return std::hypot(ax + fraction * dx - px, ay + fraction * dy - py);
+}
+
+TEST(TP7_Ex4, test_nearestVertex) {
+    std::mt19937 gen(5);
+    std::vector<std::pair<double, double>> coordinates;
+    cal::Graph<unsigned> g = createRandomMap(2000, coordinates, gen);
+    cal::SpatialIndex index(g, coordinates);
+
+    // The vertices themselves, then random points, some of them outside the map
+    for (unsigned v = 0; v < 100; v++) {
+        double distance;
+        EXPECT_EQ((int) v, index.nearestVertex(coordinates[v].first, coordinates[v].second, &distance));
+        EXPECT_EQ(0, distance);
+    }
+    std::uniform_real_distribution<double> offset(-0.04, 0.04);
+    std::vector<std::pair<double, double>> points;
+    for (int i = 0; i < 1000; i++)
+        points.emplace_back(41.15 + offset(gen), -8.61 + offset(gen));
+    std::vector<int> snapped = index.nearestVertices(points);
+    ASSERT_EQ(points.size(), snapped.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        double best = 1e18;
+        for (const auto &c : coordinates)
+            best = std::min(best, cal::haversine(points[i].first, points[i].second, c.first, c.second));
+        ASSERT_GE(snapped[i], 0);
+        const auto &c = coordinates[snapped[i]];
+        EXPECT_NEAR(best, cal::haversine(points[i].first, points[i].second, c.first, c.second), 0.01 * best + 1e-6);
+    }
+}
+
+TEST(TP7_Ex4, test_nearestEdge) {
+    std::mt19937 gen(7);
+    std::vector<std::pair<double, double>> coordinates;
+    cal::Graph<unsigned> g = createRandomMap(1000, coordinates, gen);
+    cal::SpatialIndex index(g, coordinates);
+    double minLat = 90, maxLat = -90;
+    for (const auto &c : coordinates) {
+        minLat = std::min(minLat, c.first);
+        maxLat = std::max(maxLat, c.first);
+    }
+    const double lat0 = (minLat + maxLat) / 2;
+
+    std::uniform_real_distribution<double> offset(-0.04, 0.04);
+    std::vector<std::pair<double, double>> points;
+    for (int i = 0; i < 500; i++)
+        points.emplace_back(41.15 + offset(gen), -8.61 + offset(gen));
+    std::vector<cal::SpatialIndex::EdgeSnap> snapped = index.nearestEdges(points);
+    for (size_t i = 0; i < points.size(); i++) {
+        double best = 1e18, fraction;
+        for (unsigned u = 0; u < (unsigned) g.getNumVertex(); u++)
+            for (const auto &e : g.out(u))
+                best = std::min(best, segmentDistance(points[i], coordinates[u], coordinates[g.target(e)], lat0, fraction));
+        const cal::SpatialIndex::EdgeSnap &s = snapped[i];
+        ASSERT_GE(s.from, 0);
+        EXPECT_NEAR(best, s.distance, 1e-6);
+        EXPECT_NEAR(s.distance, segmentDistance(points[i], coordinates[s.from], coordinates[s.to], lat0, fraction), 1e-6);
+        EXPECT_NEAR(s.fraction, fraction, 1e-9);
+        // The projected point is on the edge, at the given distance from the query
+        EXPECT_NEAR(s.distance, cal::haversine(points[i].first, points[i].second, s.lat, s.lon), 0.01 * s.distance + 0.01);
+    }
+}
+
+TEST(TP7_Ex4, test_emptyAndSinglePoint) {
+    std::vector<std::pair<double, double>> coordinates;
+    cal::Graph<unsigned> empty;
+    cal::SpatialIndex none(empty, coordinates);
+    EXPECT_EQ(-1, none.nearestVertex(41.15, -8.61));
+    EXPECT_EQ(-1, none.nearestEdge(41.15, -8.61).from);
+
+    cal::Graph<unsigned> one;
+    one.appendVertex(0);
+    coordinates.emplace_back(41.15, -8.61);
+    cal::SpatialIndex single(one, coordinates);
+    EXPECT_EQ(0, single.nearestVertex(40, -9));
+    EXPECT_EQ(-1, single.nearestEdge(40, -9).from);
+}
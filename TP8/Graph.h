@@ -1,172 +1,81 @@
 /*
  * Graph.h
+ * Fp08 interface over the common graph library (common/graph).
  */
 #ifndef GRAPH_H_
 #define GRAPH_H_
 
 #include <vector>
-#include <queue>
 #include <limits>
-#include <cmath>
-
-template<class T>
-class Edge;
-
-template<class T>
-class Graph;
+#include "graph/Graph.h"
+#include "graph/Flow.h"
 
 constexpr auto INF = std::numeric_limits<double>::max();
 
-/*
- * ================================================================================================
- * Class Vertex
- * ================================================================================================
- */
-template<class T>
-class Vertex {
-    T info;
-    std::vector<Edge<T> *> outgoing;  // adj
-    std::vector<Edge<T> *> incoming;
-
-    Edge<T> *addEdge(Vertex<T> *dest, double c, double f);
-
-    Vertex(T in);
-
-    bool visited;  // for path finding
-    Edge<T> *path; // for path finding
-
-public:
-    T getInfo() const;
-
-    std::vector<Edge<T> *> getAdj() const;
-
-    friend class Graph<T>;
-};
-
-
-template<class T>
-Vertex<T>::Vertex(T in): info(in) {
-}
-
-template<class T>
-Edge<T> *Vertex<T>::addEdge(Vertex<T> *dest, double c, double f) {
-    Edge<T> *e = new Edge<T>(this, dest, c, f);
-    this->outgoing.push_back(e);
-    dest->incoming.push_back(e);
-    return e;
-}
-
-template<class T>
-T Vertex<T>::getInfo() const {
-    return this->info;
-}
-
-template<class T>
-std::vector<Edge<T> *> Vertex<T>::getAdj() const {
-    return this->outgoing;
-}
-
-
-/* ================================================================================================
- * Class Edge
- * ================================================================================================
- */
-template<class T>
-class Edge {
-    Vertex<T> *orig;
-    Vertex<T> *dest;
-    double capacity;
-    double flow;
-
-    Edge(Vertex<T> *o, Vertex<T> *d, double c, double f = 0);
-
-public:
-    double getFlow() const;
-
-    Vertex<T> *getDest() const;
-
-    friend class Graph<T>;
-
-    friend class Vertex<T>;
-};
-
-template<class T>
-Edge<T>::Edge(Vertex<T> *o, Vertex<T> *d, double w, double f): orig(o), dest(d), capacity(w), flow(f) {}
-
-template<class T>
-double Edge<T>::getFlow() const {
-    return flow;
-}
-
-template<class T>
-Vertex<T> *Edge<T>::getDest() const {
-    return dest;
-}
+// W: type of the capacities and flows (see graph/WeightTraits.h)
+template<class T, class W = double>
+using Vertex = cal::Vertex<T, cal::Flow<W>>;
 
+template<class T, class W = double>
+using Edge = cal::Edge<T, cal::Flow<W>>;
 
 /* ================================================================================================
  * Class Graph
  * ================================================================================================
  */
-template<class T>
-class Graph {
-    std::vector<Vertex<T> *> vertexSet;
+template<class T, class W = double>
+class Graph : public cal::Graph<T, cal::Flow<W>> {
+    using Base = cal::Graph<T, cal::Flow<W>>;
 
-    Vertex<T> *findVertex(const T &inf) const;
+public:
+    Vertex<T, W> *addVertex(const T &in);
 
-    void resetFlows();
+    Edge<T, W> *addEdge(const T &sourc, const T &dest, W c, W f = W(0));
 
-    bool findAugmentationPath(Vertex<T> *s, Vertex<T> *t);
+    std::vector<Vertex<T, W> *> getVertexSet() const;
 
-    void testAndVisit(std::queue<Vertex<T> *> &q, Edge<T> *e, Vertex<T> *w, double residual);
+    void fordFulkerson(T source, T target);
 
-    double findMinResidualAlongPath(Vertex<T> *s, Vertex<T> *t);
+    void updateCapacity(const T &sourc, const T &dest, W c);
 
-    void augmentFlowAlongPath(Vertex<T> *s, Vertex<T> *t, double flow);
+    cal::DistOf<W> resolve();
 
-public:
-    std::vector<Vertex<T> *> getVertexSet() const;
+    // Minimum cut: the vertices on the side of the source, and the (saturated) edges that leave them
+    struct Cut {
+        std::vector<T> sourceSide;
+        std::vector<Edge<T, W> *> edges;
+        cal::DistOf<W> capacity;
+    };
 
-    Vertex<T> *addVertex(const T &in);
+    Cut minCut(T source, T target);
 
-    Edge<T> *addEdge(const T &sourc, const T &dest, double c, double f = 0);
+    cal::GomoryHuTree<W> gomoryHuTree() const;
 
-    void fordFulkerson(T source, T target);
+private:
+    // Source and target of the last fordFulkerson (contents, as removeVertex and reorder
+    // change the ids), empty before it
+    std::vector<T> flowEnds;
 
+    bool findFlowEnds(int &s, int &t) const;
 };
 
-template<class T>
-Vertex<T> *Graph<T>::addVertex(const T &in) {
-    Vertex<T> *v = findVertex(in);
-    if (v != nullptr)
-        return v;
-    v = new Vertex<T>(in);
-    vertexSet.push_back(v);
-    return v;
-}
-
-template<class T>
-Edge<T> *Graph<T>::addEdge(const T &sourc, const T &dest, double c, double f) {
-    auto s = findVertex(sourc);
-    auto d = findVertex(dest);
-    if (s == nullptr || d == nullptr)
-        return nullptr;
-    else
-        return s->addEdge(d, c, f);
+/*
+ * Adds a vertex with a given content; returns the existing vertex if there is one.
+ */
+template<class T, class W>
+Vertex<T, W> *Graph<T, W>::addVertex(const T &in) {
+    Vertex<T, W> *v = this->findVertex(in);
+    return v != nullptr ? v : Base::addVertex(in);
 }
 
-template<class T>
-Vertex<T> *Graph<T>::findVertex(const T &inf) const {
-    for (auto v : vertexSet)
-        if (v->info == inf)
-            return v;
-    return nullptr;
+template<class T, class W>
+Edge<T, W> *Graph<T, W>::addEdge(const T &sourc, const T &dest, W c, W f) {
+    return Base::addEdge(sourc, dest, cal::Flow<W>(c, f));
 }
 
-
-template<class T>
-std::vector<Vertex<T> *> Graph<T>::getVertexSet() const {
-    return vertexSet;
+template<class T, class W>
+std::vector<Vertex<T, W> *> Graph<T, W>::getVertexSet() const {
+    return this->vertexSet;
 }
 
 
@@ -178,98 +87,98 @@ std::vector<Vertex<T> *> Graph<T>::getVertexSet() const {
  * Receives as arguments the source and target vertices (identified by their contents).
  * The result is defined by the "flow" field of each edge.
  */
-template<class T>
-void Graph<T>::fordFulkerson(T source, T target) {
-    resetFlows();
-
-    Vertex<T> *s = findVertex(source);
-    Vertex<T> *t = findVertex(target);
-
-    while (findAugmentationPath(s, t)) {
-        double f = findMinResidualAlongPath(s, t);
-        augmentFlowAlongPath(s, t, f);
-    }
+template<class T, class W>
+void Graph<T, W>::fordFulkerson(T source, T target) {
+    int s = this->findVertexId(source);
+    int t = this->findVertexId(target);
+    if (s < 0 || t < 0 || s == t)
+        throw "Invalid source and/or target vertex";
+    cal::maxFlow(*this, s, t);
+    flowEnds = {source, target};
 }
 
-template<class T>
-void Graph<T>::resetFlows() {
-    for (Vertex<T> *v : vertexSet) {
-        for (Edge<T> *e : v->outgoing) {
-            e->flow = 0;
-        }
-
-        for (Edge<T> *e : v->incoming) {
-            e->flow = 0;
-        }
-    }
+/*
+ * Ids of the source and target of the last fordFulkerson; false if there was none, or one
+ * of them was removed since.
+ */
+template<class T, class W>
+bool Graph<T, W>::findFlowEnds(int &s, int &t) const {
+    if (flowEnds.empty())
+        return false;
+    s = this->findVertexId(flowEnds[0]);
+    t = this->findVertexId(flowEnds[1]);
+    return s >= 0 && t >= 0;
 }
 
-template<class T>
-bool Graph<T>::findAugmentationPath(Vertex<T> *s, Vertex<T> *t) {
-    for (Vertex<T> *v : vertexSet) {
-        v->visited = false;
-    }
-
-    s->visited = true;
-    std::queue<Vertex<T> *> Q{};
-    Q.push(s);
-
-    while (!Q.empty() && !t->visited) {
-        Vertex<T> *vert = Q.front();
-        Q.pop();
-        for (Edge<T> *e : vert->outgoing) {
-            testAndVisit(Q, e, e->dest, e->capacity - e->flow);
-        }
-        for (Edge<T> *e : vert->incoming) {
-            testAndVisit(Q, e, e->orig, e->flow);
-        }
-    }
-
-    return t->visited;
+/*
+ * Changes the capacity of the edge from sourc to dest, keeping the flow of the last
+ * fordFulkerson feasible (see cal::updateCapacity): if the edge carried more than the new
+ * capacity, the excess is rerouted around it or pushed back to the source.
+ * Call resolve() to get the maximum flow again. Without such a flow, only sets the capacity.
+ */
+template<class T, class W>
+void Graph<T, W>::updateCapacity(const T &sourc, const T &dest, W c) {
+    Edge<T, W> *e = nullptr;
+    Vertex<T, W> *u = this->findVertex(sourc);
+    if (u != nullptr)
+        for (auto out : u->getAdj())
+            if (out->getDest()->getInfo() == dest) {
+                e = out;
+                break;
+            }
+    if (e == nullptr)
+        throw "Invalid edge";
+    int s, t;
+    if (findFlowEnds(s, t))
+        cal::updateCapacity(*this, e, c, s, t);
+    else
+        e->capacity = c;
 }
 
-template<class T>
-void Graph<T>::testAndVisit(std::queue<Vertex<T> *> &q, Edge<T> *e, Vertex<T> *w, double residual) {
-    if (!w->visited && residual > 0) {
-        w->visited = true;
-        w->path = e;
-        q.push(w);
-    }
+/*
+ * Maximum flow between the source and target of the last fordFulkerson, after capacity
+ * changes: augments the flow left by updateCapacity instead of starting from zero, so
+ * only the paths through the edges that changed are searched. Returns the value of the flow.
+ */
+template<class T, class W>
+cal::DistOf<W> Graph<T, W>::resolve() {
+    int s, t;
+    if (!findFlowEnds(s, t))
+        throw "No flow to resolve";
+    cal::augmentFlow(*this, s, t);
+    return cal::flowValue(*this, s);
 }
 
-template<class T>
-double Graph<T>::findMinResidualAlongPath(Vertex<T> *s, Vertex<T> *t) {
-    double f = INF;
-    Vertex<T> *v = t;
-
-    while (v != s) {
-        Edge<T> *e = v->path;
-        if (e->dest == v) {
-            f = std::min(f, e->capacity - e->flow);
-            v = e->orig;
-        } else {
-            f = std::min(f, e->flow);
-            v = e->dest;
-        }
-    }
-
-    return f;
+/*
+ * Minimum cut between the source and target vertices (identified by their contents), from
+ * the maximum flow between them, left in the "flow" field of each edge. If they are the
+ * source and target of the last fordFulkerson, its flow is reused (augmented first, as by
+ * resolve, in case capacities changed since); otherwise it runs fordFulkerson.
+ * Its capacity is the value of the maximum flow.
+ */
+template<class T, class W>
+typename Graph<T, W>::Cut Graph<T, W>::minCut(T source, T target) {
+    int s, t;
+    if (findFlowEnds(s, t) && flowEnds[0] == source && flowEnds[1] == target)
+        cal::augmentFlow(*this, s, t);
+    else
+        fordFulkerson(source, target);
+    auto cut = cal::minCut(*this, this->findVertexId(source));
+    Cut res;
+    for (unsigned v : cut.sourceSide)
+        res.sourceSide.push_back(this->getInfo(v));
+    res.edges = std::move(cut.edges);
+    res.capacity = cut.capacity;
+    return res;
 }
 
-template<class T>
-void Graph<T>::augmentFlowAlongPath(Vertex<T> *s, Vertex<T> *t, double flow) {
-    Vertex<T> *v = t;
-
-    while (v != s) {
-        Edge<T> *e = v->path;
-        if (e->dest == v) {
-            e->flow += flow;
-            v = e->orig;
-        } else {
-            e->flow -= flow;
-            v = e->dest;
-        }
-    }
+/*
+ * Gomory-Hu tree of the network, with the capacities taken as undirected: minimum cuts between
+ * all pairs of vertices (by id, see findVertexId) from |V| - 1 maximum flows.
+ */
+template<class T, class W>
+cal::GomoryHuTree<W> Graph<T, W>::gomoryHuTree() const {
+    return cal::GomoryHuTree<W>(*this);
 }
 
 #endif /* GRAPH_H_ */
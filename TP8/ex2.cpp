@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include "Graph.h"
+#include "TestAux.h"
+
+// Minimum cuts and Gomory-Hu trees (graph/Flow.h)
+
+/*
+ * Random network of n vertices with m links (edges in one direction, integer capacities in [1, 10]),
+ * and the same links in both directions in symmetric.
+ */
+static Graph<int> createRandomNetwork(int n, int m, unsigned seed, Graph<int> &symmetric) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> vertex(0, n - 1), capacity(1, 10);
+    Graph<int> g;
+    for (int v = 0; v < n; v++) {
+        g.addVertex(v);
+        symmetric.addVertex(v);
+    }
+    for (int i = 0; i < m; i++) {
+        int u = vertex(gen), v = vertex(gen), c = capacity(gen);
+        if (u == v)
+            continue;
+        g.addEdge(u, v, c);
+        symmetric.addEdge(u, v, c);
+        symmetric.addEdge(v, u, c);
+    }
+    return g;
+}
+
+/// TESTS ///
+
+TEST(TP8_Ex2, test_minCut) {
+    Graph<int> graph = createTestFlowGraph();
+    Graph<int>::Cut cut = graph.minCut(1, 6);
+    EXPECT_EQ(5.0, cut.capacity);
+    EXPECT_EQ(std::vector<int>({1}), cut.sourceSide);
+    ASSERT_EQ(2u, cut.edges.size());
+    for (auto e : cut.edges) {
+        EXPECT_EQ(1, e->getOrig()->getInfo());
+        EXPECT_EQ(e->getCapacity(), e->getFlow());
+    }
+
+    // Bottleneck in the middle: {1, 2, 3} -> {4, 5, 6} only through 3 -> 4
+    Graph<int> chain;
+    for (int i = 1; i <= 6; i++)
+        chain.addVertex(i);
+    chain.addEdge(1, 2, 5);
+    chain.addEdge(2, 3, 5);
+    chain.addEdge(1, 3, 5);
+    chain.addEdge(3, 4, 2);
+    chain.addEdge(4, 5, 5);
+    chain.addEdge(5, 6, 5);
+    chain.addEdge(4, 6, 1);
+    Graph<int>::Cut middle = chain.minCut(1, 6);
+    EXPECT_EQ(2.0, middle.capacity);
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), middle.sourceSide);
+    ASSERT_EQ(1u, middle.edges.size());
+    EXPECT_EQ(3, middle.edges[0]->getOrig()->getInfo());
+    EXPECT_EQ(4, middle.edges[0]->getDest()->getInfo());
+}
+
+TEST(TP8_Ex2, test_minCutRandom) {
+    for (unsigned seed = 0; seed < 5; seed++) {
+        Graph<int> symmetric;
+        Graph<int> g = createRandomNetwork(30, 90, seed, symmetric);
+        Graph<int>::Cut cut = g.minCut(0, 29);
+        double flow = 0;
+        for (auto e : g.getVertex(0)->getAdj())
+            flow += e->getFlow();
+        for (auto e : g.getVertex(0)->getIncoming())
+            flow -= e->getFlow();
+        EXPECT_EQ(flow, cut.capacity);
+        double capacity = 0;
+        for (auto e : cut.edges) {
+            capacity += e->getCapacity();
+            EXPECT_EQ(e->getCapacity(), e->getFlow());
+            EXPECT_TRUE(std::binary_search(cut.sourceSide.begin(), cut.sourceSide.end(), e->getOrig()->getInfo()));
+            EXPECT_FALSE(std::binary_search(cut.sourceSide.begin(), cut.sourceSide.end(), e->getDest()->getInfo()));
+        }
+        EXPECT_EQ(capacity, cut.capacity);
+    }
+}
+
+TEST(TP8_Ex2, test_gomoryHuTree) {
+    for (unsigned seed = 0; seed < 5; seed++) {
+        const int n = 14;
+        Graph<int> symmetric;
+        Graph<int> g = createRandomNetwork(n, 30, seed, symmetric);
+        cal::GomoryHuTree<double> tree = g.gomoryHuTree();
+        ASSERT_EQ((unsigned) n, tree.getNumVertex());
+        EXPECT_EQ(-1, tree.getParent(0));
+        std::vector<double> all = tree.allPairs();
+        double global = tree.globalMinCut();
+        double smallest = -1;
+        for (int u = 0; u < n; u++)
+            for (int v = u + 1; v < n; v++) {
+                double expected = cal::maxFlow(symmetric, u, v);
+                EXPECT_EQ(expected, tree.minCut(u, v));
+                EXPECT_EQ(expected, tree.minCut(v, u));
+                EXPECT_EQ(expected, all[u * n + v]);
+                EXPECT_EQ(expected, all[v * n + u]);
+                if (smallest < 0 || expected < smallest)
+                    smallest = expected;
+            }
+        EXPECT_EQ(smallest, global);
+    }
+}
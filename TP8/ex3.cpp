@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include "Graph.h"
+#include "TestAux.h"
+
+// Max flow after capacity changes, from the previous flow (updateCapacity and resolve)
+
+/*
+ * Checks that the flows of g are within the capacities and balanced at every vertex but
+ * source and target; returns the value of the flow.
+ */
+static double checkFlow(const Graph<int> &g, int source, int target) {
+    std::vector<double> balance(g.getNumVertex(), 0);
+    for (auto v : g.getVertexSet())
+        for (auto e : v->getAdj()) {
+            EXPECT_GE(e->getFlow(), 0);
+            EXPECT_LE(e->getFlow(), e->getCapacity());
+            balance[v->getId()] -= e->getFlow();
+            balance[e->getDest()->getId()] += e->getFlow();
+        }
+    for (auto v : g.getVertexSet())
+        if (v->getInfo() != source && v->getInfo() != target) {
+            EXPECT_EQ(0, balance[v->getId()]);
+        }
+    return balance[g.findVertex(target)->getId()];
+}
+
+/// TESTS ///
+
+TEST(TP8_Ex3, test_resolve) {
+    Graph<int> graph = createTestFlowGraph();
+    graph.fordFulkerson(1, 6);
+
+    // 1 -> 2 carries 3: 2 units go back to the source, the flow is 3 again after resolving
+    graph.updateCapacity(1, 2, 1);
+    EXPECT_EQ(3, checkFlow(graph, 1, 6));
+    EXPECT_EQ(3, graph.resolve());
+    EXPECT_EQ(3, checkFlow(graph, 1, 6));
+
+    // More capacity in the bottleneck, 4 -> 6, and in the edges that feed it
+    graph.updateCapacity(4, 6, 5);
+    graph.updateCapacity(1, 2, 10);
+    EXPECT_EQ(6, graph.resolve());
+    EXPECT_EQ(6, checkFlow(graph, 1, 6));
+
+    // 2 -> 4 carries 3 of the 5 units: they are rerouted through 3, nothing is lost
+    Graph<int> detour;
+    for (int i = 1; i <= 4; i++)
+        detour.addVertex(i);
+    detour.addEdge(1, 2, 5);
+    detour.addEdge(2, 4, 3);
+    detour.addEdge(2, 3, 5);
+    detour.addEdge(3, 4, 5);
+    detour.fordFulkerson(1, 4);
+    EXPECT_EQ(3, detour.findVertex(2)->getAdj()[0]->getFlow());
+    detour.updateCapacity(2, 4, 0);
+    EXPECT_EQ(5, checkFlow(detour, 1, 4));
+    EXPECT_EQ(0, detour.findVertex(2)->getAdj()[0]->getFlow());
+    EXPECT_EQ(5, detour.resolve());
+
+    // minCut between the same vertices starts from the current flow, without resolve
+    detour.updateCapacity(1, 2, 2);
+    Graph<int>::Cut cut = detour.minCut(1, 4);
+    EXPECT_EQ(2, cut.capacity);
+    EXPECT_EQ(std::vector<int>({1}), cut.sourceSide);
+    detour.updateCapacity(1, 2, 5);
+    EXPECT_EQ(5, detour.minCut(1, 4).capacity);
+    EXPECT_EQ(5, checkFlow(detour, 1, 4));
+    EXPECT_EQ(5, detour.minCut(2, 4).capacity);  // through 3 (2 -> 4 has no capacity)
+    EXPECT_THROW(detour.minCut(2, 2), const char *);
+
+    // Removing a vertex changes the ids of the following ones, not the ends of the flow
+    Graph<int> shifted;
+    for (int i = 0; i <= 4; i++)
+        shifted.addVertex(i);
+    shifted.addEdge(1, 2, 5);
+    shifted.addEdge(2, 4, 3);
+    shifted.addEdge(2, 3, 5);
+    shifted.addEdge(3, 4, 5);
+    shifted.fordFulkerson(1, 4);
+    shifted.removeVertex(0);
+    shifted.updateCapacity(3, 4, 1);
+    EXPECT_EQ(4, checkFlow(shifted, 1, 4));
+    EXPECT_EQ(4, shifted.resolve());
+    shifted.removeVertex(4);
+    EXPECT_THROW(shifted.resolve(), const char *);
+
+    EXPECT_THROW(graph.updateCapacity(6, 1, 1), const char *);
+    Graph<int> unsolved = createTestFlowGraph();
+    EXPECT_THROW(unsolved.resolve(), const char *);
+}
+
+TEST(TP8_Ex3, test_resolveRandomChanges) {
+    std::mt19937 gen(8);
+    const int n = 40;
+    std::uniform_int_distribution<int> vertex(0, n - 1), capacity(0, 10);
+    Graph<int> warm, cold;
+    for (int v = 0; v < n; v++) {
+        warm.addVertex(v);
+        cold.addVertex(v);
+    }
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 0; i < 200; i++) {
+        int u = vertex(gen), v = vertex(gen), c = capacity(gen);
+        if (u == v)
+            continue;
+        warm.addEdge(u, v, c);
+        cold.addEdge(u, v, c);
+        edges.emplace_back(u, v);
+    }
+    warm.fordFulkerson(0, n - 1);
+    std::uniform_int_distribution<size_t> edge(0, edges.size() - 1);
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 3; i++) {
+            auto changed = edges[edge(gen)];
+            int c = capacity(gen);
+            warm.updateCapacity(changed.first, changed.second, c);
+            cold.updateCapacity(changed.first, changed.second, c);
+            checkFlow(warm, 0, n - 1);
+        }
+        cold.fordFulkerson(0, n - 1);
+        double expected = checkFlow(cold, 0, n - 1);
+        EXPECT_EQ(expected, warm.resolve());
+        EXPECT_EQ(expected, checkFlow(warm, 0, n - 1));
+    }
+}
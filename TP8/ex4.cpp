@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include "Graph.h"
+#include "graph/GridFlow.h"
+
+// Maximum flow in grid networks (Boykov-Kolmogorov, graph/GridFlow.h)
+
+/*
+ * Random rows x cols grid network, in both representations: capacities of the edges to the
+ * neighbours in [0, maxCapacity], and of the terminal edges (to the vertices rows * cols, the
+ * source, and rows * cols + 1, the sink) in [0, maxTerminal].
+ */
+static void createRandomGridNetwork(unsigned rows, unsigned cols, int maxCapacity, int maxTerminal, unsigned seed,
+                                    cal::GridFlowNetwork<int> &grid, Graph<int> &g) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> capacity(0, maxCapacity), terminal(0, maxTerminal);
+    const int n = rows * cols;
+    for (int v = 0; v < n + 2; v++)
+        g.addVertex(v);
+    for (unsigned r = 0; r < rows; r++)
+        for (unsigned c = 0; c < cols; c++) {
+            int v = grid.id(r, c);
+            int fromSource = terminal(gen), toSink = terminal(gen);
+            grid.addTerminalCapacities(v, fromSource, toSink);
+            g.addEdge(n, v, fromSource);
+            g.addEdge(v, n + 1, toSink);
+            if (c + 1 < cols) {
+                int right = capacity(gen), left = capacity(gen);
+                grid.setCapacity(v, cal::GridFlowNetwork<int>::RIGHT, right);
+                grid.setCapacity(v + 1, cal::GridFlowNetwork<int>::LEFT, left);
+                g.addEdge(v, v + 1, right);
+                g.addEdge(v + 1, v, left);
+            }
+            if (r + 1 < rows) {
+                int down = capacity(gen), up = capacity(gen);
+                grid.setCapacity(v, cal::GridFlowNetwork<int>::DOWN, down);
+                grid.setCapacity(v + cols, cal::GridFlowNetwork<int>::UP, up);
+                g.addEdge(v, v + cols, down);
+                g.addEdge(v + cols, v, up);
+            }
+        }
+}
+
+/// TESTS ///
+
+TEST(TP8_Ex4, test_gridMaxFlow) {
+    for (unsigned seed = 0; seed < 10; seed++) {
+        const unsigned rows = 12 + seed, cols = 20 - seed;
+        const int n = rows * cols;
+        cal::GridFlowNetwork<int> grid(rows, cols);
+        Graph<int> g;
+        createRandomGridNetwork(rows, cols, 10, seed % 2 ? 5 : 20, seed, grid, g);
+        g.fordFulkerson(n, n + 1);
+        double expected = cal::flowValue(g, n);
+        EXPECT_EQ(expected, grid.maxFlow());
+
+        // The vertices on the source side are the same as in the minimum cut of g
+        Graph<int>::Cut cut = g.minCut(n, n + 1);
+        std::vector<bool> sourceSide(n + 2, false);
+        for (int v : cut.sourceSide)
+            sourceSide[v] = true;
+        for (int v = 0; v < n; v++)
+            EXPECT_EQ(sourceSide[v], grid.inSourceSide(v));
+
+        // Calling it again (without changes) keeps the flow
+        EXPECT_EQ(expected, grid.maxFlow());
+    }
+}
+
+TEST(TP8_Ex4, test_gridCornerToCorner) {
+    // As in the TP8 benchmark: from the top-left to the bottom-right corner
+    const unsigned side = 30;
+    cal::GridFlowNetwork<int> grid(side, side);
+    Graph<int> g;
+    createRandomGridNetwork(side, side, 30, 0, 1, grid, g);
+    grid.addTerminalCapacities(0, 1000, 0);
+    grid.addTerminalCapacities(side * side - 1, 0, 1000);
+    g.fordFulkerson(0, side * side - 1);
+    EXPECT_EQ(cal::flowValue(g, 0), grid.maxFlow());
+    EXPECT_TRUE(grid.inSourceSide(0));
+    EXPECT_FALSE(grid.inSourceSide(side * side - 1));
+}
+
+TEST(TP8_Ex4, test_gridIncrementalTerminals) {
+    // More terminal capacity after a maximum flow: the next one continues from it
+    const unsigned rows = 16, cols = 16;
+    cal::GridFlowNetwork<int> grid(rows, cols);
+    Graph<int> g;
+    createRandomGridNetwork(rows, cols, 8, 6, 3, grid, g);
+    grid.maxFlow();
+    const int n = rows * cols;
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<int> vertex(0, n - 1), capacity(1, 10);
+    for (int i = 0; i < 20; i++) {
+        int v = vertex(gen), fromSource = capacity(gen), toSink = capacity(gen);
+        grid.addTerminalCapacities(v, fromSource, toSink);
+        g.addEdge(n, v, fromSource);
+        g.addEdge(v, n + 1, toSink);
+    }
+    g.fordFulkerson(n, n + 1);
+    EXPECT_EQ(cal::flowValue(g, n), grid.maxFlow());
+}
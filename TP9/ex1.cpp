@@ -83,3 +83,32 @@ TEST(TP9_Ex1, testMinCostFlow3) {
 
     EXPECT_EQ(cost, 6);
 }
+
+TEST(TP9_Ex1, testMinCostFlowIntegers) {
+    // Same network as testMinCostFlow2, with exact integer capacities, flows and costs
+    Graph<string, int> g;
+
+    g.addVertex("s");
+    g.addVertex("a");
+    g.addVertex("b");
+    g.addVertex("c");
+    g.addVertex("d");
+    g.addVertex("t");
+
+    g.addEdge("s", "a", 3, 0);
+    g.addEdge("s", "b", 2, 0);
+    g.addEdge("a", "b", 1, -2);
+    g.addEdge("a", "c", 3, 1);
+    g.addEdge("a", "d", 4, 2);
+    g.addEdge("b", "d", 2, 2);
+    g.addEdge("c", "t", 2, 1);
+    g.addEdge("d", "t", 3, 1);
+
+    EXPECT_EQ(g.minCostFlow("s", "t", 3), 5);
+    EXPECT_EQ(g.getFlow("a", "b"), 1);
+    EXPECT_EQ(g.getFlow("d", "t"), 1);
+
+    // All the flow the network supports
+    EXPECT_EQ(g.minCostFlow("s", "t", INF), 13);
+    EXPECT_EQ(g.getFlow("c", "t") + g.getFlow("d", "t"), 5);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include "Graph.h"
+#include "graph/Assignment.h"
+
+// Dense assignment problems (graph/Assignment.h), against minCostFlow
+
+/*
+ * Minimum cost of the assignment with the given costs (n x n, by rows), as a minimum cost
+ * flow of value n: source -> rows -> columns -> sink, all of capacity 1.
+ */
+static double minCostFlowAssignment(const std::vector<int> &costs, int n) {
+    Graph<int> g;
+    for (int v = 0; v < 2 * n + 2; v++)
+        g.addVertex(v);
+    const int source = 2 * n, sink = 2 * n + 1;
+    for (int i = 0; i < n; i++) {
+        g.addEdge(source, i, 1, 0);
+        g.addEdge(n + i, sink, 1, 0);
+        for (int j = 0; j < n; j++)
+            g.addEdge(i, n + j, 1, costs[i * n + j]);
+    }
+    return g.minCostFlow(source, sink, n);
+}
+
+template<class C>
+static void checkAssignment(const std::vector<int> &costs, unsigned n, const cal::Assignment<C> &a) {
+    ASSERT_EQ(n, a.columnOf.size());
+    std::vector<bool> used(n, false);
+    int64_t cost = 0;
+    for (unsigned i = 0; i < n; i++) {
+        ASSERT_LT(a.columnOf[i], n);
+        EXPECT_FALSE(used[a.columnOf[i]]);
+        used[a.columnOf[i]] = true;
+        cost += costs[i * n + a.columnOf[i]];
+    }
+    EXPECT_EQ(cost, a.cost);
+}
+
+/// TESTS ///
+
+TEST(TP9_Ex2, test_assignmentSmall) {
+    // 3 x 3: the cheapest cost of the first row is not in the optimum (2 + 1 + 8)
+    std::vector<int> costs = {1, 2, 9,
+                              1, 9, 9,
+                              9, 3, 8};
+    EXPECT_EQ(11, cal::hungarian(costs, 3).cost);
+    EXPECT_EQ(std::vector<unsigned>({1, 0, 2}), cal::hungarian(costs, 3).columnOf);
+    EXPECT_EQ(11, cal::auction(costs, 3).cost);
+    EXPECT_EQ(std::vector<unsigned>({1, 0, 2}), cal::auction(costs, 3).columnOf);
+
+    std::vector<int> one = {-4};
+    EXPECT_EQ(-4, cal::hungarian(one, 1).cost);
+    EXPECT_EQ(-4, cal::auction(one, 1).cost);
+    EXPECT_EQ(0, cal::auction(std::vector<int>(), 0).cost);
+}
+
+TEST(TP9_Ex2, test_assignmentBruteForce) {
+    std::mt19937 gen(9);
+    for (unsigned n = 2; n <= 7; n++)
+        for (int k = 0; k < 5; k++) {
+            std::uniform_int_distribution<int> cost(-20, k % 2 ? 5 : 100);
+            std::vector<int> costs(n * n);
+            for (int &c : costs)
+                c = cost(gen);
+            std::vector<unsigned> p(n);
+            std::iota(p.begin(), p.end(), 0);
+            int64_t best = std::numeric_limits<int64_t>::max();
+            do {
+                int64_t total = 0;
+                for (unsigned i = 0; i < n; i++)
+                    total += costs[i * n + p[i]];
+                best = std::min(best, total);
+            } while (std::next_permutation(p.begin(), p.end()));
+            auto h = cal::hungarian(costs, n);
+            auto a = cal::auction(costs, n);
+            checkAssignment(costs, n, h);
+            checkAssignment(costs, n, a);
+            EXPECT_EQ(best, h.cost);
+            EXPECT_EQ(best, a.cost);
+        }
+}
+
+TEST(TP9_Ex2, test_assignmentAgainstMinCostFlow) {
+    std::mt19937 gen(10);
+    for (unsigned n : {10, 25, 40}) {
+        // Many equal costs (ties), then a wide range
+        for (int maxCost : {3, 1000}) {
+            std::uniform_int_distribution<int> cost(0, maxCost);
+            std::vector<int> costs(n * n);
+            for (int &c : costs)
+                c = cost(gen);
+            double expected = minCostFlowAssignment(costs, n);
+            auto h = cal::hungarian(costs, n);
+            auto a = cal::auction(costs, n);
+            checkAssignment(costs, n, h);
+            checkAssignment(costs, n, a);
+            EXPECT_EQ(expected, h.cost);
+            EXPECT_EQ(expected, a.cost);
+        }
+    }
+}
@@ -0,0 +1,234 @@
+/*
+ * Benchmark.cpp
+ */
+
+#include "Benchmark.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+/********************** BenchmarkResult  ****************************/
+
+BenchmarkResult::BenchmarkResult(std::string name) : name(std::move(name)) {}
+
+BenchmarkResult &BenchmarkResult::param(const std::string &key, const std::string &value) {
+    params.emplace_back(key, value);
+    return *this;
+}
+
+BenchmarkResult &BenchmarkResult::param(const std::string &key, long value) {
+    return param(key, std::to_string(value));
+}
+
+BenchmarkResult &BenchmarkResult::counter(const std::string &key, double value) {
+    counters.emplace_back(key, value);
+    return *this;
+}
+
+std::string BenchmarkResult::getName() const {
+    return name;
+}
+
+/*
+ * Identifies a case across runs: name followed by its parameters.
+ */
+std::string BenchmarkResult::getKey() const {
+    std::string key = name;
+    for (auto &p : params)
+        key += " " + p.first + "=" + p.second;
+    return key;
+}
+
+double BenchmarkResult::min() const {
+    return samples.empty() ? 0 : samples.front();
+}
+
+double BenchmarkResult::max() const {
+    return samples.empty() ? 0 : samples.back();
+}
+
+double BenchmarkResult::mean() const {
+    if (samples.empty()) return 0;
+    return std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+}
+
+double BenchmarkResult::median() const {
+    return percentile(50);
+}
+
+/*
+ * Percentile (0 to 100) of the samples, interpolating between the closest ranks.
+ */
+double BenchmarkResult::percentile(double p) const {
+    if (samples.empty()) return 0;
+    double rank = p / 100.0 * (samples.size() - 1);
+    size_t lo = (size_t) std::floor(rank);
+    size_t hi = (size_t) std::ceil(rank);
+    return samples[lo] + (samples[hi] - samples[lo]) * (rank - lo);
+}
+
+/*************************** Benchmark  **************************/
+
+Benchmark::Benchmark(std::string suite, int argc, char **argv) : suite(std::move(suite)) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            std::cerr << "Ignoring argument " << arg << std::endl;
+            continue;
+        }
+        std::string value = (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) ? argv[++i] : "1";
+        options[arg.substr(2)] = value;
+    }
+    warmup = getInt("warmup", warmup);
+    repetitions = std::max(1L, getInt("reps", repetitions));
+    seed = getInt("seed", seed);
+    if (!getString("trace", "").empty())
+        Trace::enable();
+    std::cout << "suite " << this->suite << " (warm-up " << warmup << ", repetitions " << repetitions
+              << ", seed " << seed << ")" << std::endl;
+}
+
+long Benchmark::getInt(const std::string &option, long def) const {
+    auto it = options.find(option);
+    return it == options.end() ? def : std::stol(it->second);
+}
+
+double Benchmark::getDouble(const std::string &option, double def) const {
+    auto it = options.find(option);
+    return it == options.end() ? def : std::stod(it->second);
+}
+
+std::string Benchmark::getString(const std::string &option, const std::string &def) const {
+    auto it = options.find(option);
+    return it == options.end() ? def : it->second;
+}
+
+unsigned Benchmark::getSeed() const {
+    return seed;
+}
+
+/*
+ * Random generator for the input data. Independent streams are used for
+ * independent inputs, so that adding a case does not change the others.
+ */
+std::mt19937 Benchmark::rng(unsigned stream) const {
+    std::seed_seq seq{seed, stream};
+    return std::mt19937(seq);
+}
+
+bool Benchmark::enabled(const std::string &name) const {
+    auto it = options.find("filter");
+    return it == options.end() || name.find(it->second) != std::string::npos;
+}
+
+double Benchmark::elapsedSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Benchmark::reportPending() {
+    for (; reported < results.size(); reported++) {
+        BenchmarkResult &res = results[reported];
+        if (res.samples.empty()) continue;
+        std::cout << res.getKey() << "; median (ms)=" << res.median() * 1e3
+                  << "; p90 (ms)=" << res.percentile(90) * 1e3
+                  << "; min (ms)=" << res.min() * 1e3 << "; max (ms)=" << res.max() * 1e3;
+        for (auto &c : res.counters)
+            std::cout << "; " << c.first << "=" << c.second;
+        std::cout << std::endl;
+    }
+}
+
+static std::string jsonString(const std::string &s) {
+    std::string res = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') res += '\\';
+        res += c;
+    }
+    return res + "\"";
+}
+
+/*
+ * One result per line, so that reports can be diffed and read back by compareWithBaseline.
+ */
+void Benchmark::writeJson(std::ostream &os) const {
+    os.precision(9);
+    os << "{\"suite\": " << jsonString(suite) << ", \"seed\": " << seed << ", \"warmup\": " << warmup
+       << ", \"repetitions\": " << repetitions << ", \"results\": [\n";
+    bool first = true;
+    for (auto &res : results) {
+        if (res.samples.empty()) continue;
+        if (!first) os << ",\n";
+        first = false;
+        os << "{\"key\": " << jsonString(res.getKey()) << ", \"name\": " << jsonString(res.name) << ", \"params\": {";
+        for (size_t i = 0; i < res.params.size(); i++)
+            os << (i ? ", " : "") << jsonString(res.params[i].first) << ": " << jsonString(res.params[i].second);
+        os << "}, \"median_s\": " << res.median() << ", \"mean_s\": " << res.mean()
+           << ", \"min_s\": " << res.min() << ", \"max_s\": " << res.max()
+           << ", \"p90_s\": " << res.percentile(90) << ", \"p99_s\": " << res.percentile(99) << ", \"counters\": {";
+        for (size_t i = 0; i < res.counters.size(); i++)
+            os << (i ? ", " : "") << jsonString(res.counters[i].first) << ": " << res.counters[i].second;
+        os << "}}";
+    }
+    os << "\n]}" << std::endl;
+}
+
+/*
+ * Reads the "key" and "median_s" fields of a report written by writeJson.
+ * Returns the number of cases slower than the baseline by more than "tolerance" percent.
+ */
+int Benchmark::compareWithBaseline(const std::string &filename, double tolerance) const {
+    std::ifstream is(filename);
+    if (!is) {
+        std::cerr << "Failed to read baseline " << filename << "." << std::endl;
+        return 1;
+    }
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(is, line)) {
+        size_t k = line.find("{\"key\": \"");
+        size_t m = line.find("\"median_s\": ");
+        if (k == std::string::npos || m == std::string::npos) continue;
+        k += 9;
+        std::string key = line.substr(k, line.find("\", \"name\"", k) - k);
+        baseline[key] = std::stod(line.substr(m + 12));
+    }
+    int regressions = 0;
+    for (auto &res : results) {
+        auto it = baseline.find(res.getKey());
+        if (res.samples.empty() || it == baseline.end()) continue;
+        double change = (res.median() / it->second - 1) * 100;
+        if (change > tolerance) {
+            std::cout << "REGRESSION " << res.getKey() << ": " << it->second * 1e3 << " ms -> "
+                      << res.median() * 1e3 << " ms (+" << change << "%)" << std::endl;
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+/*
+ * Prints the remaining results, writes the JSON report and checks the baseline.
+ * Returns the exit code of the benchmark executable.
+ */
+int Benchmark::finish() {
+    reportPending();
+    std::string json = getString("json", "");
+    if (json == "-") {
+        writeJson(std::cout);
+    } else if (!json.empty()) {
+        std::ofstream os(json);
+        writeJson(os);
+    }
+    std::string trace = getString("trace", "");
+    if (!trace.empty() && !Trace::writeJson(trace))
+        std::cerr << "Failed to write trace " << trace << "." << std::endl;
+    std::string baseline = getString("baseline", "");
+    if (!baseline.empty() && compareWithBaseline(baseline, getDouble("tolerance", 10)) > 0)
+        return 1;
+    return 0;
+}
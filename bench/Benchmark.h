@@ -0,0 +1,148 @@
+/*
+ * Benchmark.h
+ * Harness shared by the benchmark executables (one per TP class):
+ * warm-up, repetitions, order statistics, fixed random seeds and JSON output.
+ */
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Trace.h"
+
+/**
+ * Timings (in seconds) and counters collected for one benchmark case.
+ */
+class BenchmarkResult {
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> params;
+    std::vector<std::pair<std::string, double>> counters;
+    std::vector<double> samples;  // sorted after the last repetition
+
+    friend class Benchmark;
+
+public:
+    explicit BenchmarkResult(std::string name);
+
+    BenchmarkResult &param(const std::string &key, const std::string &value);
+
+    BenchmarkResult &param(const std::string &key, long value);
+
+    BenchmarkResult &counter(const std::string &key, double value);
+
+    std::string getName() const;
+
+    std::string getKey() const;
+
+    double min() const;
+
+    double max() const;
+
+    double mean() const;
+
+    double median() const;
+
+    double percentile(double p) const;
+};
+
+/**
+ * Usage:
+ *   Benchmark bench("TP6", argc, argv);
+ *   bench.run("dijkstra", [&]() { ... }).param("n", n);
+ *   return bench.finish();
+ *
+ * Command line options:
+ *   --warmup N       untimed runs before measuring (default 1)
+ *   --reps N         timed repetitions (default 5)
+ *   --seed N         base seed of every random generator (default 42)
+ *   --filter TEXT    only run the cases whose name contains TEXT
+ *   --json FILE      writes the results as JSON ("-" for stdout)
+ *   --baseline FILE  compares the medians with a previous JSON report, and
+ *                    fails if any case got slower than --tolerance percent (default 10)
+ *   --trace FILE     records the timed runs and the phases annotated with TRACE_SCOPE
+ *                    (common/Trace.h) in Chrome trace event format
+ * Any other "--key value" pair can be read with getInt/getDouble/getString
+ * (used for the problem sizes).
+ */
+class Benchmark {
+    std::string suite;
+    std::map<std::string, std::string> options;
+    unsigned warmup = 1;
+    unsigned repetitions = 5;
+    unsigned seed = 42;
+    std::deque<BenchmarkResult> results;  // deque: references returned by run() stay valid
+    size_t reported = 0;  // results already printed
+
+    static double elapsedSince(std::chrono::steady_clock::time_point start);
+
+    void reportPending();
+
+    void writeJson(std::ostream &os) const;
+
+    int compareWithBaseline(const std::string &filename, double tolerance) const;
+
+public:
+    Benchmark(std::string suite, int argc, char **argv);
+
+    long getInt(const std::string &option, long def) const;
+
+    double getDouble(const std::string &option, double def) const;
+
+    std::string getString(const std::string &option, const std::string &def) const;
+
+    unsigned getSeed() const;
+
+    std::mt19937 rng(unsigned stream = 0) const;
+
+    bool enabled(const std::string &name) const;
+
+    template<class F>
+    BenchmarkResult &run(const std::string &name, F body);
+
+    template<class Setup, class F>
+    BenchmarkResult &run(const std::string &name, Setup setup, F body);
+
+    int finish();
+};
+
+/*
+ * Times body() after "warmup" untimed calls.
+ */
+template<class F>
+BenchmarkResult &Benchmark::run(const std::string &name, F body) {
+    return run(name, []() {}, body);
+}
+
+/*
+ * Same as above, but calls setup() (untimed) before every run of body(),
+ * for algorithms that modify their input.
+ */
+template<class Setup, class F>
+BenchmarkResult &Benchmark::run(const std::string &name, Setup setup, F body) {
+    reportPending(); // parameters and counters of the previous case are complete by now
+    results.emplace_back(name);
+    BenchmarkResult &res = results.back();
+    if (!enabled(name)) return res;
+    for (unsigned i = 0; i < warmup; i++) {
+        setup();
+        body();
+    }
+    for (unsigned i = 0; i < repetitions; i++) {
+        setup();
+        TraceScope scope(res.name.c_str());
+        auto start = std::chrono::steady_clock::now();
+        body();
+        res.samples.push_back(elapsedSince(start));
+    }
+    std::sort(res.samples.begin(), res.samples.end());
+    return res;
+}
+
+#endif /* BENCHMARK_H_ */
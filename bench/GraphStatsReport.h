@@ -0,0 +1,34 @@
+/*
+ * GraphStatsReport.h
+ * Reports the operation counters of common/GraphStats.h in the graph benchmarks.
+ */
+#ifndef GRAPH_STATS_REPORT_H_
+#define GRAPH_STATS_REPORT_H_
+
+#include "Benchmark.h"
+#include "GraphStats.h"
+
+/*
+ * Same as bench.run(name, setup, body), but resets the counters before every run
+ * and adds the (non-zero) counters of the last run to the result.
+ * Without CAL_GRAPH_STATS there are no counters to report, and this is just bench.run.
+ */
+template<class Setup, class F>
+BenchmarkResult &runCounted(Benchmark &bench, const std::string &name, Setup setup, F body) {
+    BenchmarkResult &res = bench.run(name, [&]() {
+        setup();
+        graphStats().reset();
+    }, body);
+    if (GraphStats::enabled() && bench.enabled(name))
+        for (const auto &counter : graphStats().values())
+            if (counter.second != 0)
+                res.counter(counter.first, (double) counter.second);
+    return res;
+}
+
+template<class F>
+BenchmarkResult &runCounted(Benchmark &bench, const std::string &name, F body) {
+    return runCounted(bench, name, []() {}, body);
+}
+
+#endif /* GRAPH_STATS_REPORT_H_ */
@@ -0,0 +1,69 @@
+/*
+ * ImplicitRandomGraph.h
+ * Random graphs too large to store, for the benchmarks of the algorithms that only read the edges.
+ */
+#ifndef IMPLICIT_RANDOM_GRAPH_H_
+#define IMPLICIT_RANDOM_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Directed graph whose edges are computed when needed: the i-th edge of u goes to a vertex
+ * given by a hash of u * degree + i (edge handle). Only provides the view read by the
+ * components and PageRank (getNumVertex, out, target), so it can have billions of edges.
+ */
+class ImplicitRandomGraph {
+    unsigned n, degree;
+    uint64_t seed;
+
+public:
+    static constexpr bool directed = true;
+
+    class EdgeRange {
+        uint64_t first;
+        unsigned count;
+
+    public:
+        class iterator {
+            uint64_t e;
+
+        public:
+            explicit iterator(uint64_t e) : e(e) {}
+
+            uint64_t operator*() const { return e; }
+
+            iterator &operator++() {
+                ++e;
+                return *this;
+            }
+
+            bool operator!=(const iterator &other) const { return e != other.e; }
+        };
+
+        EdgeRange(uint64_t first, unsigned count) : first(first), count(count) {}
+
+        iterator begin() const { return iterator(first); }
+
+        iterator end() const { return iterator(first + count); }
+
+        size_t size() const { return count; }
+
+        uint64_t operator[](size_t i) const { return first + i; }
+    };
+
+    ImplicitRandomGraph(unsigned n, unsigned degree, uint64_t seed) : n(n), degree(degree), seed(seed) {}
+
+    int getNumVertex() const { return n; }
+
+    EdgeRange out(unsigned u) const { return EdgeRange((uint64_t) u * degree, degree); }
+
+    unsigned target(uint64_t e) const {
+        uint64_t z = e + seed + 0x9e3779b97f4a7c15ULL;  // splitmix64
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return (z ^ (z >> 31)) % n;
+    }
+};
+
+#endif /* IMPLICIT_RANDOM_GRAPH_H_ */
@@ -0,0 +1,38 @@
+/*
+ * TP10_bench.cpp
+ * String matching (Knuth-Morris-Pratt) and edit distance.
+ * Sizes: --text (text length for KMP), --min, --max (string lengths for the edit distance, doubled at each step).
+ */
+
+#include "exercises.h"
+#include "Benchmark.h"
+
+static std::string randomString(long n, std::mt19937 gen) {
+    std::uniform_int_distribution<int> dis('a', 'd');
+    std::string s(n, ' ');
+    for (auto &c : s)
+        c = (char) dis(gen);
+    return s;
+}
+
+int main(int argc, char **argv) {
+    Benchmark bench("TP10", argc, argv);
+    const long TEXT_SIZE = bench.getInt("text", 1 << 20);
+    const long MIN_SIZE = bench.getInt("min", 128);
+    const long MAX_SIZE = bench.getInt("max", 2048);
+
+    // Long patterns over a 4 letter alphabet almost never occur (kmpMatcher prints every match)
+    const std::string text = randomString(TEXT_SIZE, bench.rng(0));
+    for (long m : {16, 64}) {
+        const std::string pattern = randomString(m, bench.rng(m));
+        bench.run("kmp", [&]() { kmpMatcher(text, pattern); }).param("n", TEXT_SIZE).param("m", m);
+    }
+
+    for (long n = MIN_SIZE; n <= MAX_SIZE; n *= 2) {
+        const std::string a = randomString(n, bench.rng(2 * n));
+        const std::string b = randomString(n, bench.rng(2 * n + 1));
+        bench.run("edit_distance", [&]() { editDistance(a, b); }).param("n", n);
+    }
+
+    return bench.finish();
+}
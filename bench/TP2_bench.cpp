@@ -0,0 +1,71 @@
+/*
+ * TP2_bench.cpp
+ * Sudoku backtracking: solving puzzles that need an increasing number of back steps,
+ * counting solutions and generating puzzles.
+ */
+
+#include "exercises.h"
+#include "Benchmark.h"
+
+#include <cstdlib>
+
+// Same puzzles as the TP2_Ex2 tests.
+static int someBackSteps[9][9] =
+        {{7, 0, 5, 2, 6, 3, 4, 0, 9},
+         {0, 0, 0, 0, 0, 0, 0, 3, 0},
+         {0, 0, 0, 0, 8, 0, 0, 0, 0},
+         {0, 0, 9, 5, 0, 4, 0, 0, 2},
+         {5, 0, 6, 0, 0, 0, 7, 0, 8},
+         {2, 0, 0, 8, 0, 0, 1, 0, 0},
+         {0, 0, 0, 0, 1, 0, 0, 0, 0},
+         {0, 2, 0, 0, 0, 0, 0, 0, 0},
+         {3, 0, 8, 7, 2, 9, 6, 0, 4}};
+
+static int manyBackSteps[9][9] =
+        {{1, 0, 0, 0, 0, 7, 0, 0, 0},
+         {0, 7, 0, 0, 6, 0, 8, 0, 0},
+         {2, 0, 0, 0, 4, 0, 6, 0, 0},
+         {7, 6, 4, 0, 0, 0, 9, 0, 0},
+         {0, 0, 0, 0, 2, 0, 5, 6, 0},
+         {0, 0, 0, 0, 0, 0, 0, 0, 0},
+         {0, 1, 0, 0, 3, 0, 0, 0, 0},
+         {4, 0, 0, 1, 0, 0, 0, 0, 5},
+         {0, 5, 0, 0, 0, 4, 0, 9, 0}};
+
+static int minimalClues[9][9] =
+        {{7, 0, 0, 1, 0, 8, 0, 0, 0},
+         {0, 9, 0, 0, 0, 0, 0, 3, 2},
+         {0, 0, 0, 0, 0, 5, 0, 0, 0},
+         {0, 0, 0, 0, 0, 0, 1, 0, 0},
+         {9, 6, 0, 0, 2, 0, 0, 0, 0},
+         {0, 0, 0, 0, 0, 0, 8, 0, 0},
+         {0, 0, 0, 0, 0, 0, 0, 0, 0},
+         {0, 0, 5, 0, 0, 1, 0, 0, 0},
+         {3, 2, 0, 0, 0, 0, 0, 0, 6}};
+
+int main(int argc, char **argv) {
+    Benchmark bench("TP2", argc, argv);
+
+    struct {
+        const char *name;
+        int (*puzzle)[9];
+    } puzzles[] = {{"some_back_steps", someBackSteps},
+                   {"many_back_steps", manyBackSteps},
+                   {"minimal_clues",   minimalClues}};
+
+    for (auto &p : puzzles) {
+        Sudoku s;
+        bench.run("sudoku_solve", [&]() { s = Sudoku(p.puzzle); }, [&]() { s.solve(); }).param("puzzle", p.name);
+        bench.run("sudoku_count_solutions", [&]() { s = Sudoku(p.puzzle); }, [&]() { s.countSolutions(); })
+                .param("puzzle", p.name);
+    }
+
+    Sudoku s;
+    unsigned round = 0;
+    bench.run("sudoku_generate", [&]() {
+        s = Sudoku();
+        srand(bench.getSeed() + round++);
+    }, [&]() { s.generate(); });
+
+    return bench.finish();
+}
@@ -0,0 +1,45 @@
+/*
+ * TP3_bench.cpp
+ * Closest pair of points: brute force vs divide-and-conquer (single and multi-threaded).
+ * Sizes: --min, --max (points, doubled at each step), --bf-max (largest size for brute force).
+ */
+
+#include "exercises.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+
+/*
+ * Generates n distinct points with integer coordinates in a square of side 4n.
+ */
+static std::vector<Point> randomPoints(long n, std::mt19937 gen) {
+    std::uniform_int_distribution<int> dis(0, 4 * n);
+    std::vector<Point> vp;
+    for (long i = 0; i < n; i++)
+        vp.push_back(Point(dis(gen), dis(gen)));
+    return vp;
+}
+
+int main(int argc, char **argv) {
+    Benchmark bench("TP3", argc, argv);
+    const long MIN_SIZE = bench.getInt("min", 1000);
+    const long MAX_SIZE = bench.getInt("max", 64000);
+    const long BF_MAX_SIZE = bench.getInt("bf-max", 8000);
+    const int MAX_THREADS = bench.getInt("threads", 8);
+
+    for (long n = MIN_SIZE; n <= MAX_SIZE; n *= 2) {
+        const std::vector<Point> points = randomPoints(n, bench.rng(n));
+        std::vector<Point> vp;
+        auto reset = [&]() { vp = points; };
+
+        if (n <= BF_MAX_SIZE)
+            bench.run("closest_pair_bf", reset, [&]() { nearestPoints_BF(vp); }).param("n", n);
+        bench.run("closest_pair_dc", reset, [&]() { nearestPoints_DC(vp); }).param("n", n);
+        for (int threads = 2; threads <= MAX_THREADS; threads *= 2) {
+            setNumThreads(threads);
+            bench.run("closest_pair_dc_mt", reset, [&]() { nearestPoints_DC_MT(vp); })
+                    .param("n", n).param("threads", threads);
+        }
+    }
+    return bench.finish();
+}
@@ -0,0 +1,45 @@
+/*
+ * TP4_bench.cpp
+ * Dynamic programming: maximum subsequence (DP vs divide-and-conquer), change making
+ * and set partitioning.
+ * Sizes: --min, --max, --step (array sizes for the maximum subsequence, at most 10000).
+ */
+
+#include "exercises.h"
+#include "Benchmark.h"
+
+#include <vector>
+
+int main(int argc, char **argv) {
+    Benchmark bench("TP4", argc, argv);
+    const long MIN_SIZE = bench.getInt("min", 1000);
+    const long MAX_SIZE = std::min(bench.getInt("max", 10000), 10000L); // maxSubsequenceDP uses fixed arrays
+    const long STEP_SIZE = bench.getInt("step", 3000);
+
+    for (long n = MIN_SIZE; n <= MAX_SIZE; n += STEP_SIZE) {
+        std::mt19937 gen = bench.rng(n);
+        std::uniform_int_distribution<int> dis(-5 * n, 5 * n);
+        std::vector<int> A(n);
+        for (auto &a : A)
+            a = dis(gen);
+        unsigned i, j;
+        bench.run("max_subsequence_dp", [&]() { maxSubsequenceDP(A.data(), n, i, j); }).param("n", n);
+        bench.run("max_subsequence_dc", [&]() { maxSubsequenceDC(A.data(), n, i, j); }).param("n", n);
+    }
+
+    unsigned int C[] = {1, 2, 5, 10, 20, 50, 100, 200};
+    unsigned int Stock[] = {100, 100, 100, 100, 100, 100, 100, 100};
+    unsigned int usedCoins[8];
+    for (unsigned T : {100, 500, 1000}) {
+        bench.run("change_making_unlimited_dp", [&]() { changeMakingUnlimitedDP(C, 8, T, usedCoins); })
+                .param("T", T);
+        bench.run("change_making_dp", [&]() { changeMakingDP(C, Stock, 8, T, usedCoins); }).param("T", T);
+    }
+
+    for (unsigned n : {10, 15, 20}) {
+        bench.run("partitions_recursive", [&]() { b_recursive(n); }).param("n", n);
+        bench.run("partitions_dynamic", [&]() { b_dynamic(n); }).param("n", n);
+    }
+
+    return bench.finish();
+}
@@ -0,0 +1,372 @@
+/*
+ * TP5_bench.cpp
+ * Strongly connected components of random graphs with --vertices vertices and --edges edges
+ * (default 1M and 10M): clusters of --cluster vertices, with most edges inside the clusters
+ * and the others to later clusters (so the clusters are the large components).
+ * Tarjan on the adjacency lists and on a CSR copy, forward-backward with 1, 2, 4, ...
+ * --threads threads, and the condensation.
+ * Dynamic topological order: --dag-edges random edges (most of them consistent with a hidden
+ * order, so that few close cycles) added one at a time to a DAG of --dag-vertices vertices,
+ * with DynamicTopologicalOrder and by sorting the whole graph again after each edge (only for
+ * the first --resort-edges edges). Reports the cost per edge.
+ * Reachability: index build time and --queries random queries, on random DAGs with 5 edges
+ * per vertex: --reach-small vertices (closure and labels, and one search per query as the
+ * baseline) and --reach-large vertices (labels).
+ * Betweenness centrality: on a power-law (preferential attachment) network of --bc-vertices
+ * people with 3 friends each (undirected), exact with 1, 2, 4, ... threads and sampled with
+ * 16, 64 and 256 pivots (with the share of the exact top 10 found and the mean relative
+ * error of the top 100); sampled with --bc-pivots pivots on one of --bc-large people.
+ * PageRank: power iterations (tolerance 1e-6) in double and float with 1, 2, 4, ... threads
+ * on a random graph generated on the fly with --pr-vertices vertices and --pr-degree edges
+ * per vertex (default 10M and 10, 100M edges), reporting iterations per second; personalized
+ * PageRank (--ppr-epsilon) from --ppr-queries random seeds on the network of --bc-large people.
+ * Triangles: on a power-law network of --tri-vertices people with --tri-degree friends each
+ * (half of them friends of friends, so that there are many triangles), oriented CSR counting with 1, 2, 4, ... threads, and the node iterator on the adjacency
+ * lists (marks the neighbours of each vertex, then scans the neighbours of each neighbour).
+ * Intersection of sorted lists (the inner loop of the triangle counting): --isect-pairs pairs
+ * of random lists of --isect-length elements (about 1/16 of them in both, as in the lists of
+ * neighbours of two adjacent vertices), merged one element at a time and four at a time with
+ * SSE2.
+ */
+
+#include "Graph.h"
+#include "GraphStatsReport.h"
+#include "ImplicitRandomGraph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+
+static void generateClusters(unsigned n, size_t m, unsigned cluster, std::mt19937 gen, Graph<unsigned> &g) {
+    for (unsigned v = 0; v < n; v++)
+        g.appendVertex(v);
+    std::uniform_int_distribution<unsigned> vertex(0, n - 1), inside(0, cluster - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (size_t i = 0; i < m; i++) {
+        unsigned u = vertex(gen);
+        unsigned base = u / cluster * cluster;
+        unsigned v = percent(gen) < 90 ? std::min(n - 1, base + inside(gen))
+                                       : std::uniform_int_distribution<unsigned>(std::min(n - 1, base + cluster), n - 1)(gen);
+        g.addEdgeById(u, v, 1);
+    }
+}
+
+/*
+ * Random edges that go forward in a hidden order, except for backPercent % of them.
+ */
+static std::vector<std::pair<unsigned, unsigned>> generateDagEdges(unsigned n, size_t m, std::mt19937 gen,
+                                                                   int backPercent) {
+    std::vector<unsigned> rank(n);
+    std::iota(rank.begin(), rank.end(), 0);
+    std::shuffle(rank.begin(), rank.end(), gen);
+    std::uniform_int_distribution<unsigned> vertex(0, n - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::vector<std::pair<unsigned, unsigned>> edges;
+    while (edges.size() < m) {
+        unsigned u = vertex(gen), v = vertex(gen);
+        if (u != v)
+            edges.emplace_back(rank[u] < rank[v] || percent(gen) < backPercent ? std::make_pair(u, v) : std::make_pair(v, u));
+    }
+    return edges;
+}
+
+/*
+ * Barabasi-Albert network: each new vertex links (both ways) to k distinct earlier vertices,
+ * chosen with probability proportional to their degree, so the degrees follow a power law.
+ * With triadPercent > 0, each link after the first one goes, with that probability, to a
+ * neighbour of the vertex linked before (Holme and Kim, 2002), which closes triangles.
+ */
+static void generatePowerLaw(unsigned n, unsigned k, std::mt19937 gen, Graph<unsigned> &g, int triadPercent = 0) {
+    for (unsigned v = 0; v < n; v++)
+        g.appendVertex(v);
+    std::vector<unsigned> endpoints;  // each vertex once per edge end, to sample by degree
+    std::vector<unsigned> chosen;
+    for (unsigned v = 0; v < n; v++) {
+        chosen.clear();
+        for (unsigned u = 0; u < v && u <= k && v <= k; u++)  // the first ones form a clique
+            chosen.push_back(u);
+        while (v > k && chosen.size() < k) {
+            if (triadPercent > 0 && !chosen.empty() && std::uniform_int_distribution<int>(0, 99)(gen) < triadPercent) {
+                const auto &adj = g.out(chosen.back());
+                unsigned u = g.target(adj[std::uniform_int_distribution<size_t>(0, adj.size() - 1)(gen)]);
+                if (std::find(chosen.begin(), chosen.end(), u) == chosen.end()) {
+                    chosen.push_back(u);
+                    continue;
+                }
+            }
+            unsigned u = endpoints[std::uniform_int_distribution<size_t>(0, endpoints.size() - 1)(gen)];
+            if (std::find(chosen.begin(), chosen.end(), u) == chosen.end())
+                chosen.push_back(u);
+        }
+        for (unsigned u : chosen) {
+            g.addEdgeById(u, v, 1);
+            g.addEdgeById(v, u, 1);
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+}
+
+static std::vector<unsigned> topVertices(const std::vector<double> &score, unsigned k) {
+    std::vector<unsigned> order(score.size());
+    std::iota(order.begin(), order.end(), 0);
+    k = std::min<unsigned>(k, order.size());
+    std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                      [&](unsigned a, unsigned b) { return score[a] > score[b]; });
+    order.resize(k);
+    return order;
+}
+
+static void benchBetweenness(Benchmark &bench, unsigned n, unsigned maxThreads, std::mt19937 gen) {
+    Graph<unsigned> g;
+    generatePowerLaw(n, 3, gen, g);
+    std::vector<double> exact;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        bench.run("betweenness_exact", [&]() { exact = cal::betweenness(g, 0, 0, pool); })
+                .param("n", n).param("threads", threads);
+    }
+    if (!bench.enabled("betweenness_sampled"))
+        return;
+    if (exact.empty())
+        exact = cal::betweenness(g);
+    std::vector<unsigned> top10 = topVertices(exact, 10), top100 = topVertices(exact, 100);
+    for (unsigned pivots : {16u, 64u, 256u}) {
+        std::vector<double> sampled;
+        BenchmarkResult &res = bench.run("betweenness_sampled", [&]() { sampled = cal::betweenness(g, pivots); })
+                .param("n", n).param("pivots", pivots);
+        if (sampled.empty())
+            continue;
+        std::vector<unsigned> found = topVertices(sampled, 10);
+        unsigned hits = 0;
+        for (unsigned v : top10)
+            hits += std::find(found.begin(), found.end(), v) != found.end();
+        double error = 0;
+        for (unsigned v : top100)
+            error += std::abs(sampled[v] - exact[v]) / std::max(exact[v], 1.0);
+        res.counter("top10_found", hits).counter("top100_mean_rel_error", error / top100.size());
+    }
+}
+
+template<class Real>
+static void benchPageRank(Benchmark &bench, const cal::PageRank &pr, const char *type, unsigned maxThreads) {
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        cal::PageRankResult<Real> result;
+        BenchmarkResult &res = bench.run("pagerank", [&]() { result = pr.run<Real>({}, pool); })
+                .param("edges", pr.getNumEdges()).param("type", type).param("threads", threads)
+                .counter("iterations", result.iterations);
+        if (bench.enabled("pagerank"))
+            res.counter("iterations_per_sec", result.iterations / res.median())
+                    .counter("edges_per_sec", result.iterations * (double) pr.getNumEdges() / res.median());
+    }
+}
+
+static void benchTriangles(Benchmark &bench, unsigned n, unsigned degree, unsigned maxThreads, std::mt19937 gen) {
+    Graph<unsigned> g;
+    generatePowerLaw(n, degree, gen, g, 50);
+    uint64_t naive = 0;
+    bench.run("triangles_node_iterator", [&]() {
+        naive = 0;
+        std::vector<unsigned> mark(n, n);
+        for (unsigned u = 0; u < n; u++) {
+            for (const auto &e : g.out(u))
+                mark[g.target(e)] = u;
+            for (const auto &e : g.out(u)) {
+                unsigned v = g.target(e);
+                if (v > u)
+                    for (const auto &f : g.out(v)) {
+                        unsigned w = g.target(f);
+                        naive += w > v && mark[w] == u;
+                    }
+            }
+        }
+    }).param("n", n).param("degree", degree).counter("triangles", naive);
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        cal::Triangles t;
+        bench.run("triangles", [&]() { t = cal::countTriangles(g, pool); })
+                .param("n", n).param("degree", degree).param("threads", threads)
+                .counter("triangles", t.total).counter("average_clustering", t.averageClustering());
+    }
+}
+
+static void benchIntersect(Benchmark &bench, size_t pairs, unsigned length, std::mt19937 gen) {
+    std::vector<unsigned> lists(2 * pairs * length);
+    std::uniform_int_distribution<unsigned> value(0, 16 * length - 1);
+    for (size_t l = 0; l < 2 * pairs; l++) {
+        auto begin = lists.begin() + l * length, end = begin + length;
+        std::vector<bool> used(16 * length, false);
+        for (auto it = begin; it != end; ++it) {
+            unsigned x;
+            do {
+                x = value(gen);
+            } while (used[x]);
+            used[x] = true;
+            *it = x;
+        }
+        std::sort(begin, end);
+    }
+    auto run = [&](const std::string &method, auto merge) {
+        uint64_t common = 0;
+        BenchmarkResult &res = bench.run("intersect_merge", [&]() {
+            common = 0;
+            for (size_t p = 0; p < pairs; p++) {
+                const unsigned *a = lists.data() + 2 * p * length;
+                merge(a, length, a + length, length, [&](unsigned) { common++; });
+            }
+        }).param("length", length).param("method", method).counter("common", common);
+        if (bench.enabled("intersect_merge"))
+            res.counter("elements_per_sec", 2.0 * pairs * length / res.median());
+    };
+    run("scalar", [](const unsigned *a, size_t na, const unsigned *b, size_t nb, auto found) {
+        cal::detail::mergeSorted(a, na, b, nb, found);
+    });
+#ifdef __SSE2__
+    run("sse2", [](const unsigned *a, size_t na, const unsigned *b, size_t nb, auto found) {
+        cal::detail::mergeSortedSse2(a, na, b, nb, found);
+    });
+#endif
+}
+
+static void benchDynamicOrder(Benchmark &bench, unsigned n, const std::vector<std::pair<unsigned, unsigned>> &edges,
+                              size_t m) {
+    size_t accepted = 0;
+    BenchmarkResult &res = runCounted(bench, "dynamic_topsort", [&]() {
+        cal::DynamicTopologicalOrder order(n);
+        accepted = 0;
+        for (size_t i = 0; i < m; i++)
+            accepted += order.addEdge(edges[i].first, edges[i].second);
+    }).param("edges", m).counter("accepted", accepted);
+    if (bench.enabled("dynamic_topsort"))
+        res.counter("us_per_edge", res.median() * 1e6 / m);
+}
+
+static void benchReachability(Benchmark &bench, unsigned n, size_t queries, bool small, std::mt19937 gen) {
+    Graph<unsigned> dag;
+    for (unsigned v = 0; v < n; v++)
+        dag.appendVertex(v);
+    for (const auto &e : generateDagEdges(n, 5 * (size_t) n, gen, 0))
+        dag.addEdgeById(e.first, e.second, 1);
+    std::uniform_int_distribution<unsigned> vertex(0, n - 1);
+    std::vector<std::pair<unsigned, unsigned>> pairs(queries);
+    for (auto &p : pairs)
+        p = {vertex(gen), vertex(gen)};
+
+    using Mode = cal::ReachabilityIndex::Mode;
+    std::vector<std::pair<Mode, const char *>> modes{{Mode::Labels, "labels"}};
+    if (small)
+        modes.insert(modes.begin(), {Mode::Closure, "closure"});
+    for (const auto &mode : modes) {
+        std::unique_ptr<cal::ReachabilityIndex> index;
+        bench.run("reach_build", [&]() { index.reset(new cal::ReachabilityIndex(dag, mode.first)); })
+                .param("n", n).param("mode", mode.second).counter("bytes", index ? index->memoryBytes() : 0);
+        size_t reachable = 0;
+        BenchmarkResult &res = runCounted(bench, "reach_queries", [&]() {
+            reachable = 0;
+            for (const auto &p : pairs)
+                reachable += index->reaches(p.first, p.second);
+        }).param("n", n).param("mode", mode.second).counter("queries", queries).counter("reachable", reachable);
+        if (bench.enabled("reach_queries") && bench.enabled("reach_build"))
+            res.counter("queries_per_sec", queries / res.median());
+    }
+    if (small) {
+        const size_t searches = std::min<size_t>(queries, 1000);
+        SearchContext ctx;
+        BenchmarkResult &res = bench.run("reach_bfs_per_query", [&]() {
+            for (size_t q = 0; q < searches; q++)
+                dag.bfs(pairs[q].first, ctx);
+        }).param("n", n).counter("queries", searches);
+        if (bench.enabled("reach_bfs_per_query"))
+            res.counter("queries_per_sec", searches / res.median());
+    }
+}
+
+int main(int argc, char **argv) {
+    Benchmark bench("TP5", argc, argv);
+    const unsigned VERTICES = bench.getInt("vertices", 1000000);
+    const size_t EDGES = bench.getInt("edges", 10000000);
+    const unsigned CLUSTER = bench.getInt("cluster", 1000);
+    const unsigned MAX_THREADS = bench.getInt("threads", 8);
+
+    Graph<unsigned> g;
+    generateClusters(VERTICES, EDGES, CLUSTER, bench.rng(), g);
+    const cal::Graph<unsigned, cal::Weight<>, cal::Directed, cal::Csr> csr(g);
+
+    cal::Components scc;
+    bench.run("tarjan_scc", [&]() { scc = cal::tarjanScc(g); }).param("edges", EDGES).counter("components", scc.count);
+    bench.run("tarjan_scc_csr", [&]() { scc = cal::tarjanScc(csr); }).param("edges", EDGES);
+    for (unsigned threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        ThreadPool pool(threads);
+        cal::Components parallel;
+        bench.run("parallel_scc", [&]() { parallel = cal::parallelScc(csr, pool); })
+                .param("edges", EDGES).param("threads", threads).counter("components", parallel.count);
+    }
+    bench.run("condensation", [&]() { cal::condensation(csr, scc); }).param("edges", EDGES);
+
+    const unsigned DAG_VERTICES = bench.getInt("dag-vertices", 10000);
+    const size_t DAG_EDGES = bench.getInt("dag-edges", 100000);
+    const size_t RESORT_EDGES = std::min<size_t>(DAG_EDGES, bench.getInt("resort-edges", 5000));
+    auto dagEdges = generateDagEdges(DAG_VERTICES, DAG_EDGES, bench.rng(1), 5);
+    benchDynamicOrder(bench, DAG_VERTICES, dagEdges, RESORT_EDGES);
+    benchDynamicOrder(bench, DAG_VERTICES, dagEdges, DAG_EDGES);
+    size_t accepted = 0;
+    BenchmarkResult &resort = bench.run("topsort_after_each_edge", [&]() {
+        Graph<unsigned> dag;
+        for (unsigned v = 0; v < DAG_VERTICES; v++)
+            dag.appendVertex(v);
+        SearchContext ctx;
+        accepted = RESORT_EDGES;
+        for (size_t i = 0; i < RESORT_EDGES; i++) {
+            dag.addEdgeById(dagEdges[i].first, dagEdges[i].second, 1);
+            if (cal::topologicalOrder(dag, ctx).empty()) {
+                dag.removeEdge(dagEdges[i].first, dagEdges[i].second);
+                accepted--;
+            }
+        }
+    }).param("edges", RESORT_EDGES).counter("accepted", accepted);
+    if (bench.enabled("topsort_after_each_edge"))
+        resort.counter("us_per_edge", resort.median() * 1e6 / RESORT_EDGES);
+
+    const size_t QUERIES = bench.getInt("queries", 1000000);
+    benchReachability(bench, bench.getInt("reach-small", 10000), QUERIES, true, bench.rng(2));
+    benchReachability(bench, bench.getInt("reach-large", 1000000), QUERIES, false, bench.rng(3));
+
+    benchBetweenness(bench, bench.getInt("bc-vertices", 10000), MAX_THREADS, bench.rng(4));
+    const unsigned BC_LARGE = bench.getInt("bc-large", 1000000);
+    const unsigned BC_PIVOTS = bench.getInt("bc-pivots", 64);
+    Graph<unsigned> people;
+    generatePowerLaw(BC_LARGE, 3, bench.rng(5), people);
+    bench.run("betweenness_sampled", [&]() { cal::betweenness(people, BC_PIVOTS); })
+            .param("n", BC_LARGE).param("pivots", BC_PIVOTS);
+
+    const size_t PPR_QUERIES = bench.getInt("ppr-queries", 100);
+    const double PPR_EPSILON = bench.getDouble("ppr-epsilon", 1e-6);
+    std::vector<unsigned> seeds(PPR_QUERIES);
+    std::mt19937 gen = bench.rng(6);
+    for (unsigned &s : seeds)
+        s = std::uniform_int_distribution<unsigned>(0, BC_LARGE - 1)(gen);
+    size_t touched = 0;
+    BenchmarkResult &ppr = runCounted(bench, "personalized_pagerank", [&]() {
+        touched = 0;
+        for (unsigned s : seeds)
+            touched += cal::personalizedPageRank(people, s, 0.85, PPR_EPSILON).size();
+    }).param("n", BC_LARGE).counter("epsilon", PPR_EPSILON).counter("queries", PPR_QUERIES)
+            .counter("vertices_per_query", touched / PPR_QUERIES);
+    if (bench.enabled("personalized_pagerank"))
+        ppr.counter("queries_per_sec", PPR_QUERIES / ppr.median());
+
+    if (bench.enabled("pagerank")) {
+        const ImplicitRandomGraph web(bench.getInt("pr-vertices", 10000000), bench.getInt("pr-degree", 10),
+                                      bench.getSeed());
+        const cal::PageRank pr(web);
+        benchPageRank<double>(bench, pr, "double", MAX_THREADS);
+        benchPageRank<float>(bench, pr, "float", MAX_THREADS);
+    }
+
+    benchTriangles(bench, bench.getInt("tri-vertices", 1000000), bench.getInt("tri-degree", 8), MAX_THREADS,
+                   bench.rng(7));
+    benchIntersect(bench, bench.getInt("isect-pairs", 100000), bench.getInt("isect-length", 64), bench.rng(8));
+    return bench.finish();
+}
@@ -0,0 +1,350 @@
+/*
+ * TP6_bench.cpp
+ * Shortest paths on n x n grids (edges to the 4 neighbours, random weights in [1, n]).
+ * Sizes: --min, --max, --step (grid side), --bf-max and --fw-max (largest side for
+ * Bellman-Ford and Floyd-Warshall).
+ * Storage: Dijkstra on the adjacency lists and on a CSR copy of the graph.
+ * Weight types: memory of both storages and CSR Dijkstra time with double, float, uint32_t
+ * and Fixed<8> weights (the same integer weights in every type).
+ * Query throughput: --queries point-to-point Dijkstra queries on the same (const) graph,
+ * split among 1, 2, 4, ... --threads threads, each one with its own SearchContext.
+ * Updates: the same queries on VersionedGraph snapshots, alone and while another thread
+ * keeps committing edge weight changes (reports the query latency percentiles).
+ * Alternative routes: k shortest paths (k = 1 .. --k-max) between --k-queries random pairs of
+ * connected vertices of the road map in --map (default map2 of TP7_graphviewer, relative to
+ * the build directory; "none" to skip it), reusing the shortest path tree to the target in
+ * the spur searches and (up to k = --k-dijkstra-max, as it is much slower) with one Dijkstra
+ * search per spur vertex.
+ * Isochrones: vertices within 500, 2000 and 8000 m of --iso-queries random vertices of the
+ * road map, with the bounded Dijkstra search and with a full search per query (only
+ * --iso-full-queries of them); reports the vertices reached and the latency per query.
+ * Delivery tours: --tsp-map-stops (and a quarter of them) connected random stops of the road
+ * map, with the shortest path distances between them (one Dijkstra search per stop, on a CSR
+ * copy of the map), and --tsp-points (and a tenth and a hundredth of them) random points of
+ * the unit square, with their Euclidean distances (tour costs compared with the 0.7124
+ * sqrt(n) estimate of Beardwood, Halton and Hammersley). Each construction alone and with the
+ * local search, then --tsp-restarts chains of perturbations on 1, 2, 4, ... --threads threads.
+ */
+
+#include "Graph.h"
+#include "VersionedGraph.h"
+#include "GraphStatsReport.h"
+#include "graph/RoadMap.h"
+#include "graph/Tsp.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+static void generateGrid(int n, std::mt19937 gen, Graph<std::pair<int, int>> &g) {
+    std::uniform_int_distribution<int> dis(1, n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            g.addVertex(std::make_pair(i, j));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            for (int di = -1; di <= 1; di++)
+                for (int dj = -1; dj <= 1; dj++)
+                    if ((di != 0) != (dj != 0) && i + di >= 0 && i + di < n && j + dj >= 0 && j + dj < n)
+                        g.addEdge(std::make_pair(i, j), std::make_pair(i + di, j + dj), dis(gen));
+}
+
+/*
+ * Copy of the grid with weights of type W (and vertex ids as contents).
+ */
+template<class W>
+static void benchWeightType(Benchmark &bench, const Graph<std::pair<int, int>> &g, int n, const char *type) {
+    cal::Graph<unsigned, cal::Weight<W>> typed;
+    for (int v = 0; v < g.getNumVertex(); v++)
+        typed.addVertex(v);
+    for (auto v : g.getVertexSet())
+        for (auto e : v->getAdj())
+            typed.addEdge(v->getId(), e->getDest()->getId(), W(e->getWeight()));
+    const cal::Graph<unsigned, cal::Weight<W>, cal::Directed, cal::Csr> csr(typed);
+    cal::DistContext<W> ctx;
+    const unsigned source = g.getNumVertex() / 2;
+    runCounted(bench, "dijkstra_weight_type", [&]() { cal::dijkstra(csr, source, ctx); })
+            .param("n", n).param("type", type)
+            .counter("adjacency_bytes", typed.memoryBytes())
+            .counter("csr_bytes", csr.memoryBytes());
+}
+
+using RoadMap = cal::Graph<long long, cal::Weight<>, cal::Undirected>;
+
+static void benchKShortestPaths(Benchmark &bench, const RoadMap &map, unsigned maxK, unsigned maxDijkstraK,
+                                unsigned numQueries) {
+    std::vector<std::pair<unsigned, unsigned>> queries;
+    std::mt19937 gen = bench.rng(1);
+    std::uniform_int_distribution<unsigned> vertex(0, map.getNumVertex() - 1);
+    SearchContext ctx;
+    while (queries.size() < numQueries) {
+        unsigned s = vertex(gen), t = vertex(gen);
+        cal::dijkstra(map, s, ctx);
+        if (s != t && ctx.get(t).dist != SearchContext::INFINITE_DIST)
+            queries.emplace_back(s, t);
+    }
+    cal::KShortestPaths<RoadMap> k(map);
+    for (unsigned numPaths = 1; numPaths <= maxK; numPaths++)
+        for (bool reuseTree : {true, false}) {
+            if (!reuseTree && numPaths > maxDijkstraK)
+                continue;
+            size_t found = 0;
+            BenchmarkResult &res = runCounted(bench, "k_shortest_paths", [&]() {
+                found = 0;
+                for (const auto &q : queries)
+                    found += k.find(q.first, q.second, numPaths, reuseTree).size();
+            }).param("k", numPaths).param("spur", reuseTree ? "tree" : "dijkstra")
+                    .counter("queries", numQueries).counter("paths", found);
+            if (bench.enabled("k_shortest_paths"))
+                res.counter("ms_per_query", res.median() * 1e3 / numQueries);
+        }
+}
+
+static void benchIsochrones(Benchmark &bench, const RoadMap &map, unsigned numQueries, unsigned fullQueries) {
+    std::vector<unsigned> sources(numQueries);
+    std::mt19937 gen = bench.rng(2);
+    std::uniform_int_distribution<unsigned> vertex(0, map.getNumVertex() - 1);
+    for (unsigned &s : sources)
+        s = vertex(gen);
+    fullQueries = std::min(fullQueries, numQueries);
+    SearchContext ctx;
+    for (double radius : {500.0, 2000.0, 8000.0}) {
+        size_t reached = 0;
+        BenchmarkResult &res = runCounted(bench, "isochrone", [&]() {
+            reached = 0;
+            for (unsigned s : sources)
+                reached += cal::dijkstraWithin(map, s, radius, ctx).size();
+        }).param("radius", radius).counter("queries", numQueries).counter("reached_per_query", reached / numQueries);
+        if (bench.enabled("isochrone"))
+            res.counter("us_per_query", res.median() * 1e6 / numQueries);
+        BenchmarkResult &full = runCounted(bench, "isochrone_full_dijkstra", [&]() {
+            reached = 0;
+            for (unsigned q = 0; q < fullQueries; q++) {
+                cal::dijkstra(map, sources[q], ctx);
+                for (unsigned v = 0; v < (unsigned) map.getNumVertex(); v++)
+                    reached += ctx.get(v).dist <= radius;
+            }
+        }).param("radius", radius).counter("queries", fullQueries);
+        if (bench.enabled("isochrone_full_dijkstra"))
+            full.counter("us_per_query", full.median() * 1e6 / fullQueries);
+    }
+}
+
+/*
+ * Tours through the stops of the cost matrix; reports their costs (and the ratio to the
+ * estimate, if given).
+ */
+static void benchTspInstance(Benchmark &bench, const std::vector<double> &costs, const char *instance,
+                             double estimate, unsigned restarts, unsigned maxThreads) {
+    const long stops = std::lround(std::sqrt((double) costs.size()));
+    std::unique_ptr<cal::TspSolver> solver;
+    bench.run("tsp_neighbour_lists", [&]() { solver.reset(new cal::TspSolver(costs)); })
+            .param("instance", instance).param("stops", stops);
+    if (!solver)
+        solver.reset(new cal::TspSolver(costs));
+    auto quality = [&](BenchmarkResult &res, double cost) {
+        res.param("instance", instance).param("stops", stops).counter("cost", cost);
+        if (estimate > 0)
+            res.counter("cost_vs_estimate", cost / estimate);
+    };
+    const std::pair<cal::TspConstruction, const char *> constructions[] = {
+            {cal::TspConstruction::NearestNeighbour, "nearest_neighbour"},
+            {cal::TspConstruction::GreedyEdge, "greedy_edge"}};
+    for (const auto &construction : constructions) {
+        std::vector<unsigned> tour;
+        BenchmarkResult &res = bench.run("tsp_construct", [&]() { tour = solver->construct(construction.first); })
+                .param("construction", construction.second);
+        quality(res, solver->tourCost(tour));
+        BenchmarkResult &improved = bench.run("tsp_local_search", [&]() {
+            tour = solver->construct(construction.first);
+            solver->improve(tour);
+        }).param("construction", construction.second);
+        quality(improved, solver->tourCost(tour));
+    }
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        cal::TspOptions options;
+        options.restarts = restarts;
+        options.seed = bench.getSeed();
+        cal::TspTour tour;
+        BenchmarkResult &res = bench.run("tsp_restarts", [&]() { tour = solver->solve(options, pool); })
+                .param("restarts", restarts).param("threads", threads);
+        quality(res, tour.cost);
+    }
+}
+
+static void benchTspMap(Benchmark &bench, const RoadMap &map, unsigned maxStops, unsigned restarts,
+                        unsigned maxThreads) {
+    // Stops reachable from a random vertex (the map may not be connected)
+    std::mt19937 gen = bench.rng(3);
+    std::vector<unsigned> reachable;
+    SearchContext ctx;
+    while (reachable.size() < (size_t) map.getNumVertex() / 2) {
+        cal::dijkstra(map, std::uniform_int_distribution<unsigned>(0, map.getNumVertex() - 1)(gen), ctx);
+        reachable.clear();
+        for (unsigned v = 0; v < (unsigned) map.getNumVertex(); v++)
+            if (ctx.get(v).dist != SearchContext::INFINITE_DIST)
+                reachable.push_back(v);
+    }
+    std::shuffle(reachable.begin(), reachable.end(), gen);
+    const cal::Graph<long long, cal::Weight<>, cal::Undirected, cal::Csr> csr(map);
+    for (unsigned numStops : {std::max(maxStops / 4, 2u), maxStops}) {
+        std::vector<unsigned> stops(reachable.begin(), reachable.begin() + std::min<size_t>(numStops, reachable.size()));
+        std::vector<double> costs;
+        bench.run("tsp_distance_matrix", [&]() { costs = cal::distanceMatrix(csr, stops); })
+                .param("stops", (long) stops.size());
+        if (costs.empty())
+            costs = cal::distanceMatrix(csr, stops);
+        benchTspInstance(bench, costs, "map", 0, restarts, maxThreads);
+    }
+}
+
+static void benchTspPoints(Benchmark &bench, unsigned maxPoints, unsigned restarts, unsigned maxThreads) {
+    std::mt19937 gen = bench.rng(4);
+    for (unsigned numPoints : {std::max(maxPoints / 100, 2u), std::max(maxPoints / 10, 2u), maxPoints}) {
+        std::uniform_real_distribution<double> coordinate(0, 1);
+        std::vector<std::pair<double, double>> points(numPoints);
+        for (auto &p : points)
+            p = {coordinate(gen), coordinate(gen)};
+        std::vector<double> costs((size_t) numPoints * numPoints);
+        for (unsigned i = 0; i < numPoints; i++)
+            for (unsigned j = 0; j < numPoints; j++)
+                costs[(size_t) i * numPoints + j] = std::hypot(points[i].first - points[j].first,
+                                                               points[i].second - points[j].second);
+        benchTspInstance(bench, costs, "random_points", 0.7124 * std::sqrt((double) numPoints), restarts, maxThreads);
+    }
+}
+
+int main(int argc, char **argv) {
+    Benchmark bench("TP6", argc, argv);
+    const int MIN_SIZE = bench.getInt("min", 10);
+    const int MAX_SIZE = bench.getInt("max", 50);
+    const int STEP_SIZE = bench.getInt("step", 20);
+    const int BF_MAX_SIZE = bench.getInt("bf-max", 30);
+    const int FW_MAX_SIZE = bench.getInt("fw-max", 20);
+    const int QUERIES = bench.getInt("queries", 256);
+    const int MAX_THREADS = bench.getInt("threads", 8);
+
+    for (int n = MIN_SIZE; n <= MAX_SIZE; n += STEP_SIZE) {
+        Graph<std::pair<int, int>> g;
+        generateGrid(n, bench.rng(n), g);
+        const auto source = std::make_pair(n / 2, n / 2);
+
+        runCounted(bench, "unweighted_sssp", [&]() { g.unweightedShortestPath(source); }).param("n", n);
+        runCounted(bench, "dijkstra", [&]() { g.dijkstraShortestPath(source); }).param("n", n);
+        runCounted(bench, "dijkstra_all_sources", [&]() {
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < n; j++)
+                    g.dijkstraShortestPath(std::make_pair(i, j));
+        }).param("n", n).counter("sources", n * n);
+        {
+            const cal::Graph<std::pair<int, int>, cal::Weight<>, cal::Directed, cal::Csr> csr(g);
+            const unsigned s = g.findVertexId(source);
+            SearchContext ctx;
+            runCounted(bench, "dijkstra_csr", [&]() { cal::dijkstra(csr, s, ctx); }).param("n", n);
+        }
+        benchWeightType<double>(bench, g, n, "double");
+        benchWeightType<float>(bench, g, n, "float");
+        benchWeightType<uint32_t>(bench, g, n, "uint32");
+        benchWeightType<cal::Fixed<8>>(bench, g, n, "fixed8");
+        if (n <= BF_MAX_SIZE)
+            runCounted(bench, "bellman_ford", [&]() { g.bellmanFordShortestPath(source); }).param("n", n);
+        if (n <= FW_MAX_SIZE)
+            bench.run("floyd_warshall", [&]() { g.floydWarshallShortestPath(); }).param("n", n);
+
+        std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> queries;
+        std::mt19937 gen = bench.rng(n + 1);
+        std::uniform_int_distribution<int> coord(0, n - 1);
+        for (int q = 0; q < QUERIES; q++)
+            queries.push_back({{coord(gen), coord(gen)}, {coord(gen), coord(gen)}});
+        const Graph<std::pair<int, int>> &cg = g;
+        for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+            bench.run("dijkstra_queries", [&]() {
+                std::vector<std::thread> workers;
+                for (int t = 0; t < threads; t++)
+                    workers.emplace_back([&, t]() {
+                        SearchContext ctx;
+                        for (size_t q = t; q < queries.size(); q += threads) {
+                            cg.dijkstraShortestPath(queries[q].first, ctx);
+                            cg.getDist(queries[q].second, ctx);
+                        }
+                    });
+                for (auto &w : workers)
+                    w.join();
+            }).param("n", n).param("threads", threads).counter("queries", QUERIES);
+        }
+
+        VersionedGraph<std::pair<int, int>> vg;
+        VersionedGraph<std::pair<int, int>>::Delta grid;
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                grid.addVertex(std::make_pair(i, j));
+        std::uniform_int_distribution<int> weight(1, n);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j + 1 < n; j++) {
+                grid.addEdge(std::make_pair(i, j), std::make_pair(i, j + 1), weight(gen));
+                grid.addEdge(std::make_pair(j, i), std::make_pair(j + 1, i), weight(gen));
+            }
+        vg.commit(grid);
+        for (bool updates : {false, true}) {
+            std::vector<double> latencies;
+            std::atomic<long> commits(0);
+            BenchmarkResult &res = bench.run("queries_during_updates", [&]() {
+                // Counters of the last run only, the one the latencies come from
+                latencies.clear();
+                commits = 0;
+                std::atomic<bool> stop(false);
+                std::thread writer;
+                if (updates)
+                    writer = std::thread([&]() {
+                        std::mt19937 wgen(n);
+                        while (!stop) {
+                            // "Road closure": a random horizontal edge gets a new weight
+                            int i = coord(wgen), j = std::min(coord(wgen), n - 2);
+                            VersionedGraph<std::pair<int, int>>::Delta d;
+                            d.removeEdge(std::make_pair(i, j), std::make_pair(i, j + 1));
+                            d.addEdge(std::make_pair(i, j), std::make_pair(i, j + 1), weight(wgen));
+                            vg.commit(d);
+                            commits++;
+                        }
+                    });
+                SearchContext ctx;
+                for (const auto &q : queries) {
+                    auto start = std::chrono::steady_clock::now();
+                    auto snapshot = vg.snapshot();
+                    snapshot->dijkstraShortestPath(q.first, ctx);
+                    snapshot->getDist(q.second, ctx);
+                    latencies.push_back(std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - start).count());
+                }
+                stop = true;
+                if (writer.joinable())
+                    writer.join();
+            }).param("n", n).param("updates", updates ? "on" : "off").counter("queries", QUERIES);
+            if (!latencies.empty()) {
+                std::sort(latencies.begin(), latencies.end());
+                res.counter("query_p50_us", latencies[latencies.size() / 2]);
+                res.counter("query_p99_us", latencies[latencies.size() * 99 / 100]);
+                res.counter("commits", commits);
+            }
+        }
+    }
+
+    const unsigned TSP_RESTARTS = bench.getInt("tsp-restarts", 4);
+    benchTspPoints(bench, bench.getInt("tsp-points", 5000), TSP_RESTARTS, MAX_THREADS);
+
+    const std::string MAP = bench.getString("map", "../TP7_graphviewer/resources/map2");
+    RoadMap map;
+    std::vector<std::pair<double, double>> coordinates;
+    if (MAP != "none" && cal::readRoadMap(MAP, map, coordinates) && map.getNumVertex() > 1) {
+        benchKShortestPaths(bench, map, bench.getInt("k-max", 10), bench.getInt("k-dijkstra-max", 3),
+                            bench.getInt("k-queries", 20));
+        benchIsochrones(bench, map, bench.getInt("iso-queries", 1000), bench.getInt("iso-full-queries", 20));
+        benchTspMap(bench, map, bench.getInt("tsp-map-stops", 100), TSP_RESTARTS, MAX_THREADS);
+    } else if (MAP != "none") {
+        std::cout << "map " << MAP << " not found, skipping the road map cases" << std::endl;
+    }
+    return bench.finish();
+}
@@ -0,0 +1,181 @@
+/*
+ * TP7_bench.cpp
+ * Minimum spanning trees on n x n grids (undirected edges, random weights in [1, n]).
+ * Sizes: --min, --max, --step (grid side).
+ * Vertex order: BFS, Dijkstra, Prim and Kruskal on the road map in --map (default map2 of
+ * TP7_graphviewer, relative to the build directory; "none" to skip it), with the vertices
+ * in file order and renumbered in BFS, reverse Cuthill-McKee and Hilbert curve order.
+ * Connected components: union-find and Afforest (1, 2, 4, ... --threads threads) on the road
+ * map and on a random graph generated on the fly (ImplicitRandomGraph, no memory for the
+ * edges) with --implicit-vertices vertices and --implicit-degree edges per vertex.
+ * Snapping (road map): --snaps random points, near the roads and anywhere around the map, to the
+ * nearest vertex and to the nearest point of an edge with the spatial index (1, 2, 4, ... --threads threads), and
+ * --snap-scan of them by scanning every vertex, for comparison.
+ */
+
+#include "Graph.h"
+#include "GraphStatsReport.h"
+#include "ImplicitRandomGraph.h"
+#include "graph/RoadMap.h"
+#include "graph/ShortestPaths.h"
+#include "graph/SpatialIndex.h"
+#include "graph/Traversal.h"
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+static void generateGrid(int n, std::mt19937 gen, Graph<std::pair<int, int>> &g) {
+    std::uniform_int_distribution<int> dis(1, n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            g.addVertex(std::make_pair(i, j));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            if (i < n - 1)
+                g.addBidirectionalEdge(std::make_pair(i, j), std::make_pair(i + 1, j), dis(gen));
+            if (j < n - 1)
+                g.addBidirectionalEdge(std::make_pair(i, j), std::make_pair(i, j + 1), dis(gen));
+        }
+}
+
+using RoadMap = cal::Graph<long long, cal::Weight<>, cal::Undirected>;
+
+template<class G>
+static void benchComponents(Benchmark &bench, const G &g, const char *graph, unsigned maxThreads) {
+    cal::Components components;
+    bench.run("union_find_components", [&]() { components = cal::connectedComponents(g); })
+            .param("graph", graph).counter("components", components.count);
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        bench.run("afforest_components", [&]() { components = cal::parallelConnectedComponents(g, pool); })
+                .param("graph", graph).param("threads", threads).counter("components", components.count);
+    }
+}
+
+static void benchVertexOrder(Benchmark &bench, const RoadMap &map, long long source, const char *order) {
+    const cal::Graph<long long, cal::Weight<>, cal::Undirected, cal::Csr> csr(map);
+    const unsigned s = map.findVertexId(source);
+    SearchContext ctx;
+    bench.run("map_bfs", [&]() { cal::bfsOrder(csr, s, ctx); }).param("order", order);
+    runCounted(bench, "map_dijkstra", [&]() { cal::dijkstra(map, s, ctx); }).param("order", order);
+    runCounted(bench, "map_dijkstra_csr", [&]() { cal::dijkstra(csr, s, ctx); }).param("order", order);
+    runCounted(bench, "map_prim", [&]() { cal::prim(csr, s, ctx); }).param("order", order);
+    bench.run("map_kruskal", [&]() { cal::kruskal(csr, s, ctx); }).param("order", order);
+}
+
+/*
+ * Snaps numSnaps points: near the roads (up to about 100 m from a random vertex, like GPS
+ * positions) or anywhere in the rectangle around the map (far from it in the sea).
+ */
+static void benchSnapping(Benchmark &bench, const RoadMap &map, const std::vector<std::pair<double, double>> &coordinates,
+                          unsigned numSnaps, unsigned numScans, unsigned maxThreads) {
+    double minLat = 90, maxLat = -90, minLon = 180, maxLon = -180;
+    for (const auto &c : coordinates) {
+        minLat = std::min(minLat, c.first);
+        maxLat = std::max(maxLat, c.first);
+        minLon = std::min(minLon, c.second);
+        maxLon = std::max(maxLon, c.second);
+    }
+    std::mt19937 gen = bench.rng(numSnaps);
+    std::uniform_int_distribution<unsigned> vertex(0, coordinates.size() - 1);
+    std::uniform_real_distribution<double> offset(-0.001, 0.001), lat(minLat, maxLat), lon(minLon, maxLon);
+    std::vector<std::pair<double, double>> nearRoads(numSnaps), anywhere(numSnaps);
+    for (unsigned i = 0; i < numSnaps; i++) {
+        const auto &c = coordinates[vertex(gen)];
+        nearRoads[i] = {c.first + offset(gen), c.second + offset(gen)};
+        anywhere[i] = {lat(gen), lon(gen)};
+    }
+
+    std::unique_ptr<cal::SpatialIndex> index;
+    BenchmarkResult &build = bench.run("spatial_index_build", [&]() {
+        index.reset(new cal::SpatialIndex(map, coordinates));
+    });
+    if (!index)
+        index.reset(new cal::SpatialIndex(map, coordinates));
+    build.counter("memory_mb", index->memoryBytes() / 1e6);
+    const std::pair<const std::vector<std::pair<double, double>> *, const char *> workloads[] = {
+            {&nearRoads, "near_roads"}, {&anywhere, "anywhere"}};
+    for (const auto &workload : workloads)
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            const std::vector<std::pair<double, double>> &points = *workload.first;
+            ThreadPool pool(threads);
+            std::vector<int> vertices;
+            BenchmarkResult &res = bench.run("snap_vertices", [&]() { vertices = index->nearestVertices(points, pool); })
+                    .param("points", workload.second).param("threads", threads);
+            if (bench.enabled("snap_vertices"))
+                res.counter("snaps_per_sec", numSnaps / res.median());
+            std::vector<cal::SpatialIndex::EdgeSnap> edges;
+            BenchmarkResult &onEdges = bench.run("snap_edges", [&]() { edges = index->nearestEdges(points, pool); })
+                    .param("points", workload.second).param("threads", threads);
+            if (bench.enabled("snap_edges"))
+                onEdges.counter("snaps_per_sec", numSnaps / onEdges.median());
+        }
+
+    const std::vector<std::pair<double, double>> &points = nearRoads;
+    numScans = std::min(numScans, numSnaps);
+    std::vector<int> scanned(numScans);
+    BenchmarkResult &scan = bench.run("snap_vertices_scan", [&]() {
+        for (unsigned i = 0; i < numScans; i++) {
+            double best = std::numeric_limits<double>::infinity();
+            for (unsigned v = 0; v < coordinates.size(); v++) {
+                double d = cal::haversine(points[i].first, points[i].second, coordinates[v].first, coordinates[v].second);
+                if (d < best) {
+                    best = d;
+                    scanned[i] = v;
+                }
+            }
+        }
+    });
+    unsigned same = 0;
+    for (unsigned i = 0; i < numScans; i++)
+        same += scanned[i] == index->nearestVertex(points[i].first, points[i].second);
+    scan.counter("same_as_index", same);
+    if (bench.enabled("snap_vertices_scan"))
+        scan.counter("snaps_per_sec", numScans / scan.median());
+}
+
+int main(int argc, char **argv) {
+    Benchmark bench("TP7", argc, argv);
+    const int MIN_SIZE = bench.getInt("min", 10);
+    const int MAX_SIZE = bench.getInt("max", 70);
+    const int STEP_SIZE = bench.getInt("step", 20);
+    const unsigned MAX_THREADS = bench.getInt("threads", 4);
+
+    for (int n = MIN_SIZE; n <= MAX_SIZE; n += STEP_SIZE) {
+        Graph<std::pair<int, int>> g;
+        generateGrid(n, bench.rng(n), g);
+        runCounted(bench, "prim", [&]() { g.calculatePrim(); }).param("n", n);
+        bench.run("kruskal", [&]() { g.calculateKruskal(); }).param("n", n);
+    }
+
+    const std::string MAP = bench.getString("map", "../TP7_graphviewer/resources/map2");
+    RoadMap map;
+    std::vector<std::pair<double, double>> coordinates;
+    if (MAP != "none" && cal::readRoadMap(MAP, map, coordinates) && map.getNumVertex() > 0) {
+        const long long source = map.getInfo(0);
+        benchVertexOrder(bench, map, source, "file");
+        const std::pair<cal::VertexOrder, const char *> orders[] = {
+                {cal::VertexOrder::Bfs, "bfs"},
+                {cal::VertexOrder::ReverseCuthillMcKee, "rcm"},
+                {cal::VertexOrder::Hilbert, "hilbert"}};
+        for (const auto &order : orders) {
+            RoadMap reordered(map);
+            reordered.reorder(order.first, coordinates);
+            benchVertexOrder(bench, reordered, source, order.second);
+        }
+        benchComponents(bench, map, "map", MAX_THREADS);
+        benchSnapping(bench, map, coordinates, bench.getInt("snaps", 1000000), bench.getInt("snap-scan", 100),
+                      MAX_THREADS);
+    } else if (MAP != "none") {
+        std::cout << "map " << MAP << " not found, skipping the vertex order cases" << std::endl;
+    }
+
+    const unsigned IMPLICIT_VERTICES = bench.getInt("implicit-vertices", 10000000);
+    const unsigned IMPLICIT_DEGREE = bench.getInt("implicit-degree", 10);
+    const ImplicitRandomGraph implicit(IMPLICIT_VERTICES, IMPLICIT_DEGREE, bench.getSeed());
+    std::string name = "implicit_" + std::to_string((uint64_t) IMPLICIT_VERTICES * IMPLICIT_DEGREE) + "_edges";
+    benchComponents(bench, implicit, name.c_str(), MAX_THREADS);
+    return bench.finish();
+}
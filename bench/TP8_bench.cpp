@@ -0,0 +1,297 @@
+/*
+ * TP8_bench.cpp
+ * Maximum flow (Edmonds-Karp) on n x n grids, from the top-left to the bottom-right corner
+ * (edges in both directions between neighbours, random capacities in [1, n]), and the
+ * extraction of the minimum cut from the residual graph afterwards.
+ * Sizes: --min, --max, --step (grid side).
+ * After --changes capacity changes to the grid (lower capacities on edges with flow, higher
+ * ones on edges of the minimum cut, or random ones), the maximum flow is found again from the
+ * previous one (updateCapacity and resolve) and from scratch.
+ *
+ * The same grids with the Boykov-Kolmogorov algorithm on an implicit grid network
+ * (graph/GridFlow.h), and image segmentation networks of --bk-min .. --bk-max pixels of
+ * side (x4 each time): terminal edges from a noisy synthetic image and edges between
+ * neighbours that are cheaper to cut across its edges; against Edmonds-Karp up to
+ * --bk-ek-max pixels of side.
+ *
+ * Network reliability: Gomory-Hu trees (minimum cuts between all pairs of vertices) of rings
+ * of --rel-min .. --rel-max vertices (x10 each time) with as many random links across them,
+ * of unit (links to cut) or random capacities, against one maximum flow per pair up to
+ * --rel-naive-max vertices.
+ */
+
+#include <cmath>
+#include <memory>
+#include "Graph.h"
+#include "graph/GridFlow.h"
+#include "GraphStatsReport.h"
+
+static void generateGrid(int n, std::mt19937 gen, Graph<int> &g) {
+    std::uniform_int_distribution<int> dis(1, n);
+    for (int v = 0; v < n * n; v++)
+        g.addVertex(v);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            if (i < n - 1) {
+                g.addEdge(i * n + j, (i + 1) * n + j, dis(gen));
+                g.addEdge((i + 1) * n + j, i * n + j, dis(gen));
+            }
+            if (j < n - 1) {
+                g.addEdge(i * n + j, i * n + j + 1, dis(gen));
+                g.addEdge(i * n + j + 1, i * n + j, dis(gen));
+            }
+        }
+}
+
+/*
+ * Ring of n vertices plus n random links, each link once in g (undirected capacity) and in
+ * both directions in symmetric (for the maximum flows between pairs).
+ */
+static void generateReliabilityNetwork(int n, bool unit, std::mt19937 gen, Graph<int> &g, Graph<int> &symmetric) {
+    std::uniform_int_distribution<int> vertex(0, n - 1), capacity(1, 10);
+    for (int v = 0; v < n; v++) {
+        g.addVertex(v);
+        symmetric.addVertex(v);
+    }
+    auto link = [&](int u, int v) {
+        int c = unit ? 1 : capacity(gen);
+        g.addEdge(u, v, c);
+        symmetric.addEdge(u, v, c);
+        symmetric.addEdge(v, u, c);
+    };
+    for (int v = 0; v < n; v++)
+        link(v, (v + 1) % n);
+    for (int i = 0; i < n; i++) {
+        int u = vertex(gen), v = vertex(gen);
+        if (u != v)
+            link(u, v);
+    }
+}
+
+static void benchReliability(Benchmark &bench, int n, bool unit, int naiveMax) {
+    Graph<int> g, symmetric;
+    generateReliabilityNetwork(n, unit, bench.rng(2 * n + unit), g, symmetric);
+    const char *capacities = unit ? "unit" : "random";
+    std::unique_ptr<cal::GomoryHuTree<double>> tree;
+    BenchmarkResult &res = runCounted(bench, "gomory_hu_tree", [&]() {
+        tree.reset(new cal::GomoryHuTree<double>(g));
+    }).param("capacities", capacities).param("n", n);
+    if (bench.enabled("gomory_hu_tree"))
+        res.counter("flows", n - 1).counter("global_min_cut", tree->globalMinCut());
+
+    std::vector<double> all;
+    if (tree != nullptr)
+        bench.run("gomory_hu_all_pairs", [&]() { all = tree->allPairs(); })
+                .param("capacities", capacities).param("n", n);
+    if (n > naiveMax)
+        return;
+    std::vector<double> naive((size_t) n * n, 0);
+    BenchmarkResult &baseline = runCounted(bench, "all_pairs_max_flow", [&]() {
+        for (int u = 0; u < n; u++)
+            for (int v = u + 1; v < n; v++)
+                naive[u * n + v] = naive[v * n + u] = cal::maxFlow(symmetric, u, v);
+    }).param("capacities", capacities).param("n", n);
+    if (bench.enabled("all_pairs_max_flow")) {
+        baseline.counter("flows", (double) n * (n - 1) / 2);
+        if (!all.empty()) {
+            long mismatches = 0;
+            for (int u = 0; u < n; u++)
+                for (int v = 0; v < n; v++)
+                    mismatches += u != v && naive[u * n + v] != all[u * n + v];
+            baseline.counter("mismatches", mismatches);
+        }
+    }
+}
+
+/*
+ * The grid g of generateGrid as a grid network, from the top-left to the bottom-right corner.
+ */
+static cal::GridFlowNetwork<int> toGridNetwork(int n, const Graph<int> &g) {
+    using Grid = cal::GridFlowNetwork<int>;
+    Grid grid(n, n);
+    for (auto v : g.getVertexSet())
+        for (auto e : v->getAdj()) {
+            int u = v->getInfo(), w = e->getDest()->getInfo();
+            Grid::Direction d = w == u + 1 ? Grid::RIGHT : w == u - 1 ? Grid::LEFT : w > u ? Grid::DOWN : Grid::UP;
+            grid.setCapacity(u, d, e->getCapacity());
+        }
+    grid.addTerminalCapacities(0, 4 * n, 0);
+    grid.addTerminalCapacities(n * n - 1, 0, 4 * n);
+    return grid;
+}
+
+/*
+ * Segmentation network of a side x side image: smooth blobs plus noise, pixels brighter than
+ * the middle gray prefer the source, and neighbours of similar intensity prefer the same side.
+ * With g, the same network as a graph (vertices side * side and side * side + 1: source, sink).
+ */
+static cal::GridFlowNetwork<int> createSegmentation(unsigned side, std::mt19937 gen, Graph<int> *g = nullptr) {
+    using Grid = cal::GridFlowNetwork<int>;
+    std::uniform_int_distribution<int> noise(-40, 40);
+    std::vector<int> image((size_t) side * side);
+    for (unsigned r = 0; r < side; r++)
+        for (unsigned c = 0; c < side; c++)
+            image[(size_t) r * side + c] = std::min(255, std::max(0, (int) (128 + 90 * std::sin(r / 37.0)
+                                                                              * std::cos(c / 53.0)) + noise(gen)));
+    Grid grid(side, side);
+    const int n = side * side;
+    if (g != nullptr)
+        for (int v = 0; v < n + 2; v++)
+            g->addVertex(v);
+    auto smoothness = [&](unsigned u, unsigned v) {
+        double d = image[u] - image[v];
+        return 1 + (int) (20 * std::exp(-d * d / 800));
+    };
+    for (unsigned v = 0; v < (unsigned) n; v++) {
+        int fromSource = std::max(0, image[v] - 128), toSink = std::max(0, 128 - image[v]);
+        grid.addTerminalCapacities(v, fromSource, toSink);
+        if (g != nullptr) {
+            g->addEdge(n, v, fromSource);
+            g->addEdge(v, n + 1, toSink);
+        }
+        for (Grid::Direction d : {Grid::RIGHT, Grid::DOWN}) {
+            if (d == Grid::RIGHT ? v % side == side - 1 : v / side == side - 1)
+                continue;
+            unsigned w = d == Grid::RIGHT ? v + 1 : v + side;
+            int c = smoothness(v, w);
+            grid.setCapacity(v, d, c);
+            grid.setCapacity(w, d == Grid::RIGHT ? Grid::LEFT : Grid::UP, c);
+            if (g != nullptr) {
+                g->addEdge(v, w, c);
+                g->addEdge(w, v, c);
+            }
+        }
+    }
+    return grid;
+}
+
+static void benchSegmentation(Benchmark &bench, unsigned side, unsigned ekMax) {
+    Graph<int> g;
+    cal::GridFlowNetwork<int> prototype = createSegmentation(side, bench.rng(5 * side), side <= ekMax ? &g : nullptr);
+    std::unique_ptr<cal::GridFlowNetwork<int>> grid;
+    double flow = 0;
+    BenchmarkResult &res = runCounted(bench, "segmentation_bk", [&]() {
+        grid.reset(new cal::GridFlowNetwork<int>(prototype));
+    }, [&]() { flow = grid->maxFlow(); }).param("n", side);
+    if (bench.enabled("segmentation_bk")) {
+        long foreground = 0;
+        for (unsigned v = 0; v < grid->getNumVertex(); v++)
+            foreground += grid->inSourceSide(v);
+        res.counter("flow", flow).counter("foreground", foreground)
+                .counter("bytes_per_pixel", (double) grid->memoryBytes() / grid->getNumVertex());
+    }
+    if (side > ekMax)
+        return;
+    const int n = side * side;
+    double ekFlow = 0;
+    BenchmarkResult &ek = runCounted(bench, "segmentation_edmonds_karp", [&]() {
+        g.fordFulkerson(n, n + 1);
+        ekFlow = cal::flowValue(g, n);
+    }).param("n", side);
+    if (bench.enabled("segmentation_edmonds_karp"))
+        ek.counter("flow", ekFlow).counter("bytes_per_pixel", (double) g.memoryBytes() / n);
+}
+
+static void benchResolve(Benchmark &bench, Graph<int> &g, int n, int numChanges) {
+    g.fordFulkerson(0, n * n - 1);
+    std::vector<Edge<int> *> edges, withFlow;
+    for (auto v : g.getVertexSet())
+        for (auto e : v->getAdj()) {
+            edges.push_back(e);
+            if (e->getFlow() > 0)
+                withFlow.push_back(e);
+        }
+    std::vector<int> capacities, flows;
+    for (auto e : edges) {
+        capacities.push_back(e->getCapacity());
+        flows.push_back(e->getFlow());
+    }
+    std::vector<Edge<int> *> cut = cal::minCut(g, 0).edges;
+    auto restore = [&]() {
+        for (size_t i = 0; i < edges.size(); i++) {
+            edges[i]->capacity = capacities[i];
+            edges[i]->flow = flows[i];
+        }
+    };
+
+    std::mt19937 gen = bench.rng(3 * n);
+    std::uniform_int_distribution<int> capacity(1, n);
+    for (const char *kind : {"decrease", "increase", "random"}) {
+        std::string change = kind;
+        const std::vector<Edge<int> *> &candidates = change == "decrease" ? withFlow : change == "increase" ? cut : edges;
+        if (candidates.empty())
+            continue;
+        std::uniform_int_distribution<size_t> pick(0, candidates.size() - 1);
+        std::vector<std::pair<Edge<int> *, int>> changes;
+        for (int i = 0; i < numChanges; i++) {
+            Edge<int> *e = candidates[pick(gen)];
+            int c = change == "decrease" ? (int) e->getFlow() / 2 : change == "increase" ? 2 * (int) e->getCapacity()
+                                                                                         : capacity(gen);
+            changes.emplace_back(e, c);
+        }
+        double coldFlow = 0, coldTime = 0, warmFlow = 0;
+        BenchmarkResult &cold = runCounted(bench, "resolve_cold", restore, [&]() {
+            for (const auto &c : changes)
+                c.first->capacity = c.second;
+            g.fordFulkerson(0, n * n - 1);
+            coldFlow = cal::flowValue(g, 0);
+        }).param("change", kind).param("changes", numChanges).param("n", n);
+        if (bench.enabled("resolve_cold")) {
+            cold.counter("flow", coldFlow);
+            coldTime = cold.median();
+        }
+        BenchmarkResult &warm = runCounted(bench, "resolve_warm", restore, [&]() {
+            for (const auto &c : changes)
+                g.updateCapacity(c.first->getOrig()->getInfo(), c.first->getDest()->getInfo(), c.second);
+            warmFlow = g.resolve();
+        }).param("change", kind).param("changes", numChanges).param("n", n);
+        if (bench.enabled("resolve_warm")) {
+            warm.counter("flow", warmFlow);
+            if (coldTime > 0)
+                warm.counter("speedup", coldTime / warm.median());
+        }
+    }
+    restore();
+}
+
+int main(int argc, char **argv) {
+    Benchmark bench("TP8", argc, argv);
+    const int MIN_SIZE = bench.getInt("min", 10);
+    const int MAX_SIZE = bench.getInt("max", 50);
+    const int STEP_SIZE = bench.getInt("step", 20);
+    const int CHANGES = bench.getInt("changes", 10);
+    const int BK_MIN = bench.getInt("bk-min", 1024);
+    const int BK_MAX = bench.getInt("bk-max", 4096);
+    const int BK_EK_MAX = bench.getInt("bk-ek-max", 64);
+    const int REL_MIN = bench.getInt("rel-min", 100);
+    const int REL_MAX = bench.getInt("rel-max", 1000);
+    const int REL_NAIVE_MAX = bench.getInt("rel-naive-max", 100);
+
+    for (int n = MIN_SIZE; n <= MAX_SIZE; n += STEP_SIZE) {
+        Graph<int> g;
+        generateGrid(n, bench.rng(n), g);
+        runCounted(bench, "max_flow", [&]() { g.fordFulkerson(0, n * n - 1); }).param("n", n);
+        // The flows of the last maximum flow are still in g
+        if (bench.enabled("min_cut") && !bench.enabled("max_flow"))
+            g.fordFulkerson(0, n * n - 1);
+        cal::MinCut<Graph<int>> cut;
+        BenchmarkResult &res = bench.run("min_cut", [&]() { cut = cal::minCut(g, 0); }).param("n", n);
+        if (bench.enabled("min_cut"))
+            res.counter("cut_edges", cut.edges.size()).counter("source_side", cut.sourceSide.size());
+        const cal::GridFlowNetwork<int> prototype = toGridNetwork(n, g);
+        std::unique_ptr<cal::GridFlowNetwork<int>> grid;
+        double flow = 0;
+        BenchmarkResult &bk = runCounted(bench, "max_flow_bk", [&]() {
+            grid.reset(new cal::GridFlowNetwork<int>(prototype));
+        }, [&]() { flow = grid->maxFlow(); }).param("n", n);
+        if (bench.enabled("max_flow_bk"))
+            bk.counter("flow", flow);
+        benchResolve(bench, g, n, CHANGES);
+    }
+    for (int side = BK_MIN; side <= BK_MAX; side *= 4)
+        benchSegmentation(bench, side, BK_EK_MAX);
+    for (int n = REL_MIN; n <= REL_MAX; n *= 10)
+        for (bool unit : {true, false})
+            benchReliability(bench, n, unit, REL_NAIVE_MAX);
+    return bench.finish();
+}
@@ -0,0 +1,99 @@
+/*
+ * TP9_bench.cpp
+ * Minimum cost flow on n x n grids, from the top-left to the bottom-right corner
+ * (edges in both directions between neighbours, random capacities and costs in [1, n]).
+ * Sizes: --min, --max, --step (grid side).
+ *
+ * Dense assignment problems (graph/Assignment.h), n x n random integer costs in [0, n] or in
+ * [0, 10^6], for n from --assign-min to --assign-max: auction (1, 2, 4, ... --threads threads),
+ * Hungarian up to --hungarian-max, and minimum cost flow on the bipartite network up to
+ * --assign-mcf-max.
+ */
+
+#include "Graph.h"
+#include "GraphStatsReport.h"
+#include "graph/Assignment.h"
+
+static void generateGrid(int n, std::mt19937 gen, Graph<int> &g) {
+    std::uniform_int_distribution<int> dis(1, n);
+    for (int v = 0; v < n * n; v++)
+        g.addVertex(v);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            if (i < n - 1) {
+                g.addEdge(i * n + j, (i + 1) * n + j, dis(gen), dis(gen));
+                g.addEdge((i + 1) * n + j, i * n + j, dis(gen), dis(gen));
+            }
+            if (j < n - 1) {
+                g.addEdge(i * n + j, i * n + j + 1, dis(gen), dis(gen));
+                g.addEdge(i * n + j + 1, i * n + j, dis(gen), dis(gen));
+            }
+        }
+}
+
+static void benchAssignment(Benchmark &bench, unsigned n, int maxCost, unsigned maxThreads, unsigned hungarianMax,
+                            unsigned mcfMax) {
+    std::mt19937 gen = bench.rng(n + maxCost);
+    std::uniform_int_distribution<int> dis(0, maxCost);
+    std::vector<int> costs((size_t) n * n);
+    for (int &c : costs)
+        c = dis(gen);
+    const long range = maxCost;
+    int64_t auctionCost = -1;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        BenchmarkResult &res = runCounted(bench, "assignment_auction", [&]() {
+            auctionCost = cal::auction(costs, n, pool).cost;
+        }).param("costs", range).param("n", n).param("threads", threads);
+        if (bench.enabled("assignment_auction"))
+            res.counter("cost", auctionCost);
+    }
+    if (n <= hungarianMax) {
+        int64_t cost = 0;
+        BenchmarkResult &res = runCounted(bench, "assignment_hungarian", [&]() { cost = cal::hungarian(costs, n).cost; })
+                .param("costs", range).param("n", n);
+        if (bench.enabled("assignment_hungarian"))
+            res.counter("cost", cost).counter("auction_difference", auctionCost < 0 ? 0 : auctionCost - cost);
+    }
+    if (n <= mcfMax) {
+        Graph<int> g;
+        for (unsigned v = 0; v < 2 * n + 2; v++)
+            g.addVertex(v);
+        for (unsigned i = 0; i < n; i++) {
+            g.addEdge(2 * n, i, 1, 0);
+            g.addEdge(n + i, 2 * n + 1, 1, 0);
+            for (unsigned j = 0; j < n; j++)
+                g.addEdge(i, n + j, 1, costs[(size_t) i * n + j]);
+        }
+        double cost = 0;
+        BenchmarkResult &res = runCounted(bench, "assignment_min_cost_flow", [&]() {
+            cost = g.minCostFlow(2 * n, 2 * n + 1, n);
+        }).param("costs", range).param("n", n);
+        if (bench.enabled("assignment_min_cost_flow"))
+            res.counter("cost", cost);
+    }
+}
+
+int main(int argc, char **argv) {
+    Benchmark bench("TP9", argc, argv);
+    const int MIN_SIZE = bench.getInt("min", 10);
+    const int MAX_SIZE = bench.getInt("max", 30);
+    const int STEP_SIZE = bench.getInt("step", 10);
+    const unsigned ASSIGN_MIN = bench.getInt("assign-min", 100);
+    const unsigned ASSIGN_MAX = bench.getInt("assign-max", 5000);
+    const unsigned HUNGARIAN_MAX = bench.getInt("hungarian-max", 2000);
+    const unsigned ASSIGN_MCF_MAX = bench.getInt("assign-mcf-max", 200);
+    const unsigned MAX_THREADS = bench.getInt("threads", 4);
+
+    for (int n = MIN_SIZE; n <= MAX_SIZE; n += STEP_SIZE) {
+        Graph<int> g;
+        generateGrid(n, bench.rng(n), g);
+        runCounted(bench, "max_flow", [&]() { g.fordFulkerson(0, n * n - 1); }).param("n", n);
+        runCounted(bench, "min_cost_flow", [&]() { g.minCostFlow(0, n * n - 1, INF); }).param("n", n);
+    }
+    for (unsigned n : {100, 200, 500, 1000, 2000, 5000})
+        if (n >= ASSIGN_MIN && n <= ASSIGN_MAX)
+            for (int maxCost : {(int) n, 1000000})
+                benchAssignment(bench, n, maxCost, MAX_THREADS, HUNGARIAN_MAX, ASSIGN_MCF_MAX);
+    return bench.finish();
+}
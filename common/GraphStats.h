@@ -0,0 +1,66 @@
+/*
+ * GraphStats.h
+ * Optional operation counters for the graph algorithms.
+ *
+ * The counters are only updated when CAL_GRAPH_STATS is defined at compile time
+ * (the benchmarks define it); otherwise GRAPH_STATS_INC expands to nothing and
+ * the algorithms compile exactly as before.
+ */
+#ifndef GRAPH_STATS_H_
+#define GRAPH_STATS_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Number of basic operations performed since the last reset(), by the calling thread.
+ */
+struct GraphStats {
+    unsigned long long relaxations = 0;      // edges that improved the distance (or key) of a vertex
+    unsigned long long pqInserts = 0;        // SearchContext::insert
+    unsigned long long pqDecreaseKeys = 0;   // SearchContext::decreaseKey
+    unsigned long long pqExtractMins = 0;    // SearchContext::extractMin
+    unsigned long long verticesSettled = 0;  // vertices removed from the queue of a search
+    unsigned long long pathSearches = 0;     // searches for an augmenting path (BFS or Dijkstra)
+    unsigned long long augmentingPaths = 0;  // augmenting paths found by the flow algorithms
+
+    void reset() { *this = GraphStats(); }
+
+    /*
+     * (name, value) pairs of the counters, in declaration order.
+     */
+    std::vector<std::pair<std::string, unsigned long long>> values() const {
+        return {{"relaxations",      relaxations},
+                {"pq_inserts",       pqInserts},
+                {"pq_decrease_keys", pqDecreaseKeys},
+                {"pq_extract_mins",  pqExtractMins},
+                {"vertices_settled", verticesSettled},
+                {"path_searches",    pathSearches},
+                {"augmenting_paths", augmentingPaths}};
+    }
+
+    static constexpr bool enabled() {
+#ifdef CAL_GRAPH_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+};
+
+/*
+ * Counters of the calling thread (thread_local, so parallel searches don't share cache lines).
+ */
+inline GraphStats &graphStats() {
+    static thread_local GraphStats stats;
+    return stats;
+}
+
+#ifdef CAL_GRAPH_STATS
+#define GRAPH_STATS_INC(counter) (++graphStats().counter)
+#else
+#define GRAPH_STATS_INC(counter) ((void) 0)
+#endif
+
+#endif /* GRAPH_STATS_H_ */
@@ -0,0 +1,191 @@
+/*
+ * SearchContext.h
+ * Scratch state of a graph search (BFS, DFS, Dijkstra, ...), kept outside the vertices
+ * so that several searches can run on the same graph at the same time.
+ */
+#ifndef SEARCH_CONTEXT_H_
+#define SEARCH_CONTEXT_H_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "GraphStats.h"
+#include "graph/WeightTraits.h"
+
+/**
+ * State of the vertices of a graph with dense ids (0 .. n-1) during one search.
+ *
+ * Every state carries the generation in which it was last written: states of older
+ * generations read as the initial state, so reset() starts a new search in O(1)
+ * instead of the usual loop over every vertex.
+ *
+ * Also holds the priority queue of Dijkstra-like searches (a binary heap of vertex ids,
+ * ordered by dist, with the position of each vertex kept in its state).
+ *
+ * Dist is the type of the distances (see cal::WeightTraits): SearchContext for double,
+ * cal::DistContext<W> for the searches on graphs with weights of type W.
+ *
+ * A context may be reused by any number of searches, but not by two at the same time:
+ * each thread uses its own (see local()).
+ */
+template<class Dist>
+class BasicSearchContext {
+public:
+    using DistType = Dist;
+
+    // Not named INF, which some of the TP classes define as a macro
+    static constexpr Dist INFINITE_DIST = cal::WeightTraits<Dist>::infinity();
+    static constexpr int NONE = -1;
+
+    struct State {
+        Dist dist = INFINITE_DIST;
+        int path = NONE;        // id of the previous vertex in the path
+        unsigned queueIndex = 0; // position in the heap (0 if not in the heap)
+        int indegree = 0;
+        bool visited = false;
+        bool processing = false;
+        unsigned generation = 0;
+    };
+
+    /*
+     * Starts a new search on a graph with (at most) numVertices vertices.
+     */
+    void reset(size_t numVertices);
+
+    /*
+     * State of a vertex, for reading and writing.
+     */
+    State &operator[](unsigned id) {
+        State &s = states[id];
+        if (s.generation != generation) {
+            s = State();
+            s.generation = generation;
+        }
+        return s;
+    }
+
+    /*
+     * State of a vertex, for reading only (the initial state if it was not touched).
+     */
+    State get(unsigned id) const {
+        return id < states.size() && states[id].generation == generation ? states[id] : State();
+    }
+
+    size_t size() const { return states.size(); }
+
+    // Priority queue of vertex ids, ordered by the "dist" field of their states
+    void insert(unsigned id);
+
+    void decreaseKey(unsigned id);
+
+    unsigned extractMin();
+
+    bool empty() const { return heap.size() == 1; }
+
+    /*
+     * Context of the calling thread, used by the graph functions that don't receive one.
+     * Must not be used by two nested searches.
+     */
+    static BasicSearchContext &local();
+
+private:
+    std::vector<State> states;
+    std::vector<unsigned> heap{0};  // heap[0] is unused, to simplify the index calculations
+    unsigned generation = 0;
+
+    void heapifyUp(unsigned i);
+
+    void heapifyDown(unsigned i);
+
+    void set(unsigned i, unsigned id);
+};
+
+using SearchContext = BasicSearchContext<double>;
+
+namespace cal {
+
+template<class W>
+using DistContext = BasicSearchContext<DistOf<W>>;
+
+}
+
+template<class Dist>
+void BasicSearchContext<Dist>::reset(size_t numVertices) {
+    if (states.size() < numVertices)
+        states.resize(numVertices);
+    heap.resize(1);
+    if (++generation == 0) {
+        // Wrapped around: older states could be taken as current ones
+        for (State &s : states)
+            s.generation = 0;
+        generation = 1;
+    }
+}
+
+template<class Dist>
+BasicSearchContext<Dist> &BasicSearchContext<Dist>::local() {
+    static thread_local BasicSearchContext ctx;
+    return ctx;
+}
+
+template<class Dist>
+void BasicSearchContext<Dist>::insert(unsigned id) {
+    GRAPH_STATS_INC(pqInserts);
+    heap.push_back(id);
+    heapifyUp(heap.size() - 1);
+}
+
+template<class Dist>
+void BasicSearchContext<Dist>::decreaseKey(unsigned id) {
+    GRAPH_STATS_INC(pqDecreaseKeys);
+    heapifyUp((*this)[id].queueIndex);
+}
+
+template<class Dist>
+unsigned BasicSearchContext<Dist>::extractMin() {
+    GRAPH_STATS_INC(pqExtractMins);
+    unsigned id = heap[1];
+    heap[1] = heap.back();
+    heap.pop_back();
+    if (heap.size() > 1)
+        heapifyDown(1);
+    (*this)[id].queueIndex = 0;
+    return id;
+}
+
+template<class Dist>
+void BasicSearchContext<Dist>::heapifyUp(unsigned i) {
+    unsigned id = heap[i];
+    Dist key = states[id].dist;
+    while (i > 1 && key < states[heap[i / 2]].dist) {
+        set(i, heap[i / 2]);
+        i /= 2;
+    }
+    set(i, id);
+}
+
+template<class Dist>
+void BasicSearchContext<Dist>::heapifyDown(unsigned i) {
+    unsigned id = heap[i];
+    Dist key = states[id].dist;
+    while (true) {
+        unsigned k = i * 2;
+        if (k >= heap.size())
+            break;
+        if (k + 1 < heap.size() && states[heap[k + 1]].dist < states[heap[k]].dist)
+            ++k; // right child of i
+        if (!(states[heap[k]].dist < key))
+            break;
+        set(i, heap[k]);
+        i = k;
+    }
+    set(i, id);
+}
+
+template<class Dist>
+void BasicSearchContext<Dist>::set(unsigned i, unsigned id) {
+    heap[i] = id;
+    states[id].queueIndex = i;
+}
+
+#endif /* SEARCH_CONTEXT_H_ */
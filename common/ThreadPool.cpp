@@ -0,0 +1,180 @@
+/*
+ * ThreadPool.cpp
+ */
+
+#include "ThreadPool.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Pool and index of the worker running on the current thread (-1 outside any pool).
+static thread_local ThreadPool *currentPool = nullptr;
+static thread_local int currentIndex = -1;
+
+static std::unique_ptr<ThreadPool> globalPool;
+static std::mutex globalPoolMutex;
+
+ThreadPool::ThreadPool(unsigned numThreads, bool pinThreads) {
+    numThreads = std::max(1u, numThreads);
+    for (unsigned i = 0; i < numThreads; i++)
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    for (unsigned i = 0; i < numThreads; i++)
+        workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i, pinThreads);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto &w : workers)
+        w->thread.join();
+}
+
+unsigned ThreadPool::getNumThreads() const {
+    return workers.size();
+}
+
+unsigned ThreadPool::defaultNumThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+ThreadPool &ThreadPool::global() {
+    std::lock_guard<std::mutex> lock(globalPoolMutex);
+    if (globalPool == nullptr)
+        globalPool.reset(new ThreadPool());
+    return *globalPool;
+}
+
+/*
+ * Replaces the shared pool. Must not be called while tasks are running on it.
+ */
+void ThreadPool::setGlobalNumThreads(unsigned numThreads, bool pinThreads) {
+    std::lock_guard<std::mutex> lock(globalPoolMutex);
+    if (globalPool != nullptr && globalPool->getNumThreads() == std::max(1u, numThreads))
+        return;
+    globalPool.reset(); // joins the old workers first
+    globalPool.reset(new ThreadPool(numThreads, pinThreads));
+}
+
+int ThreadPool::currentWorker() const {
+    return currentPool == this ? currentIndex : -1;
+}
+
+void ThreadPool::submit(Task task) {
+    // Counted before it can be popped (and decremented), so the count never wraps below zero
+    int self = currentWorker();
+    if (self >= 0) {
+        std::lock_guard<std::mutex> lock(workers[self]->mutex);
+        ++queuedTasks;
+        workers[self]->tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        ++queuedTasks;
+        injected.push_back(std::move(task));
+    }
+    { std::lock_guard<std::mutex> lock(sleepMutex); } // a worker checking the predicate sees the new task
+    wakeUp.notify_one();
+}
+
+/*
+ * Takes a task from the calling worker's own deque (back), then from the
+ * injection queue, and finally tries to steal from the other workers (front).
+ */
+bool ThreadPool::popTask(int self, Task &task) {
+    if (queuedTasks == 0) return false;
+    if (self >= 0) {
+        std::lock_guard<std::mutex> lock(workers[self]->mutex);
+        if (!workers[self]->tasks.empty()) {
+            task = std::move(workers[self]->tasks.back());
+            workers[self]->tasks.pop_back();
+            --queuedTasks;
+            return true;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        if (!injected.empty()) {
+            task = std::move(injected.front());
+            injected.pop_front();
+            --queuedTasks;
+            return true;
+        }
+    }
+    unsigned n = workers.size();
+    unsigned start = self >= 0 ? self + 1 : 0;
+    for (unsigned k = 0; k < n; k++) {
+        unsigned victim = (start + k) % n;
+        if ((int) victim == self) continue;
+        std::lock_guard<std::mutex> lock(workers[victim]->mutex);
+        if (!workers[victim]->tasks.empty()) {
+            task = std::move(workers[victim]->tasks.front());
+            workers[victim]->tasks.pop_front();
+            --queuedTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Runs one queued task on the calling thread, if there is any.
+ * Returns true if a task was executed.
+ */
+bool ThreadPool::runPendingTask() {
+    Task task;
+    if (!popTask(currentWorker(), task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(unsigned index, bool pinThread) {
+    currentPool = this;
+    currentIndex = index;
+#ifdef __linux__
+    if (pinThread) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(index % defaultNumThreads(), &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#else
+    (void) pinThread;
+#endif
+    Task task;
+    while (true) {
+        if (popTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (stopping && queuedTasks == 0) break;
+        wakeUp.wait(lock, [this]() { return stopping || queuedTasks > 0; });
+    }
+}
+
+
+TaskGroup::TaskGroup(ThreadPool &pool) : pool(pool) {}
+
+TaskGroup::~TaskGroup() {
+    while (pending > 0)
+        if (!pool.runPendingTask())
+            std::this_thread::yield();
+}
+
+void TaskGroup::sync() {
+    while (pending > 0) {
+        if (!pool.runPendingTask())
+            std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
@@ -0,0 +1,171 @@
+/*
+ * ThreadPool.h
+ * Work-stealing task scheduler shared by all the TP classes.
+ */
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads, each one owning a deque of tasks.
+ * A worker pushes and pops its own tasks at the back (LIFO, which keeps
+ * divide-and-conquer subproblems hot in cache) and, when it runs out of work,
+ * steals from the front of the other deques. Tasks submitted by threads that
+ * do not belong to the pool go to a shared injection queue.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned numThreads = defaultNumThreads(), bool pinThreads = false);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned getNumThreads() const;
+
+    void submit(Task task);
+
+    bool runPendingTask();
+
+    int currentWorker() const;
+
+    static unsigned defaultNumThreads();
+
+    static ThreadPool &global();
+
+    static void setGlobalNumThreads(unsigned numThreads, bool pinThreads = false);
+
+private:
+    struct Worker {
+        std::deque<Task> tasks;
+        std::mutex mutex;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::deque<Task> injected;              // tasks submitted from outside the pool
+    std::mutex injectedMutex;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<unsigned> queuedTasks{0};   // tasks waiting in any of the queues
+    std::atomic<bool> stopping{false};
+
+    void workerLoop(unsigned index, bool pinThread);
+
+    bool popTask(int self, Task &task);
+};
+
+/**
+ * Spawn/sync primitive: spawn() hands a task to the pool and sync() waits for
+ * every task spawned by this group. While waiting, the calling thread runs
+ * queued tasks itself, so groups can be nested inside pool tasks.
+ * The first exception thrown by a task is rethrown by sync().
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool &pool = ThreadPool::global());
+
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    template<class F>
+    void spawn(F &&f);
+
+    void sync();
+
+private:
+    ThreadPool &pool;
+    std::atomic<unsigned> pending{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+};
+
+template<class F>
+void TaskGroup::spawn(F &&f) {
+    ++pending;
+    pool.submit([this, task = std::forward<F>(f)]() mutable {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+        --pending;
+    });
+}
+
+/*
+ * Splits [begin, end) into chunks of at least "grain" indices (by default,
+ * about four chunks per thread). Returns the chunk size.
+ */
+inline size_t chunkSize(size_t begin, size_t end, size_t grain, const ThreadPool &pool) {
+    size_t n = end > begin ? end - begin : 0;
+    size_t chunks = 4 * (size_t) pool.getNumThreads();
+    return std::max<size_t>(std::max<size_t>(grain, 1), (n + chunks - 1) / chunks);
+}
+
+/*
+ * Calls body(i) for every i in [begin, end), in parallel.
+ */
+template<class F>
+void parallelFor(size_t begin, size_t end, F body, size_t grain = 0, ThreadPool &pool = ThreadPool::global()) {
+    if (begin >= end) return;
+    size_t chunk = chunkSize(begin, end, grain, pool);
+    TaskGroup group(pool);
+    size_t lo = begin;
+    for (; lo + chunk < end; lo += chunk) {
+        group.spawn([&body, lo, chunk]() {
+            for (size_t i = lo; i < lo + chunk; i++)
+                body(i);
+        });
+    }
+    for (size_t i = lo; i < end; i++) // last chunk runs on the calling thread
+        body(i);
+    group.sync();
+}
+
+/*
+ * Parallel reduction over [begin, end): each chunk [lo, hi) is folded by
+ * chunkBody(lo, hi) and the partial results are combined, in chunk order,
+ * starting from "identity".
+ */
+template<class R, class ChunkBody, class Combine>
+R parallelReduce(size_t begin, size_t end, R identity, ChunkBody chunkBody, Combine combine,
+                 size_t grain = 0, ThreadPool &pool = ThreadPool::global()) {
+    if (begin >= end) return identity;
+    size_t chunk = chunkSize(begin, end, grain, pool);
+    std::vector<R> partial((end - begin + chunk - 1) / chunk, identity);
+    TaskGroup group(pool);
+    for (size_t c = 1; c < partial.size(); c++) {
+        group.spawn([&, c]() {
+            size_t lo = begin + c * chunk;
+            partial[c] = chunkBody(lo, std::min(end, lo + chunk));
+        });
+    }
+    partial[0] = chunkBody(begin, std::min(end, begin + chunk));
+    group.sync();
+    R res = identity;
+    for (auto &p : partial)
+        res = combine(res, p);
+    return res;
+}
+
+#endif /* THREAD_POOL_H_ */
@@ -0,0 +1,104 @@
+/*
+ * Trace.cpp
+ */
+
+#include "Trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char *name;
+    int64_t start;
+    int64_t duration;
+};
+
+/**
+ * Ring buffer written only by its own thread: the events before "head" are complete.
+ */
+struct TraceBuffer {
+    std::vector<TraceEvent> events{Trace::BUFFER_CAPACITY};
+    std::atomic<uint64_t> head{0};
+    unsigned tid = 0;
+};
+
+const auto epoch = std::chrono::steady_clock::now();
+
+// Buffers of every thread that recorded an event (kept after the thread exits)
+std::vector<std::shared_ptr<TraceBuffer>> buffers;
+std::mutex buffersMutex;
+
+thread_local TraceBuffer *localBuffer = nullptr;
+
+TraceBuffer &getLocalBuffer() {
+    if (localBuffer == nullptr) {
+        auto buffer = std::make_shared<TraceBuffer>();
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffer->tid = buffers.size();
+        buffers.push_back(buffer);
+        localBuffer = buffer.get();
+    }
+    return *localBuffer;
+}
+
+}
+
+std::atomic<bool> Trace::enabled{false};
+
+void Trace::enable(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Trace::record(const char *name, int64_t start, int64_t end) {
+    TraceBuffer &buffer = getLocalBuffer();
+    uint64_t h = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[h % BUFFER_CAPACITY] = {name, start, end - start};
+    buffer.head.store(h + 1, std::memory_order_release);
+}
+
+void Trace::clear() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (auto &buffer : buffers)
+        buffer->head.store(0, std::memory_order_relaxed);
+}
+
+/*
+ * Writes the "complete" (ph X) events of every thread, with times in microseconds.
+ */
+void Trace::writeJson(std::ostream &os) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    auto oldPrecision = os.precision(15);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (auto &buffer : buffers) {
+        os << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+           << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+        first = false;
+        uint64_t end = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = end > BUFFER_CAPACITY ? end - BUFFER_CAPACITY : 0;
+        for (uint64_t i = begin; i < end; i++) {
+            const TraceEvent &e = buffer->events[i % BUFFER_CAPACITY];
+            os << ",\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+               << ",\"ts\":" << e.start / 1000.0 << ",\"dur\":" << e.duration / 1000.0 << "}";
+        }
+    }
+    os << "\n]}\n";
+    os.precision(oldPrecision);
+}
+
+bool Trace::writeJson(const std::string &filename) {
+    std::ofstream os(filename);
+    if (!os)
+        return false;
+    writeJson(os);
+    return (bool) os;
+}
@@ -0,0 +1,95 @@
+/*
+ * Trace.h
+ * Scoped timers that record the phases of the algorithms, written out in the
+ * Chrome trace event format (open the file in chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Usage:
+ *   void Graph<T>::calculateKruskal() {
+ *       TRACE_SCOPE("kruskal_sort");
+ *       ...
+ *   }
+ *   Trace::enable();
+ *   ...
+ *   Trace::writeJson("trace.json");
+ *
+ * The scopes are only compiled in when CAL_TRACE is defined (the benchmarks define it),
+ * and only record events after Trace::enable().
+ */
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+class Trace {
+    static std::atomic<bool> enabled;
+
+public:
+    /**
+     * Number of events kept per thread; older events are overwritten.
+     */
+    static const size_t BUFFER_CAPACITY = 1 << 16;
+
+    static void enable(bool on = true);
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /*
+     * Nanoseconds since the start of the program.
+     */
+    static int64_t now();
+
+    /*
+     * Appends an event to the buffer of the calling thread (no locks, except
+     * the first time a thread records an event).
+     * "name" must outlive the trace (use string literals).
+     */
+    static void record(const char *name, int64_t start, int64_t end);
+
+    /*
+     * The following functions must not run concurrently with traced code.
+     */
+    static void clear();
+
+    static void writeJson(std::ostream &os);
+
+    static bool writeJson(const std::string &filename);
+};
+
+/**
+ * Records an event from its construction to its destruction.
+ */
+class TraceScope {
+    const char *name;
+    int64_t start = -1;  // -1: not recording
+
+public:
+    explicit TraceScope(const char *name, bool condition = true) : name(name) {
+        if (condition && Trace::isEnabled())
+            start = Trace::now();
+    }
+
+    ~TraceScope() {
+        if (start >= 0)
+            Trace::record(name, start, Trace::now());
+    }
+
+    TraceScope(const TraceScope &) = delete;
+
+    TraceScope &operator=(const TraceScope &) = delete;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#ifdef CAL_TRACE
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_SCOPE_IF(condition, name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, condition)
+#else
+#define TRACE_SCOPE(name) ((void) 0)
+#define TRACE_SCOPE_IF(condition, name) ((void) 0)
+#endif
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,195 @@
+/*
+ * Assignment.h
+ * Assignment problem on a dense n x n cost matrix (by rows): a column for each row, all
+ * different, of minimum total cost. The same as a minimum cost flow of value n in the complete
+ * bipartite network, without building it:
+ *   - hungarian: shortest augmenting paths from each row in turn, with row and column
+ *     potentials (Hungarian algorithm, as in Jonker-Volgenant), O(n^3), any cost type;
+ *   - auction: rows bid for their best column, raising its price by the difference to their
+ *     second best plus epsilon; all the unassigned rows bid at once, split among threads
+ *     (Jacobi), and the highest bid for each column wins. Epsilon is scaled down from the
+ *     largest cost to 1, keeping the prices, with integer costs multiplied by n + 1, so the
+ *     result is optimal.
+ */
+#ifndef CAL_GRAPH_ASSIGNMENT_H_
+#define CAL_GRAPH_ASSIGNMENT_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "ThreadPool.h"
+#include "GraphStats.h"
+#include "Trace.h"
+
+namespace cal {
+
+template<class C>
+struct Assignment {
+    // Type of the total cost: exact for integer costs
+    using CostType = typename std::conditional<std::is_integral<C>::value, int64_t, double>::type;
+
+    std::vector<unsigned> columnOf;  // column assigned to each row
+    CostType cost = 0;
+};
+
+/*
+ * Optimal assignment by shortest augmenting paths, O(n^3).
+ */
+template<class C>
+Assignment<C> hungarian(const std::vector<C> &costs, unsigned n) {
+    TRACE_SCOPE("hungarian");
+    using Cost = typename Assignment<C>::CostType;
+    const Cost infinity = std::numeric_limits<Cost>::max();
+    // Rows and columns from 1 (column 0: the row being assigned); rowOf[j]: row of column j
+    std::vector<Cost> rowPotential(n + 1, 0), columnPotential(n + 1, 0), minSlack(n + 1);
+    std::vector<unsigned> rowOf(n + 1, 0), previous(n + 1, 0);
+    std::vector<bool> used(n + 1);
+    for (unsigned i = 1; i <= n; i++) {
+        GRAPH_STATS_INC(pathSearches);
+        rowOf[0] = i;
+        unsigned j0 = 0;
+        std::fill(minSlack.begin(), minSlack.end(), infinity);
+        std::fill(used.begin(), used.end(), false);
+        // Dijkstra on the reduced costs, one column at a time, until a free column is reached
+        do {
+            used[j0] = true;
+            unsigned i0 = rowOf[j0], j1 = 0;
+            const C *row = costs.data() + (size_t) (i0 - 1) * n;
+            Cost delta = infinity;
+            for (unsigned j = 1; j <= n; j++)
+                if (!used[j]) {
+                    Cost slack = Cost(row[j - 1]) - rowPotential[i0] - columnPotential[j];
+                    if (slack < minSlack[j]) {
+                        GRAPH_STATS_INC(relaxations);
+                        minSlack[j] = slack;
+                        previous[j] = j0;
+                    }
+                    if (minSlack[j] < delta) {
+                        delta = minSlack[j];
+                        j1 = j;
+                    }
+                }
+            for (unsigned j = 0; j <= n; j++)
+                if (used[j]) {
+                    rowPotential[rowOf[j]] += delta;
+                    columnPotential[j] -= delta;
+                } else {
+                    minSlack[j] -= delta;
+                }
+            j0 = j1;
+        } while (rowOf[j0] != 0);
+        // Augmenting path: each column on it goes to the row of the previous one
+        GRAPH_STATS_INC(augmentingPaths);
+        do {
+            unsigned j1 = previous[j0];
+            rowOf[j0] = rowOf[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+    Assignment<C> res;
+    res.columnOf.resize(n);
+    for (unsigned j = 1; j <= n; j++)
+        res.columnOf[rowOf[j] - 1] = j - 1;
+    for (unsigned i = 0; i < n; i++)
+        res.cost += costs[(size_t) i * n + res.columnOf[i]];
+    return res;
+}
+
+/*
+ * Optimal assignment by the auction algorithm (integer costs), with the bids of each round
+ * computed in parallel. Epsilon is divided by scalingFactor from one phase to the next.
+ */
+template<class C>
+Assignment<C> auction(const std::vector<C> &costs, unsigned n, ThreadPool &pool = ThreadPool::global(),
+                      unsigned scalingFactor = 5) {
+    static_assert(std::is_integral<C>::value, "auction needs integer costs");
+    TRACE_SCOPE("auction");
+    using Price = int64_t;
+    constexpr unsigned NONE = std::numeric_limits<unsigned>::max();
+    constexpr size_t GRAIN = 16;
+    const Price scale = (Price) n + 1;
+    Price maxCost = 1;
+    for (C c : costs)
+        maxCost = std::max<Price>(maxCost, c < 0 ? -(Price) c : (Price) c);
+
+    // Rows maximize -cost * scale - price
+    std::vector<Price> price(n, 0), bestBid(n);
+    std::vector<unsigned> owner(n), columnOf(n), bidder(n, NONE), bidColumn(n);
+    std::vector<Price> bid(n);
+    std::vector<unsigned> unassigned, next, won;
+    Price epsilon = std::max<Price>(1, maxCost * scale / 2);
+    for (;;) {
+        TRACE_SCOPE("auction_phase");
+        std::fill(owner.begin(), owner.end(), NONE);
+        std::fill(columnOf.begin(), columnOf.end(), NONE);
+        unassigned.resize(n);
+        for (unsigned i = 0; i < n; i++)
+            unassigned[i] = i;
+        while (!unassigned.empty()) {
+            // Bids of the unassigned rows, against the prices of the last round
+            parallelFor(0, unassigned.size(), [&](size_t k) {
+                const C *row = costs.data() + (size_t) unassigned[k] * n;
+                Price best = std::numeric_limits<Price>::min(), second = best;
+                unsigned bestColumn = 0;
+                for (unsigned j = 0; j < n; j++) {
+                    Price value = -(Price) row[j] * scale - price[j];
+                    if (value > best) {
+                        second = best;
+                        best = value;
+                        bestColumn = j;
+                    } else if (value > second) {
+                        second = value;
+                    }
+                }
+                if (n == 1)
+                    second = best;
+                bidColumn[k] = bestColumn;
+                bid[k] = price[bestColumn] + (best - second) + epsilon;
+            }, GRAIN, pool);
+            // The highest bid for each column wins (the first of equal bids)
+            won.clear();
+            for (size_t k = 0; k < unassigned.size(); k++) {
+                GRAPH_STATS_INC(relaxations);
+                unsigned j = bidColumn[k];
+                if (bidder[j] == NONE) {
+                    won.push_back(j);
+                    bidder[j] = k;
+                    bestBid[j] = bid[k];
+                } else if (bid[k] > bestBid[j]) {
+                    bidder[j] = k;
+                    bestBid[j] = bid[k];
+                }
+            }
+            next.clear();
+            for (unsigned j : won) {
+                unsigned i = unassigned[bidder[j]];
+                if (owner[j] != NONE) {
+                    columnOf[owner[j]] = NONE;
+                    next.push_back(owner[j]);
+                }
+                owner[j] = i;
+                columnOf[i] = j;
+                price[j] = bestBid[j];
+                bidder[j] = NONE;
+            }
+            for (unsigned i : unassigned)
+                if (columnOf[i] == NONE)
+                    next.push_back(i);
+            unassigned.swap(next);
+        }
+        if (epsilon == 1)
+            break;
+        epsilon = std::max<Price>(1, epsilon / scalingFactor);
+    }
+    Assignment<C> res;
+    res.columnOf = columnOf;
+    for (unsigned i = 0; i < n; i++)
+        res.cost += costs[(size_t) i * n + columnOf[i]];
+    return res;
+}
+
+}
+
+#endif /* CAL_GRAPH_ASSIGNMENT_H_ */
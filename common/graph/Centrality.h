@@ -0,0 +1,149 @@
+/*
+ * Centrality.h
+ * Betweenness centrality (Brandes, "A faster algorithm for betweenness centrality", 2001),
+ * in number of edges (the weights are not used): for each vertex v, the sum over the pairs
+ * (s, t) of the fraction of the shortest paths from s to t that go through v.
+ * The pairs are ordered: in undirected graphs (edges in both directions) every path is
+ * counted twice.
+ */
+#ifndef CAL_GRAPH_CENTRALITY_H_
+#define CAL_GRAPH_CENTRALITY_H_
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "GraphStats.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+
+namespace cal {
+
+namespace detail {
+
+/**
+ * Buffers of the searches run one after the other, and the dependencies they accumulated.
+ */
+struct BrandesBuffers {
+    std::vector<double> centrality;
+    std::vector<int> dist;          // -1 if not reached
+    std::vector<double> paths;      // number of shortest paths from the source
+    std::vector<double> dependency;  // see brandesSource
+    std::vector<unsigned> order;    // reached vertices, by distance (the BFS queue)
+
+    explicit BrandesBuffers(unsigned n) : centrality(n, 0), dist(n, -1), paths(n, 0), dependency(n, 0) {}
+};
+
+/*
+ * Adds the dependencies of the source s to b.centrality: breadth-first search counting the
+ * shortest paths, then the vertices in reverse order, each one adding to its dependency
+ * the share of the dependencies of its successors in the shortest paths.
+ * The edges of u are targets[offsets[u] .. offsets[u + 1]).
+ */
+inline void brandesSource(const std::vector<unsigned> &offsets, const std::vector<unsigned> &targets,
+                          unsigned s, BrandesBuffers &b) {
+    b.order.clear();
+    b.order.push_back(s);
+    b.dist[s] = 0;
+    b.paths[s] = 1;
+    for (size_t head = 0; head < b.order.size(); head++) {
+        unsigned u = b.order[head];
+        GRAPH_STATS_INC(verticesSettled);
+        for (unsigned i = offsets[u]; i < offsets[u + 1]; i++) {
+            unsigned v = targets[i];
+            if (b.dist[v] < 0) {
+                b.dist[v] = b.dist[u] + 1;
+                b.order.push_back(v);
+            }
+            if (b.dist[v] == b.dist[u] + 1)
+                b.paths[v] += b.paths[u];
+        }
+    }
+    // b.dependency[v] holds (1 + dependency of v) / paths to v, the share of each path through v
+    for (size_t k = b.order.size(); k-- > 0;) {
+        unsigned u = b.order[k];
+        double share = 0;
+        for (unsigned i = offsets[u]; i < offsets[u + 1]; i++) {
+            unsigned v = targets[i];
+            if (b.dist[v] == b.dist[u] + 1)
+                share += b.dependency[v];
+        }
+        double dependency = b.paths[u] * share;
+        b.dependency[u] = (1 + dependency) / b.paths[u];
+        if (u != s)
+            b.centrality[u] += dependency;
+    }
+    for (unsigned u : b.order) {
+        b.dist[u] = -1;
+        b.paths[u] = 0;
+        b.dependency[u] = 0;
+    }
+}
+
+}
+
+/*
+ * Betweenness centrality of every vertex (by id), with the searches from the sources split
+ * among the threads of the pool (each search on buffers that no other running search uses,
+ * summed at the end).
+ * With samples > 0 (and less than the number of vertices), only that many random sources
+ * (pivots) are searched, and the result is scaled by n / samples: an unbiased estimate
+ * (Brandes and Pich, 2007), in a fraction of the time.
+ * The searches run on a compact copy of the edges (CSR), built first.
+ */
+template<class G>
+std::vector<double> betweenness(const G &g, unsigned samples = 0, unsigned seed = 0,
+                                ThreadPool &pool = ThreadPool::global()) {
+    TRACE_SCOPE("betweenness");
+    unsigned n = g.getNumVertex();
+    std::vector<unsigned> sources(n);
+    std::iota(sources.begin(), sources.end(), 0);
+    double scale = 1;
+    if (samples > 0 && samples < n) {
+        std::mt19937 gen(seed);
+        std::shuffle(sources.begin(), sources.end(), gen);
+        sources.resize(samples);
+        scale = (double) n / samples;
+    }
+    std::vector<unsigned> offsets(n + 1, 0), targets;
+    for (unsigned u = 0; u < n; u++) {
+        for (const auto &e : g.out(u))
+            targets.push_back(g.target(e));
+        offsets[u + 1] = targets.size();
+    }
+    // Each search takes a set of buffers from the idle ones (or a new set) and gives it back at
+    // the end, as in countTriangles (see Triangles.h): at most one set per search running at
+    // the same time, whichever thread runs it.
+    std::mutex idleLock;
+    std::vector<std::unique_ptr<detail::BrandesBuffers>> buffers;
+    std::vector<detail::BrandesBuffers *> idle;
+    parallelFor(0, sources.size(), [&](size_t i) {
+        detail::BrandesBuffers *b;
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+            if (idle.empty()) {
+                buffers.emplace_back(new detail::BrandesBuffers(n));
+                idle.push_back(buffers.back().get());
+            }
+            b = idle.back();
+            idle.pop_back();
+        }
+        detail::brandesSource(offsets, targets, sources[i], *b);
+        std::lock_guard<std::mutex> guard(idleLock);
+        idle.push_back(b);
+    }, 1, pool);
+    std::vector<double> res(n, 0);
+    for (const auto &b : buffers)
+        for (unsigned u = 0; u < n; u++)
+            res[u] += b->centrality[u];
+    if (scale != 1)
+        for (double &c : res)
+            c *= scale;
+    return res;
+}
+
+}
+
+#endif /* CAL_GRAPH_CENTRALITY_H_ */
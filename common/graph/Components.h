@@ -0,0 +1,413 @@
+/*
+ * Components.h
+ * Strongly connected components of directed graphs: Tarjan's algorithm (sequential, with
+ * an explicit stack) and the forward-backward algorithm with trimming (parallel, for large
+ * graphs), and the condensation of a graph (the DAG of its components).
+ * Connected components of undirected graphs (weakly connected components of directed ones):
+ * union-find (sequential) and Afforest (parallel).
+ */
+#ifndef CAL_GRAPH_COMPONENTS_H_
+#define CAL_GRAPH_COMPONENTS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "Trace.h"
+#include "ThreadPool.h"
+#include "UnionFind.h"
+
+namespace cal {
+
+/**
+ * Partition of the vertices in components: the component of each vertex (by id), 0 .. count-1.
+ */
+struct Components {
+    unsigned count = 0;
+    std::vector<unsigned> component;
+
+    /*
+     * Ids of the vertices of each component, in increasing order.
+     */
+    std::vector<std::vector<unsigned>> members() const {
+        std::vector<std::vector<unsigned>> res(count);
+        for (unsigned v = 0; v < component.size(); v++)
+            res[component[v]].push_back(v);
+        return res;
+    }
+};
+
+/*
+ * Tarjan's algorithm, O(|V| + |E|). The depth-first search keeps its own stack, so deep
+ * graphs don't overflow the call stack. The components are numbered in topological order
+ * of the condensation: every edge between components goes to a higher component.
+ */
+template<class G>
+Components tarjanScc(const G &g) {
+    TRACE_SCOPE("tarjan_scc");
+    const unsigned NONE = std::numeric_limits<unsigned>::max();
+    unsigned n = g.getNumVertex();
+    Components res;
+    res.component.assign(n, NONE);
+    std::vector<unsigned> index(n, NONE), low(n);
+    std::vector<unsigned> members;                       // vertices of the open components
+    std::vector<std::pair<unsigned, size_t>> stack;      // vertex, next edge to follow
+    unsigned next = 0;
+    for (unsigned s = 0; s < n; s++) {
+        if (index[s] != NONE) continue;
+        index[s] = low[s] = next++;
+        members.push_back(s);
+        stack.emplace_back(s, 0);
+        while (!stack.empty()) {
+            unsigned u = stack.back().first;
+            const auto &adj = g.out(u);
+            if (stack.back().second < adj.size()) {
+                unsigned v = g.target(adj[stack.back().second++]);
+                if (index[v] == NONE) {
+                    index[v] = low[v] = next++;
+                    members.push_back(v);
+                    stack.emplace_back(v, 0);
+                } else if (res.component[v] == NONE) {  // v is in an open component
+                    low[u] = std::min(low[u], index[v]);
+                }
+                continue;
+            }
+            stack.pop_back();
+            if (!stack.empty())
+                low[stack.back().first] = std::min(low[stack.back().first], low[u]);
+            if (low[u] == index[u]) {  // u is the root of a component
+                unsigned v;
+                do {
+                    v = members.back();
+                    members.pop_back();
+                    res.component[v] = res.count;
+                } while (v != u);
+                res.count++;
+            }
+        }
+    }
+    // Tarjan closes the components in reverse topological order
+    for (unsigned &c : res.component)
+        c = res.count - 1 - c;
+    return res;
+}
+
+/*
+ * Strongly connected components in parallel, in the pool, for large graphs
+ * (trimming, then forward-backward for the largest component, then coloring):
+ *   1. vertices without incoming or outgoing edges (within the remaining vertices) are
+ *      components of their own;
+ *   2. the vertices reachable both forward and backward from a pivot of high degree form
+ *      its component (usually the giant one), with both searches in parallel;
+ *   3. each remaining vertex gets the largest id of the vertices that reach it (propagated
+ *      along the edges in parallel sweeps); each vertex that keeps its own id is the root
+ *      of a component: the vertices of its color that reach it (backward search, the
+ *      roots in parallel). Repeated on the vertices left.
+ * Forward-backward alone takes quadratic time on long chains of components, which the
+ * coloring step splits in one round. Component ids are not in any particular order.
+ */
+template<class G>
+Components parallelScc(const G &g, ThreadPool &pool = ThreadPool::global()) {
+    TRACE_SCOPE("parallel_scc");
+    const unsigned DONE = std::numeric_limits<unsigned>::max();
+    unsigned n = g.getNumVertex();
+
+    // Outgoing and incoming edges, in CSR form
+    std::vector<unsigned> outOffsets(n + 1, 0), inOffsets(n + 1, 0);
+    for (unsigned u = 0; u < n; u++) {
+        outOffsets[u + 1] = outOffsets[u] + g.out(u).size();
+        for (const auto &e : g.out(u))
+            inOffsets[g.target(e) + 1]++;
+    }
+    for (unsigned u = 0; u < n; u++)
+        inOffsets[u + 1] += inOffsets[u];
+    std::vector<unsigned> outTargets(outOffsets[n]), inSources(outOffsets[n]);
+    {
+        std::vector<unsigned> inNext(inOffsets.begin(), inOffsets.end() - 1);
+        for (unsigned u = 0; u < n; u++) {
+            unsigned i = outOffsets[u];
+            for (const auto &e : g.out(u)) {
+                unsigned v = g.target(e);
+                outTargets[i++] = v;
+                inSources[inNext[v]++] = u;
+            }
+        }
+    }
+
+    // Color of each vertex in the coloring step; DONE once its component is known
+    std::unique_ptr<std::atomic<unsigned>[]> color(new std::atomic<unsigned>[n]);
+    std::vector<unsigned> component(n);
+    std::atomic<unsigned> components(0);
+    auto isDone = [&](unsigned v) { return color[v].load(std::memory_order_relaxed) == DONE; };
+    {
+        TRACE_SCOPE("scc_trim");
+        std::vector<unsigned> inDegree(n), outDegree(n), trimmed;
+        for (unsigned u = 0; u < n; u++) {
+            color[u].store(0, std::memory_order_relaxed);
+            inDegree[u] = inOffsets[u + 1] - inOffsets[u];
+            outDegree[u] = outOffsets[u + 1] - outOffsets[u];
+            if (inDegree[u] == 0 || outDegree[u] == 0)
+                trimmed.push_back(u);
+        }
+        for (size_t i = 0; i < trimmed.size(); i++) {
+            unsigned u = trimmed[i];
+            if (isDone(u)) continue;
+            color[u].store(DONE, std::memory_order_relaxed);
+            component[u] = components++;
+            for (unsigned j = outOffsets[u]; j < outOffsets[u + 1]; j++)
+                if (--inDegree[outTargets[j]] == 0)
+                    trimmed.push_back(outTargets[j]);
+            for (unsigned j = inOffsets[u]; j < inOffsets[u + 1]; j++)
+                if (--outDegree[inSources[j]] == 0)
+                    trimmed.push_back(inSources[j]);
+        }
+    }
+
+    // Vertices not done reachable from s (along outgoing or incoming edges), marked in mark
+    auto reach = [&](unsigned s, std::vector<char> &mark, const std::vector<unsigned> &offsets,
+                     const std::vector<unsigned> &adj) {
+        std::vector<unsigned> queue{s};
+        mark[s] = true;
+        for (size_t head = 0; head < queue.size(); head++) {
+            unsigned u = queue[head];
+            for (unsigned j = offsets[u]; j < offsets[u + 1]; j++)
+                if (!mark[adj[j]] && !isDone(adj[j])) {
+                    mark[adj[j]] = true;
+                    queue.push_back(adj[j]);
+                }
+        }
+    };
+    {
+        TRACE_SCOPE("scc_forward_backward");
+        unsigned pivot = DONE;
+        uint64_t best = 0;
+        for (unsigned u = 0; u < n; u++) {
+            uint64_t degree = uint64_t(outOffsets[u + 1] - outOffsets[u]) * (inOffsets[u + 1] - inOffsets[u]);
+            if (!isDone(u) && degree > best) {
+                best = degree;
+                pivot = u;
+            }
+        }
+        if (pivot != DONE) {
+            std::vector<char> forward(n, false), backward(n, false);
+            TaskGroup group(pool);
+            group.spawn([&]() { reach(pivot, forward, outOffsets, outTargets); });
+            reach(pivot, backward, inOffsets, inSources);
+            group.sync();
+            unsigned id = components++;
+            for (unsigned u = 0; u < n; u++)
+                if (forward[u] && backward[u]) {
+                    color[u].store(DONE, std::memory_order_relaxed);
+                    component[u] = id;
+                }
+        }
+    }
+
+    TRACE_SCOPE("scc_coloring");
+    std::vector<unsigned> remaining;
+    for (unsigned u = 0; u < n; u++)
+        if (!isDone(u))
+            remaining.push_back(u);
+    while (!remaining.empty()) {
+        parallelFor(0, remaining.size(), [&](size_t i) {
+            color[remaining[i]].store(remaining[i], std::memory_order_relaxed);
+        }, 1024, pool);
+        std::atomic<bool> changed(true);
+        while (changed) {
+            changed = false;
+            parallelFor(0, remaining.size(), [&](size_t i) {
+                unsigned u = remaining[i];
+                unsigned c = color[u].load(std::memory_order_relaxed);
+                for (unsigned j = outOffsets[u]; j < outOffsets[u + 1]; j++) {
+                    // Done vertices have the largest color, so they are never changed
+                    std::atomic<unsigned> &cv = color[outTargets[j]];
+                    unsigned old = cv.load(std::memory_order_relaxed);
+                    while (old < c && !cv.compare_exchange_weak(old, c, std::memory_order_relaxed)) {}
+                    if (old < c)
+                        changed.store(true, std::memory_order_relaxed);
+                }
+            }, 1024, pool);
+        }
+        std::vector<unsigned> roots;
+        for (unsigned u : remaining)
+            if (color[u].load(std::memory_order_relaxed) == u)
+                roots.push_back(u);
+        // The component of each root: the vertices of its color that reach it
+        parallelFor(0, roots.size(), [&](size_t i) {
+            unsigned root = roots[i], id = components++;
+            std::vector<unsigned> queue{root};
+            color[root].store(DONE, std::memory_order_relaxed);
+            component[root] = id;
+            for (size_t head = 0; head < queue.size(); head++) {
+                unsigned u = queue[head];
+                for (unsigned j = inOffsets[u]; j < inOffsets[u + 1]; j++) {
+                    unsigned v = inSources[j];
+                    if (color[v].load(std::memory_order_relaxed) == root) {
+                        color[v].store(DONE, std::memory_order_relaxed);
+                        component[v] = id;
+                        queue.push_back(v);
+                    }
+                }
+            }
+        }, 1, pool);
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), isDone), remaining.end());
+    }
+    Components res;
+    res.count = components;
+    res.component = std::move(component);
+    return res;
+}
+
+/*
+ * Connected components (edges in any direction), with union-find: O(|E| alpha(|V|)).
+ * The components are numbered by their first vertex (by id), as in parallelConnectedComponents.
+ */
+template<class G>
+Components connectedComponents(const G &g) {
+    TRACE_SCOPE("connected_components");
+    const unsigned NONE = std::numeric_limits<unsigned>::max();
+    unsigned n = g.getNumVertex();
+    UnionFind sets(n);
+    for (unsigned u = 0; u < n; u++)
+        for (const auto &e : g.out(u))
+            sets.unite(u, g.target(e));
+    Components res;
+    res.component.resize(n);
+    std::vector<unsigned> id(n, NONE);  // component of each set representative
+    for (unsigned u = 0; u < n; u++) {
+        unsigned &c = id[sets.find(u)];
+        if (c == NONE)
+            c = res.count++;
+        res.component[u] = c;
+    }
+    return res;
+}
+
+/*
+ * Connected components (edges in any direction), in parallel in the pool, with the
+ * Afforest algorithm (Sutton, Ben-Nun and Barak, 2018): every vertex points to a lower
+ * vertex of its component, and the edges link the trees of their endpoints with
+ * compare-and-swap (Shiloach-Vishkin hooking, lower root wins), then the trees are
+ * flattened. The first NEIGHBOR_ROUNDS edges of each vertex are linked first, which
+ * usually joins most of the largest component; then, in undirected graphs (whose edges
+ * are seen from both endpoints), the other edges of the vertices of that component can
+ * be skipped. The components are numbered as in connectedComponents.
+ */
+template<class G>
+Components parallelConnectedComponents(const G &g, ThreadPool &pool = ThreadPool::global()) {
+    TRACE_SCOPE("afforest");
+    const unsigned NEIGHBOR_ROUNDS = 2, SAMPLES = 1024;
+    const size_t GRAIN = 4096;
+    unsigned n = g.getNumVertex();
+    std::unique_ptr<std::atomic<unsigned>[]> parent(new std::atomic<unsigned>[n]);
+    parallelFor(0, n, [&](size_t u) { parent[u].store(u, std::memory_order_relaxed); }, GRAIN, pool);
+
+    auto get = [&](unsigned u) { return parent[u].load(std::memory_order_relaxed); };
+    auto link = [&](unsigned u, unsigned v) {
+        unsigned p1 = get(u), p2 = get(v);
+        while (p1 != p2) {
+            unsigned high = std::max(p1, p2), low = std::min(p1, p2);
+            unsigned pHigh = get(high);
+            if (pHigh == low)
+                break;
+            if (pHigh == high && parent[high].compare_exchange_strong(pHigh, low, std::memory_order_relaxed))
+                break;
+            p1 = get(get(high));
+            p2 = get(low);
+        }
+    };
+    auto compress = [&](size_t u) {
+        unsigned p = get(u);
+        while (get(p) != p) {
+            p = get(p);
+            parent[u].store(p, std::memory_order_relaxed);
+        }
+    };
+    auto linkEdges = [&](unsigned u, size_t first, size_t last) {
+        const auto &adj = g.out(u);
+        for (size_t i = first; i < std::min(last, (size_t) adj.size()); i++)
+            link(u, g.target(adj[i]));
+    };
+
+    {
+        TRACE_SCOPE("afforest_neighbor_rounds");
+        for (unsigned r = 0; r < NEIGHBOR_ROUNDS; r++) {
+            parallelFor(0, n, [&](size_t u) { linkEdges(u, r, r + 1); }, GRAIN, pool);
+            parallelFor(0, n, compress, GRAIN, pool);
+        }
+    }
+    // Most frequent component in a sample of the vertices
+    const unsigned NONE = std::numeric_limits<unsigned>::max();
+    unsigned largest = NONE;
+    if (!G::directed && n > 0) {
+        std::mt19937 gen(n);
+        std::uniform_int_distribution<unsigned> vertex(0, n - 1);
+        std::vector<unsigned> sample(SAMPLES);
+        for (unsigned &s : sample)
+            s = get(vertex(gen));
+        std::sort(sample.begin(), sample.end());
+        size_t best = 0;
+        for (size_t i = 0, j; i < sample.size(); i = j) {
+            for (j = i; j < sample.size() && sample[j] == sample[i]; j++) {}
+            if (j - i > best) {
+                best = j - i;
+                largest = sample[i];
+            }
+        }
+    }
+    {
+        TRACE_SCOPE("afforest_remaining_edges");
+        parallelFor(0, n, [&](size_t u) {
+            if (get(u) != largest)
+                linkEdges(u, NEIGHBOR_ROUNDS, std::numeric_limits<size_t>::max());
+        }, GRAIN, pool);
+        parallelFor(0, n, compress, GRAIN, pool);
+    }
+
+    // Dense ids: each root is the lowest vertex of its component
+    Components res;
+    res.component.resize(n);
+    for (unsigned u = 0; u < n; u++)
+        res.component[u] = get(u) == u ? res.count++ : res.component[get(u)];
+    return res;
+}
+
+/*
+ * The DAG of the components of g: the vertex with id (and content) c is the component c,
+ * with an edge to each component that g has edges to, with the minimum weight of those edges.
+ */
+template<class G>
+Graph<unsigned, Weight<typename G::WeightType>> condensation(const G &g, const Components &scc) {
+    TRACE_SCOPE("condensation");
+    using W = typename G::WeightType;
+    const unsigned NONE = std::numeric_limits<unsigned>::max();
+    Graph<unsigned, Weight<W>> res;
+    for (unsigned c = 0; c < scc.count; c++)
+        res.appendVertex(c);
+    std::vector<unsigned> seen(scc.count, NONE);           // last component with an edge to it
+    std::vector<Edge<unsigned, Weight<W>> *> edge(scc.count);
+    for (const auto &members : scc.members())
+        for (unsigned u : members) {
+            unsigned c = scc.component[u];
+            for (const auto &e : g.out(u)) {
+                unsigned d = scc.component[g.target(e)];
+                if (d == c) continue;
+                if (seen[d] != c) {
+                    seen[d] = c;
+                    edge[d] = res.addEdgeById(c, d, g.weight(e));
+                } else if (g.weight(e) < edge[d]->weight) {
+                    edge[d]->weight = g.weight(e);
+                }
+            }
+        }
+    return res;
+}
+
+}
+
+#endif /* CAL_GRAPH_COMPONENTS_H_ */
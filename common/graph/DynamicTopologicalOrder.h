@@ -0,0 +1,173 @@
+/*
+ * DynamicTopologicalOrder.h
+ * Topological order of a DAG kept up to date as edges are added (Pearce and Kelly,
+ * "A dynamic topological sort algorithm for directed acyclic graphs", 2006): an edge that
+ * would close a cycle is rejected, and the others only reorder the vertices between the
+ * positions of their endpoints, instead of sorting the whole graph again.
+ */
+#ifndef CAL_GRAPH_DYNAMIC_TOPOLOGICAL_ORDER_H_
+#define CAL_GRAPH_DYNAMIC_TOPOLOGICAL_ORDER_H_
+
+#include <algorithm>
+#include <vector>
+#include "GraphStats.h"
+
+namespace cal {
+
+/**
+ * Vertices (ids 0 .. n-1) and edges of a DAG, with a topological order of the vertices.
+ */
+class DynamicTopologicalOrder {
+    std::vector<std::vector<unsigned>> out, in;
+    std::vector<unsigned> position;   // position of each vertex in the order
+    std::vector<unsigned> vertexAt;   // vertex at each position
+    std::vector<char> visited;
+    std::vector<unsigned> forward, backward, stack;
+
+    /*
+     * Depth-first search from s along the edges of adj, to the vertices whose position is
+     * within [lb, ub]; returns false if it reaches the vertex stop.
+     */
+    bool search(unsigned s, const std::vector<std::vector<unsigned>> &adj, unsigned lb, unsigned ub,
+                unsigned stop, std::vector<unsigned> &reached) {
+        stack.assign(1, s);
+        visited[s] = true;
+        reached.push_back(s);
+        while (!stack.empty()) {
+            unsigned u = stack.back();
+            stack.pop_back();
+            GRAPH_STATS_INC(verticesSettled);
+            for (unsigned w : adj[u]) {
+                if (w == stop)
+                    return false;
+                if (!visited[w] && position[w] >= lb && position[w] <= ub) {
+                    visited[w] = true;
+                    reached.push_back(w);
+                    stack.push_back(w);
+                }
+            }
+        }
+        return true;
+    }
+
+    void clearVisited() {
+        for (unsigned v : forward)
+            visited[v] = false;
+        for (unsigned v : backward)
+            visited[v] = false;
+    }
+
+public:
+    DynamicTopologicalOrder() = default;
+
+    explicit DynamicTopologicalOrder(unsigned n) {
+        for (unsigned v = 0; v < n; v++)
+            addVertex();
+    }
+
+    unsigned getNumVertex() const { return position.size(); }
+
+    /*
+     * Adds a vertex (at the end of the order); returns its id.
+     */
+    unsigned addVertex() {
+        unsigned v = position.size();
+        out.emplace_back();
+        in.emplace_back();
+        position.push_back(v);
+        vertexAt.push_back(v);
+        visited.push_back(false);
+        return v;
+    }
+
+    /*
+     * Adds the edge u -> v, unless it closes a cycle (then returns false, and nothing changes).
+     * The vertices between v and u in the order that reach u or are reached from v are
+     * moved so that the order stays topological.
+     */
+    bool addEdge(unsigned u, unsigned v) {
+        if (u == v)
+            return false;
+        unsigned lb = position[v], ub = position[u];
+        if (lb < ub) {
+            forward.clear();
+            backward.clear();
+            bool acyclic = search(v, out, lb, ub, u, forward);
+            if (acyclic)
+                search(u, in, lb, ub, v, backward);
+            clearVisited();
+            if (!acyclic)
+                return false;
+            // Both sets keep their relative order, and the ones that reach u go first
+            auto byPosition = [&](unsigned a, unsigned b) { return position[a] < position[b]; };
+            std::sort(forward.begin(), forward.end(), byPosition);
+            std::sort(backward.begin(), backward.end(), byPosition);
+            std::vector<unsigned> positions;
+            positions.reserve(forward.size() + backward.size());
+            for (unsigned w : backward)
+                positions.push_back(position[w]);
+            for (unsigned w : forward)
+                positions.push_back(position[w]);
+            std::sort(positions.begin(), positions.end());
+            size_t i = 0;
+            for (auto *set : {&backward, &forward})
+                for (unsigned w : *set) {
+                    position[w] = positions[i++];
+                    vertexAt[position[w]] = w;
+                }
+        }
+        out[u].push_back(v);
+        in[v].push_back(u);
+        return true;
+    }
+
+    /*
+     * Removes (one copy of) the edge u -> v; the order stays topological.
+     */
+    bool removeEdge(unsigned u, unsigned v) {
+        auto it = std::find(out[u].begin(), out[u].end(), v);
+        if (it == out[u].end())
+            return false;
+        out[u].erase(it);
+        in[v].erase(std::find(in[v].begin(), in[v].end(), u));
+        return true;
+    }
+
+    /*
+     * Removes the vertex v and its edges; the ids of the following vertices move down by one.
+     */
+    void removeVertex(unsigned v) {
+        for (unsigned w : out[v])
+            in[w].erase(std::find(in[w].begin(), in[w].end(), v));
+        for (unsigned w : in[v])
+            out[w].erase(std::find(out[w].begin(), out[w].end(), v));
+        out.erase(out.begin() + v);
+        in.erase(in.begin() + v);
+        visited.pop_back();
+        vertexAt.erase(vertexAt.begin() + position[v]);
+        position.pop_back();
+        auto renumber = [v](unsigned &w) { if (w > v) w--; };
+        for (auto &adj : out)
+            std::for_each(adj.begin(), adj.end(), renumber);
+        for (auto &adj : in)
+            std::for_each(adj.begin(), adj.end(), renumber);
+        for (unsigned p = 0; p < vertexAt.size(); p++) {
+            renumber(vertexAt[p]);
+            position[vertexAt[p]] = p;
+        }
+    }
+
+    /*
+     * Position of v in the order.
+     */
+    unsigned getPosition(unsigned v) const { return position[v]; }
+
+    /*
+     * Ids of the vertices in topological order.
+     */
+    const std::vector<unsigned> &getOrder() const { return vertexAt; }
+};
+
+}
+
+#endif /* CAL_GRAPH_DYNAMIC_TOPOLOGICAL_ORDER_H_ */
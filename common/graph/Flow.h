@@ -0,0 +1,549 @@
+/*
+ * Flow.h
+ * Maximum flow (Edmonds-Karp) and minimum cost flow (successive shortest paths) in flow
+ * networks: adjacency list graphs with Flow or CostFlow payloads, whose vertices also keep
+ * their incoming edges (the residual graph is traversed in both directions).
+ * The result is defined by the "flow" field of each edge; after capacity changes
+ * (updateCapacity), augmentFlow resumes from that flow instead of starting over.
+ * The minimum cut of a maximum flow is read from its residual graph (minCut), and the minimum
+ * cuts between all pairs of vertices come from a Gomory-Hu tree (|V| - 1 maximum flows).
+ * Capacities, flows and costs have the weight type W of the payload: with integer types,
+ * flows and costs (and the potentials of the shortest path searches) are exact.
+ */
+#ifndef CAL_GRAPH_FLOW_H_
+#define CAL_GRAPH_FLOW_H_
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <vector>
+#include "Graph.h"
+#include "SearchContext.h"
+#include "WeightTraits.h"
+#include "GraphStats.h"
+#include "Trace.h"
+
+namespace cal {
+
+namespace detail {
+
+/*
+ * Type of the path costs of the min cost flow searches: signed (residual edges traversed
+ * backwards have the opposite cost), exact for integer costs.
+ */
+template<class W>
+using CostOf = typename std::conditional<std::is_unsigned<W>::value, int64_t, DistOf<W>>::type;
+
+/*
+ * Edge used to reach each vertex in the last search, and the vertex it comes from.
+ */
+template<class G>
+struct ResidualPath {
+    using EdgeType = typename G::EdgeType;
+    std::vector<EdgeType *> edge;
+
+    explicit ResidualPath(unsigned n) : edge(n, nullptr) {}
+
+    static unsigned previous(const EdgeType *e, unsigned v) {
+        return e->getDest()->getId() == v ? e->getOrig()->getId() : e->getDest()->getId();
+    }
+
+    typename G::WeightType minResidual(unsigned s, unsigned t) const {
+        typename G::WeightType f = residual(edge[t], t);
+        for (unsigned v = t; v != s; v = previous(edge[v], v))
+            f = std::min(f, residual(edge[v], v));
+        return f;
+    }
+
+    /*
+     * Residual capacity of e, when used to reach v.
+     */
+    static typename G::WeightType residual(const EdgeType *e, unsigned v) {
+        return e->getDest()->getId() == v ? e->capacity - e->flow : e->flow;
+    }
+
+    void augment(unsigned s, unsigned t, typename G::WeightType f) {
+        TRACE_SCOPE("augment_flow");
+        for (unsigned v = t; v != s;) {
+            EdgeType *e = edge[v];
+            unsigned u = previous(e, v);
+            if (e->getDest()->getId() == v)
+                e->flow += f;
+            else
+                e->flow -= f;
+            v = u;
+        }
+    }
+};
+
+/*
+ * Cost of sending f units of flow along a path of the given cost.
+ */
+template<class Cost, class W>
+Cost times(Cost cost, W f) {
+    return cost * static_cast<Cost>(f);
+}
+
+template<unsigned FRAC_BITS, class W>
+Fixed<FRAC_BITS, int64_t> times(Fixed<FRAC_BITS, int64_t> cost, W f) {
+    return Fixed<FRAC_BITS, int64_t>::fromRaw(std::llround(cost.getRaw() * static_cast<double>(f)));
+}
+
+template<class G>
+void resetFlows(G &g) {
+    for (auto v : g.getVertexSet())
+        for (auto e : v->getAdj())
+            e->flow = typename G::WeightType(0);
+}
+
+/*
+ * Vertices reached from s in the residual graph (marked visited in ctx), in breadth-first order.
+ */
+template<class G>
+void residualReach(const G &g, unsigned s, SearchContext &ctx, std::vector<unsigned> &reached) {
+    using W = typename G::WeightType;
+    ctx.reset(g.getNumVertex());
+    ctx[s].visited = true;
+    reached.assign(1, s);
+    auto visit = [&](unsigned w, W residual) {
+        if (residual > W(0) && !ctx[w].visited) {
+            ctx[w].visited = true;
+            reached.push_back(w);
+        }
+    };
+    for (size_t head = 0; head < reached.size(); head++) {
+        auto v = g.getVertex(reached[head]);
+        for (auto e : v->getOutgoing())
+            visit(e->getDest()->getId(), e->capacity - e->flow);
+        for (auto e : v->getIncoming())
+            visit(e->getOrig()->getId(), e->flow);
+    }
+}
+
+/*
+ * Breadth-first search in the residual graph (outgoing edges with residual capacity,
+ * then incoming edges with flow), until t is reached.
+ */
+template<class G>
+bool findAugmentingPath(const G &g, unsigned s, unsigned t, ResidualPath<G> &path, SearchContext &ctx) {
+    TRACE_SCOPE("augmenting_path_search");
+    GRAPH_STATS_INC(pathSearches);
+    ctx.reset(g.getNumVertex());
+    ctx[s].visited = true;
+    std::queue<unsigned> q;
+    q.push(s);
+    auto visit = [&](typename G::EdgeType *e, unsigned w, typename G::WeightType residual) {
+        if (residual > typename G::WeightType(0) && !ctx[w].visited) {
+            ctx[w].visited = true;
+            path.edge[w] = e;
+            q.push(w);
+        }
+    };
+    while (!q.empty() && !ctx[t].visited) {
+        auto v = g.getVertex(q.front());
+        q.pop();
+        GRAPH_STATS_INC(verticesSettled);
+        for (auto e : v->getOutgoing())
+            visit(e, e->getDest()->getId(), e->capacity - e->flow);
+        for (auto e : v->getIncoming())
+            visit(e, e->getOrig()->getId(), e->flow);
+    }
+    return ctx[t].visited;
+}
+
+/*
+ * Sends up to limit units of flow from "from" to "to" along augmenting paths of the residual
+ * graph (the other vertices stay balanced); returns the amount sent.
+ */
+template<class G>
+typename G::WeightType pushFlow(G &g, unsigned from, unsigned to, typename G::WeightType limit,
+                                ResidualPath<G> &path, SearchContext &ctx) {
+    using W = typename G::WeightType;
+    W pushed(0);
+    while (pushed < limit && findAugmentingPath(g, from, to, path, ctx)) {
+        GRAPH_STATS_INC(augmentingPaths);
+        W f = std::min(path.minResidual(from, to), W(limit - pushed));
+        path.augment(from, to, f);
+        pushed += f;
+    }
+    return pushed;
+}
+
+/*
+ * Shortest paths by cost in the residual graph (edges traversed backwards count with
+ * negative cost), with costs reduced by the vertex potentials: Dijkstra if the reduced
+ * costs are non-negative, Bellman-Ford otherwise.
+ */
+template<class G>
+void residualShortestPaths(const G &g, unsigned s, const std::vector<CostOf<typename G::WeightType>> &potential,
+                           bool negativeCosts, ResidualPath<G> &path,
+                           BasicSearchContext<CostOf<typename G::WeightType>> &ctx) {
+    using W = typename G::WeightType;
+    using Cost = CostOf<W>;
+    ctx.reset(g.getNumVertex());
+    ctx[s].dist = Cost(0);
+    // Relaxes the residual edge e from v to w; returns true if the distance of w decreased
+    auto relax = [&](unsigned v, unsigned w, typename G::EdgeType *e, W residual, Cost cost) {
+        Cost dist = ctx[v].dist + cost + potential[v] - potential[w];
+        if (residual > W(0) && dist < ctx[w].dist) {
+            GRAPH_STATS_INC(relaxations);
+            ctx[w].dist = dist;
+            path.edge[w] = e;
+            return true;
+        }
+        return false;
+    };
+    if (negativeCosts) {
+        TRACE_SCOPE("bellman_ford");
+        for (int i = 1; i < g.getNumVertex(); i++) {
+            bool changed = false;
+            for (auto v : g.getVertexSet()) {
+                unsigned u = v->getId();
+                if (ctx[u].dist == WeightTraits<Cost>::infinity()) continue;
+                for (auto e : v->getOutgoing())
+                    changed |= relax(u, e->getDest()->getId(), e, e->capacity - e->flow, static_cast<Cost>(e->cost));
+                for (auto e : v->getIncoming())
+                    changed |= relax(u, e->getOrig()->getId(), e, e->flow, -static_cast<Cost>(e->cost));
+            }
+            if (!changed) break;
+        }
+        return;
+    }
+    TRACE_SCOPE("dijkstra");
+    ctx.insert(s);
+    auto update = [&](unsigned w) {
+        if (ctx[w].queueIndex == 0)
+            ctx.insert(w);
+        else
+            ctx.decreaseKey(w);
+    };
+    while (!ctx.empty()) {
+        unsigned u = ctx.extractMin();
+        GRAPH_STATS_INC(verticesSettled);
+        auto v = g.getVertex(u);
+        for (auto e : v->getOutgoing())
+            if (relax(u, e->getDest()->getId(), e, e->capacity - e->flow, static_cast<Cost>(e->cost)))
+                update(e->getDest()->getId());
+        for (auto e : v->getIncoming())
+            if (relax(u, e->getOrig()->getId(), e, e->flow, -static_cast<Cost>(e->cost)))
+                update(e->getOrig()->getId());
+    }
+}
+
+}
+
+/*
+ * Maximum flow from s to t, starting from the flow already in g (which must be a feasible
+ * flow from s to t, e.g. a maximum flow before some capacities changed): only the augmenting
+ * paths still missing are searched. Returns the value added to the flow.
+ */
+template<class G>
+DistOf<typename G::WeightType> augmentFlow(G &g, unsigned s, unsigned t, SearchContext &ctx = SearchContext::local()) {
+    TRACE_SCOPE("resume_max_flow");
+    using Traits = WeightTraits<typename G::WeightType>;
+    detail::ResidualPath<G> path(g.getNumVertex());
+    auto total = Traits::zero();
+    while (detail::findAugmentingPath(g, s, t, path, ctx)) {
+        GRAPH_STATS_INC(augmentingPaths);
+        auto f = path.minResidual(s, t);
+        path.augment(s, t, f);
+        total = Traits::add(total, f);
+    }
+    return total;
+}
+
+/*
+ * Maximum flow from s to t (distinct vertices), with the Ford-Fulkerson algorithm
+ * (augmenting paths found by breadth-first search, as in Edmonds-Karp).
+ * Returns the value of the flow.
+ */
+template<class G>
+DistOf<typename G::WeightType> maxFlow(G &g, unsigned s, unsigned t, SearchContext &ctx = SearchContext::local()) {
+    TRACE_SCOPE("ford_fulkerson");
+    detail::resetFlows(g);
+    return augmentFlow(g, s, t, ctx);
+}
+
+/*
+ * Value of the flow from s in g: what leaves s minus what enters it.
+ */
+template<class G>
+DistOf<typename G::WeightType> flowValue(const G &g, unsigned s) {
+    using Traits = WeightTraits<typename G::WeightType>;
+    auto out = Traits::zero(), in = Traits::zero();
+    auto v = g.getVertex(s);
+    for (auto e : v->getOutgoing())
+        out = Traits::add(out, e->flow);
+    for (auto e : v->getIncoming())
+        in = Traits::add(in, e->flow);
+    return out - in;
+}
+
+/*
+ * Changes the capacity of the edge e of g, which holds a feasible flow from s to t, keeping
+ * the flow feasible. If the flow of e exceeds the new capacity, the excess is first rerouted
+ * around e in the residual graph; what cannot be is sent back from the origin of e to s, and
+ * taken from t to the destination of e, along residual paths (they always exist). Returns the
+ * value the flow lost, so a maximum flow stays one when it is 0; otherwise augmentFlow
+ * completes it. A higher capacity keeps the flow as it is: augmentFlow then only finds the
+ * paths through the edges that changed.
+ */
+template<class G>
+typename G::WeightType updateCapacity(G &g, typename G::EdgeType *e, typename G::WeightType capacity,
+                                      unsigned s, unsigned t, SearchContext &ctx = SearchContext::local()) {
+    TRACE_SCOPE("update_capacity");
+    using W = typename G::WeightType;
+    e->capacity = capacity;
+    if (!(e->flow > capacity))
+        return W(0);
+    W excess = e->flow - capacity;
+    e->flow = capacity;
+    unsigned u = e->getOrig()->getId(), v = e->getDest()->getId();
+    if (u == v)
+        return W(0);
+    detail::ResidualPath<G> path(g.getNumVertex());
+    W lost = excess - detail::pushFlow(g, u, v, excess, path, ctx);
+    if (lost > W(0)) {
+        if (u != s)
+            detail::pushFlow(g, u, s, lost, path, ctx);
+        if (v != t)
+            detail::pushFlow(g, t, v, lost, path, ctx);
+    }
+    return lost;
+}
+
+/**
+ * Minimum cut between the source and the target of a maximum flow: the vertices on the side
+ * of the source (by increasing id) and the edges from them to the other side, all saturated,
+ * whose capacities add up to the value of the flow.
+ */
+template<class G>
+struct MinCut {
+    std::vector<unsigned> sourceSide;
+    std::vector<typename G::EdgeType *> edges;
+    DistOf<typename G::WeightType> capacity;
+};
+
+/*
+ * Minimum cut left by the last maximum flow from s computed in g (e.g. by maxFlow): the
+ * source side is what s still reaches in the residual graph. O(|V| + |E|), no flow computation.
+ */
+template<class G>
+MinCut<G> minCut(const G &g, unsigned s, SearchContext &ctx = SearchContext::local()) {
+    TRACE_SCOPE("min_cut");
+    using Traits = WeightTraits<typename G::WeightType>;
+    MinCut<G> res;
+    res.capacity = Traits::zero();
+    detail::residualReach(g, s, ctx, res.sourceSide);
+    std::sort(res.sourceSide.begin(), res.sourceSide.end());
+    for (unsigned u : res.sourceSide)
+        for (auto e : g.getVertex(u)->getOutgoing())
+            if (!ctx.get(e->getDest()->getId()).visited) {
+                res.edges.push_back(e);
+                res.capacity = Traits::add(res.capacity, e->capacity);
+            }
+    return res;
+}
+
+/**
+ * Gomory-Hu tree of a flow network taken as undirected (an edge u -> v of capacity c links u
+ * and v with capacity c in both directions; parallel links add up): a tree on the same
+ * vertices in which the minimum cut between any two of them is the lightest edge in the path
+ * between them. Built with Gusfield's algorithm: |V| - 1 maximum flows on a copy of the
+ * network, without contracting it.
+ */
+template<class W>
+class GomoryHuTree {
+public:
+    using FlowType = DistOf<W>;
+
+    template<class G>
+    explicit GomoryHuTree(const G &g);
+
+    unsigned getNumVertex() const { return parent.size(); }
+
+    /*
+     * Parent of v in the tree (-1 for the root, vertex 0), and the minimum cut between them.
+     */
+    int getParent(unsigned v) const { return parent[v]; }
+
+    FlowType getWeight(unsigned v) const { return weight[v]; }
+
+    /*
+     * Minimum cut between u and v (infinite if u == v), in O(|V|).
+     */
+    FlowType minCut(unsigned u, unsigned v) const;
+
+    /*
+     * Minimum cuts between all pairs of vertices (|V| x |V| matrix, by rows), in O(|V|^2).
+     */
+    std::vector<FlowType> allPairs() const;
+
+    /*
+     * Smallest minimum cut between two vertices (infinite below two vertices).
+     */
+    FlowType globalMinCut() const;
+
+private:
+    std::vector<int> parent;
+    std::vector<FlowType> weight;
+    std::vector<unsigned> depth;
+};
+
+template<class W>
+template<class G>
+GomoryHuTree<W>::GomoryHuTree(const G &g) {
+    TRACE_SCOPE("gomory_hu_tree");
+    unsigned n = g.getNumVertex();
+    Graph<unsigned, Flow<W>> network;
+    for (unsigned v = 0; v < n; v++)
+        network.appendVertex(v);
+    for (auto v : g.getVertexSet())
+        for (auto e : v->getOutgoing()) {
+            unsigned u = v->getId(), w = e->getDest()->getId();
+            if (u != w) {
+                network.addEdgeById(u, w, Flow<W>(e->capacity));
+                network.addEdgeById(w, u, Flow<W>(e->capacity));
+            }
+        }
+    parent.assign(n, 0);
+    weight.assign(n, WeightTraits<FlowType>::infinity());
+    if (n > 0)
+        parent[0] = -1;
+    SearchContext ctx;
+    std::vector<unsigned> side;
+    for (unsigned s = 1; s < n; s++) {
+        unsigned t = parent[s];
+        FlowType f = maxFlow(network, s, t, ctx);
+        detail::residualReach(network, s, ctx, side);
+        weight[s] = f;
+        for (unsigned v : side)
+            if (v != s && parent[v] == (int) t)
+                parent[v] = s;
+        if (parent[t] >= 0 && ctx.get(parent[t]).visited) {
+            parent[s] = parent[t];
+            parent[t] = s;
+            weight[s] = weight[t];
+            weight[t] = f;
+        }
+    }
+    // Depths, by a breadth-first search from the root
+    std::vector<std::vector<unsigned>> children(n);
+    for (unsigned v = 1; v < n; v++)
+        children[parent[v]].push_back(v);
+    depth.assign(n, 0);
+    std::vector<unsigned> order(n > 0 ? 1 : 0, 0);
+    for (size_t head = 0; head < order.size(); head++)
+        for (unsigned c : children[order[head]]) {
+            depth[c] = depth[order[head]] + 1;
+            order.push_back(c);
+        }
+}
+
+template<class W>
+typename GomoryHuTree<W>::FlowType GomoryHuTree<W>::minCut(unsigned u, unsigned v) const {
+    FlowType res = WeightTraits<FlowType>::infinity();
+    while (u != v) {
+        if (depth[u] < depth[v])
+            std::swap(u, v);
+        res = std::min(res, weight[u]);
+        u = parent[u];
+    }
+    return res;
+}
+
+template<class W>
+std::vector<typename GomoryHuTree<W>::FlowType> GomoryHuTree<W>::allPairs() const {
+    unsigned n = getNumVertex();
+    std::vector<std::vector<unsigned>> children(n);
+    for (unsigned v = 0; v < n; v++)
+        if (parent[v] >= 0)
+            children[parent[v]].push_back(v);
+    // From each vertex, the lightest edge so far along the tree, by a search over its edges
+    std::vector<FlowType> res((size_t) n * n, WeightTraits<FlowType>::infinity());
+    std::vector<unsigned> stack;
+    for (unsigned s = 0; s < n; s++) {
+        FlowType *row = res.data() + (size_t) s * n;
+        std::vector<bool> seen(n, false);
+        seen[s] = true;
+        stack.assign(1, s);
+        while (!stack.empty()) {
+            unsigned u = stack.back();
+            stack.pop_back();
+            auto reach = [&](unsigned v, FlowType w) {
+                if (!seen[v]) {
+                    seen[v] = true;
+                    row[v] = std::min(u == s ? WeightTraits<FlowType>::infinity() : row[u], w);
+                    stack.push_back(v);
+                }
+            };
+            if (parent[u] >= 0)
+                reach(parent[u], weight[u]);
+            for (unsigned c : children[u])
+                reach(c, weight[c]);
+        }
+    }
+    return res;
+}
+
+template<class W>
+typename GomoryHuTree<W>::FlowType GomoryHuTree<W>::globalMinCut() const {
+    FlowType res = WeightTraits<FlowType>::infinity();
+    for (unsigned v = 0; v < getNumVertex(); v++)
+        if (parent[v] >= 0)
+            res = std::min(res, weight[v]);
+    return res;
+}
+
+/*
+ * Minimum cost flow from s to t (distinct vertices): sends the intended flow (or the
+ * highest possible flow, if the network does not support it) along successive shortest
+ * paths by cost: Bellman-Ford for the first one (costs may be negative), then Dijkstra
+ * with costs reduced by vertex potentials (edge costs are not modified).
+ * Returns the cost of the flow (of type detail::CostOf<W>: double for double costs,
+ * int64_t for integer costs).
+ */
+template<class G>
+detail::CostOf<typename G::WeightType> minCostFlow(
+        G &g, unsigned s, unsigned t, DistOf<typename G::WeightType> flow,
+        BasicSearchContext<detail::CostOf<typename G::WeightType>> &ctx =
+                BasicSearchContext<detail::CostOf<typename G::WeightType>>::local()) {
+    TRACE_SCOPE("min_cost_flow");
+    using W = typename G::WeightType;
+    using Cost = detail::CostOf<W>;
+    using Flow = DistOf<W>;
+    const Cost INFINITE_COST = WeightTraits<Cost>::infinity();
+    unsigned n = g.getNumVertex();
+    detail::resetFlows(g);
+    detail::ResidualPath<G> path(n);
+    std::vector<Cost> potential(n, Cost(0));
+
+    Flow totalFlow = WeightTraits<W>::zero();
+    Cost totalCost = Cost(0);
+    GRAPH_STATS_INC(pathSearches);
+    detail::residualShortestPaths(g, s, potential, true, path, ctx);
+    while (totalFlow < flow && ctx.get(t).dist != INFINITE_COST) {
+        GRAPH_STATS_INC(augmentingPaths);
+        W f = static_cast<W>(std::min(static_cast<Flow>(path.minResidual(s, t)), flow - totalFlow));
+        Cost cost = Cost(0);
+        for (unsigned v = t; v != s; v = path.previous(path.edge[v], v)) {
+            Cost c = static_cast<Cost>(path.edge[v]->cost);
+            cost = path.edge[v]->getDest()->getId() == v ? cost + c : cost - c;
+        }
+        totalCost = totalCost + detail::times(cost, f);
+        path.augment(s, t, f);
+        totalFlow = WeightTraits<W>::add(totalFlow, f);
+
+        // Vertices unreachable now stay unreachable, so their potential does not matter
+        for (unsigned v = 0; v < n; v++)
+            if (ctx.get(v).dist != INFINITE_COST)
+                potential[v] = potential[v] + ctx.get(v).dist;
+        GRAPH_STATS_INC(pathSearches);
+        detail::residualShortestPaths(g, s, potential, false, path, ctx);
+    }
+    return totalCost;
+}
+
+}
+
+#endif /* CAL_GRAPH_FLOW_H_ */
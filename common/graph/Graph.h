@@ -0,0 +1,620 @@
+/*
+ * Graph.h
+ * Graph data structure shared by the TP classes (namespace cal), configured by policies:
+ *   - edge payload: Weight<W>, Flow<W> or CostFlow<W>, where W is the weight type
+ *     (double, float, an integer type or Fixed, see WeightTraits.h);
+ *   - direction: Directed or Undirected (addEdge also adds the reverse edge);
+ *   - storage: AdjacencyList (mutable, edges owned by their origin vertex) or
+ *     Csr (compressed sparse rows, immutable, built from an adjacency list graph).
+ *
+ * The algorithms (Traversal.h, ShortestPaths.h, SpanningTree.h, Flow.h) identify the
+ * vertices by their dense ids (0 .. n-1) and only use the following "view" of a graph,
+ * which both storages (and GraphSnapshot, in TP6) provide:
+ *   g.getNumVertex()   number of vertices
+ *   g.out(u)           outgoing edges of u (a random access range of edge handles)
+ *   g.target(e)        id of the destination of the edge e
+ *   g.weight(e)        weight of the edge e (Weight payloads)
+ *
+ * Large graphs can be renumbered with Graph::reorder (see Reorder.h), so that vertices close
+ * in the graph are also close in memory.
+ */
+#ifndef CAL_GRAPH_GRAPH_H_
+#define CAL_GRAPH_GRAPH_H_
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "SearchContext.h"
+#include "Reorder.h"
+#include "WeightTraits.h"
+
+namespace cal {
+
+/************************* Policies  **************************/
+
+struct Directed {
+    static constexpr bool directed = true;
+};
+
+struct Undirected {
+    static constexpr bool directed = false;
+};
+
+struct AdjacencyList {};
+
+struct Csr {};
+
+/**
+ * Weighted edges (shortest paths, spanning trees).
+ */
+template<class W = double>
+struct Weight {
+    using WeightType = W;
+    static constexpr bool residual = false;  // flow algorithms also need the incoming edges
+
+    W weight;
+
+    Weight(W weight = W()) : weight(weight) {}
+
+    W getWeight() const { return weight; }
+};
+
+/**
+ * Edges of a flow network.
+ */
+template<class W = double>
+struct Flow {
+    using WeightType = W;
+    static constexpr bool residual = true;
+
+    W capacity;
+    W flow;
+
+    Flow(W capacity = W(), W flow = W()) : capacity(capacity), flow(flow) {}
+
+    W getCapacity() const { return capacity; }
+
+    W getFlow() const { return flow; }
+};
+
+/**
+ * Edges of a flow network with a cost per unit of flow.
+ */
+template<class W = double>
+struct CostFlow : Flow<W> {
+    W cost;
+
+    CostFlow(W capacity = W(), W cost = W(), W flow = W()) : Flow<W>(capacity, flow), cost(cost) {}
+
+    W getCost() const { return cost; }
+};
+
+template<class T, class P = Weight<>, class D = Directed, class S = AdjacencyList>
+class Graph;
+
+template<class T, class P, class D>
+class Edge;
+
+/************************* Vertex  **************************/
+
+template<class T, class P = Weight<>, class D = Directed>
+class Vertex {
+public:
+    using EdgeType = Edge<T, P, D>;
+
+    const T &getInfo() const { return info; }
+
+    unsigned getId() const { return id; }
+
+    const std::vector<EdgeType *> &getAdj() const { return adj; }
+
+    const std::vector<EdgeType *> &getOutgoing() const { return adj; }
+
+    const std::vector<EdgeType *> &getIncoming() const { return incoming; }
+
+    double getDist() const { return dist; }
+
+    Vertex *getPath() const { return path; }
+
+private:
+    T info;
+    unsigned id;                        // index in the vertex set
+    std::vector<EdgeType *> adj;        // outgoing edges (owned)
+    std::vector<EdgeType *> incoming;   // only kept for residual (flow) payloads
+
+    // Results of the last search published with Graph::publish
+    double dist = 0;
+    Vertex *path = nullptr;
+
+    Vertex(const T &info, unsigned id) : info(info), id(id) {}
+
+    friend class Graph<T, P, D, AdjacencyList>;
+};
+
+/************************* Edge  **************************/
+
+/**
+ * The payload fields (weight, capacity, flow, cost) are members of the edge.
+ */
+template<class T, class P = Weight<>, class D = Directed>
+class Edge : public P {
+public:
+    using VertexType = Vertex<T, P, D>;
+
+    VertexType *getOrig() const { return orig; }
+
+    VertexType *getDest() const { return dest; }
+
+    /*
+     * The opposite edge of an undirected edge (nullptr for directed ones).
+     */
+    Edge *getReverse() const { return reverse; }
+
+private:
+    VertexType *orig;
+    VertexType *dest;
+    Edge *reverse = nullptr;
+
+    Edge(VertexType *orig, VertexType *dest, const P &payload) : P(payload), orig(orig), dest(dest) {}
+
+    friend class Graph<T, P, D, AdjacencyList>;
+};
+
+/************************* Graph (adjacency lists)  **************************/
+
+template<class T, class P, class D>
+class Graph<T, P, D, AdjacencyList> {
+public:
+    using VertexType = Vertex<T, P, D>;
+    using EdgeType = Edge<T, P, D>;
+    using PayloadType = P;
+    using WeightType = typename P::WeightType;
+    static constexpr bool directed = D::directed;
+
+    Graph() = default;
+
+    Graph(const Graph &other);
+
+    Graph(Graph &&other) noexcept;
+
+    Graph &operator=(Graph other);
+
+    ~Graph();
+
+    int getNumVertex() const;
+
+    const std::vector<VertexType *> &getVertexSet() const;
+
+    VertexType *getVertex(unsigned id) const;
+
+    VertexType *findVertex(const T &in) const;
+
+    int findVertexId(const T &in) const;
+
+    VertexType *addVertex(const T &in);
+
+    VertexType *appendVertex(const T &in);
+
+    bool removeVertex(const T &in);
+
+    EdgeType *addArc(const T &source, const T &dest, const P &payload);
+
+    EdgeType *addEdge(const T &source, const T &dest, const P &payload);
+
+    EdgeType *addEdgeById(unsigned source, unsigned dest, const P &payload);
+
+    bool removeEdge(const T &source, const T &dest);
+
+    void reorder(const std::vector<unsigned> &order);
+
+    std::vector<unsigned> reorder(VertexOrder strategy, const std::vector<std::pair<double, double>> &coordinates = {});
+
+    template<class Dist>
+    void publish(const BasicSearchContext<Dist> &ctx);
+
+    size_t memoryBytes() const;
+
+    // View used by the algorithms
+    const std::vector<EdgeType *> &out(unsigned u) const { return vertexSet[u]->adj; }
+
+    unsigned target(const EdgeType *e) const { return e->dest->id; }
+
+    WeightType weight(const EdgeType *e) const { return e->weight; }
+
+    const T &getInfo(unsigned u) const { return vertexSet[u]->info; }
+
+protected:
+    std::vector<VertexType *> vertexSet;
+
+private:
+    void copyVertices(const Graph &other, const std::vector<unsigned> &order);
+
+    EdgeType *link(VertexType *u, VertexType *v, const P &payload);
+
+    void unlink(EdgeType *e);
+};
+
+template<class T, class P, class D>
+Graph<T, P, D, AdjacencyList>::Graph(const Graph &other) {
+    std::vector<unsigned> order(other.vertexSet.size());
+    for (unsigned id = 0; id < order.size(); id++)
+        order[id] = id;
+    copyVertices(other, order);
+}
+
+template<class T, class P, class D>
+Graph<T, P, D, AdjacencyList>::Graph(Graph &&other) noexcept : vertexSet(std::move(other.vertexSet)) {
+    other.vertexSet.clear();
+}
+
+template<class T, class P, class D>
+Graph<T, P, D, AdjacencyList> &Graph<T, P, D, AdjacencyList>::operator=(Graph other) {
+    std::swap(vertexSet, other.vertexSet);
+    return *this;
+}
+
+template<class T, class P, class D>
+Graph<T, P, D, AdjacencyList>::~Graph() {
+    for (auto v : vertexSet) {
+        for (auto e : v->adj)
+            delete e;
+        delete v;
+    }
+}
+
+template<class T, class P, class D>
+int Graph<T, P, D, AdjacencyList>::getNumVertex() const {
+    return vertexSet.size();
+}
+
+template<class T, class P, class D>
+const std::vector<Vertex<T, P, D> *> &Graph<T, P, D, AdjacencyList>::getVertexSet() const {
+    return vertexSet;
+}
+
+template<class T, class P, class D>
+Vertex<T, P, D> *Graph<T, P, D, AdjacencyList>::getVertex(unsigned id) const {
+    return vertexSet[id];
+}
+
+/*
+ * Auxiliary function to find a vertex with a given content.
+ */
+template<class T, class P, class D>
+Vertex<T, P, D> *Graph<T, P, D, AdjacencyList>::findVertex(const T &in) const {
+    for (auto v : vertexSet)
+        if (v->info == in)
+            return v;
+    return nullptr;
+}
+
+/*
+ * Id of the vertex with a given content, or -1 if it does not exist.
+ */
+template<class T, class P, class D>
+int Graph<T, P, D, AdjacencyList>::findVertexId(const T &in) const {
+    VertexType *v = findVertex(in);
+    return v == nullptr ? -1 : (int) v->id;
+}
+
+/*
+ * Adds a vertex with a given content; returns nullptr if a vertex with that content already exists.
+ */
+template<class T, class P, class D>
+Vertex<T, P, D> *Graph<T, P, D, AdjacencyList>::addVertex(const T &in) {
+    if (findVertex(in) != nullptr)
+        return nullptr;
+    return appendVertex(in);
+}
+
+/*
+ * Adds a vertex without checking if its content is already in the graph (for loading large
+ * graphs, whose contents are known to be distinct: addVertex takes linear time).
+ */
+template<class T, class P, class D>
+Vertex<T, P, D> *Graph<T, P, D, AdjacencyList>::appendVertex(const T &in) {
+    auto v = new VertexType(in, vertexSet.size());
+    vertexSet.push_back(v);
+    return v;
+}
+
+/*
+ * Removes a vertex and all its outgoing and incoming edges (the ids of the following
+ * vertices move down by one). Returns false if there is no such vertex.
+ */
+template<class T, class P, class D>
+bool Graph<T, P, D, AdjacencyList>::removeVertex(const T &in) {
+    VertexType *v = findVertex(in);
+    if (v == nullptr)
+        return false;
+    for (auto u : vertexSet) {
+        if (u == v) continue;
+        for (size_t i = 0; i < u->adj.size();) {
+            if (u->adj[i]->dest == v)
+                unlink(u->adj[i]);
+            else
+                i++;
+        }
+    }
+    while (!v->adj.empty())
+        unlink(v->adj.back());
+    vertexSet.erase(vertexSet.begin() + v->id);
+    for (unsigned id = v->id; id < vertexSet.size(); id++)
+        vertexSet[id]->id = id;
+    delete v;
+    return true;
+}
+
+/*
+ * Adds an edge from source to dest, in one direction only (whatever the direction policy).
+ * Returns nullptr if any of the vertices does not exist.
+ */
+template<class T, class P, class D>
+Edge<T, P, D> *Graph<T, P, D, AdjacencyList>::addArc(const T &source, const T &dest, const P &payload) {
+    VertexType *u = findVertex(source);
+    VertexType *v = findVertex(dest);
+    if (u == nullptr || v == nullptr)
+        return nullptr;
+    return link(u, v, payload);
+}
+
+/*
+ * Adds an edge; in undirected graphs, also adds the reverse edge (see Edge::getReverse).
+ * Returns nullptr if any of the vertices does not exist.
+ */
+template<class T, class P, class D>
+Edge<T, P, D> *Graph<T, P, D, AdjacencyList>::addEdge(const T &source, const T &dest, const P &payload) {
+    EdgeType *e = addArc(source, dest, payload);
+    if (e != nullptr && !directed) {
+        e->reverse = link(e->dest, e->orig, payload);
+        e->reverse->reverse = e;
+    }
+    return e;
+}
+
+/*
+ * Same as addEdge, given the ids of the vertices (in constant time).
+ */
+template<class T, class P, class D>
+Edge<T, P, D> *Graph<T, P, D, AdjacencyList>::addEdgeById(unsigned source, unsigned dest, const P &payload) {
+    EdgeType *e = link(vertexSet[source], vertexSet[dest], payload);
+    if (!directed) {
+        e->reverse = link(e->dest, e->orig, payload);
+        e->reverse->reverse = e;
+    }
+    return e;
+}
+
+/*
+ * Removes the (first) edge from source to dest, and its reverse edge in undirected graphs.
+ * Returns false if there is no such edge.
+ */
+template<class T, class P, class D>
+bool Graph<T, P, D, AdjacencyList>::removeEdge(const T &source, const T &dest) {
+    VertexType *u = findVertex(source);
+    VertexType *v = findVertex(dest);
+    if (u == nullptr || v == nullptr)
+        return false;
+    for (auto e : u->adj)
+        if (e->dest == v) {
+            if (e->reverse != nullptr)
+                unlink(e->reverse);
+            unlink(e);
+            return true;
+        }
+    return false;
+}
+
+/*
+ * Renumbers the vertices: order[i] is the id of the vertex that gets the id i (see Reorder.h).
+ * The vertices and edges are reallocated in the new order, so that the adjacency lists of
+ * consecutive vertices are also close in memory; the order of the edges of each vertex is
+ * kept. Previous vertex and edge pointers, ids and search contexts are no longer valid.
+ */
+template<class T, class P, class D>
+void Graph<T, P, D, AdjacencyList>::reorder(const std::vector<unsigned> &order) {
+    Graph res;
+    res.copyVertices(*this, order);
+    std::swap(vertexSet, res.vertexSet);
+}
+
+/*
+ * Renumbers the vertices with an ordering strategy (Hilbert needs the coordinates of every
+ * vertex, by id). Returns the ordering applied (see above), for the callers to permute
+ * their own data by vertex id, or an empty vector (and leaves the graph unchanged) if the
+ * strategy is not available.
+ */
+template<class T, class P, class D>
+std::vector<unsigned> Graph<T, P, D, AdjacencyList>::reorder(VertexOrder strategy,
+                                                             const std::vector<std::pair<double, double>> &coordinates) {
+    std::vector<unsigned> order = vertexOrdering(*this, strategy, coordinates);
+    if (!order.empty())
+        reorder(order);
+    return order;
+}
+
+/*
+ * Copies the results of a search (dist and path of each vertex) to the vertices,
+ * for the interfaces that return them through Vertex::getDist and Vertex::getPath.
+ */
+template<class T, class P, class D>
+template<class Dist>
+void Graph<T, P, D, AdjacencyList>::publish(const BasicSearchContext<Dist> &ctx) {
+    for (auto v : vertexSet) {
+        auto s = ctx.get(v->id);
+        v->dist = WeightTraits<Dist>::toDouble(s.dist);
+        v->path = s.path == SearchContext::NONE ? nullptr : vertexSet[s.path];
+    }
+}
+
+/*
+ * Memory used by the vertices and edges (not counting memory owned by T).
+ */
+template<class T, class P, class D>
+size_t Graph<T, P, D, AdjacencyList>::memoryBytes() const {
+    size_t bytes = sizeof(*this) + vertexSet.capacity() * sizeof(VertexType *);
+    for (auto v : vertexSet)
+        bytes += sizeof(VertexType) + (v->adj.capacity() + v->incoming.capacity()) * sizeof(EdgeType *)
+                 + v->adj.size() * sizeof(EdgeType);
+    return bytes;
+}
+
+/*
+ * Copies the vertices and edges of other into this (empty) graph, with the vertex other.vertexSet[order[i]]
+ * getting the id i.
+ */
+template<class T, class P, class D>
+void Graph<T, P, D, AdjacencyList>::copyVertices(const Graph &other, const std::vector<unsigned> &order) {
+    std::vector<unsigned> newId(order.size());
+    vertexSet.reserve(order.size());
+    for (unsigned id = 0; id < order.size(); id++) {
+        newId[order[id]] = id;
+        vertexSet.push_back(new VertexType(other.vertexSet[order[id]]->info, id));
+    }
+    std::unordered_map<const EdgeType *, EdgeType *> copies;
+    for (unsigned id = 0; id < order.size(); id++)
+        for (auto e : other.vertexSet[order[id]]->adj) {
+            EdgeType *copy = link(vertexSet[id], vertexSet[newId[e->dest->id]], *e);
+            if (e->reverse == nullptr)
+                continue;
+            auto it = copies.find(e->reverse);
+            if (it == copies.end()) {
+                copies[e] = copy;
+            } else {
+                copy->reverse = it->second;
+                copy->reverse->reverse = copy;
+                copies.erase(it);
+            }
+        }
+}
+
+template<class T, class P, class D>
+Edge<T, P, D> *Graph<T, P, D, AdjacencyList>::link(VertexType *u, VertexType *v, const P &payload) {
+    auto e = new EdgeType(u, v, payload);
+    u->adj.push_back(e);
+    if (P::residual)
+        v->incoming.push_back(e);
+    return e;
+}
+
+template<class T, class P, class D>
+void Graph<T, P, D, AdjacencyList>::unlink(EdgeType *e) {
+    auto &adj = e->orig->adj;
+    adj.erase(std::find(adj.begin(), adj.end(), e));
+    if (P::residual) {
+        auto &incoming = e->dest->incoming;
+        incoming.erase(std::find(incoming.begin(), incoming.end(), e));
+    }
+    if (e->reverse != nullptr)
+        e->reverse->reverse = nullptr;
+    delete e;
+}
+
+/************************* Graph (CSR)  **************************/
+
+/**
+ * Range of consecutive edge indices, as returned by the CSR out(u).
+ */
+class IndexRange {
+    unsigned first, last;
+
+public:
+    class iterator {
+        unsigned i;
+
+    public:
+        explicit iterator(unsigned i) : i(i) {}
+
+        unsigned operator*() const { return i; }
+
+        iterator &operator++() {
+            ++i;
+            return *this;
+        }
+
+        bool operator!=(const iterator &other) const { return i != other.i; }
+    };
+
+    IndexRange(unsigned first, unsigned last) : first(first), last(last) {}
+
+    iterator begin() const { return iterator(first); }
+
+    iterator end() const { return iterator(last); }
+
+    size_t size() const { return last - first; }
+
+    unsigned operator[](size_t i) const { return first + i; }
+};
+
+/**
+ * Immutable copy of an adjacency list graph, with the edges of each vertex stored
+ * contiguously (better locality for traversals and shortest paths on large graphs).
+ * Vertex ids and the order of the edges are the same as in the original graph.
+ */
+template<class T, class P, class D>
+class Graph<T, P, D, Csr> {
+public:
+    using PayloadType = P;
+    using WeightType = typename P::WeightType;
+    static constexpr bool directed = D::directed;
+
+    explicit Graph(const Graph<T, P, D, AdjacencyList> &g);
+
+    int getNumVertex() const { return infos.size(); }
+
+    int findVertexId(const T &in) const;
+
+    const T &getInfo(unsigned u) const { return infos[u]; }
+
+    IndexRange out(unsigned u) const { return IndexRange(offsets[u], offsets[u + 1]); }
+
+    unsigned target(unsigned e) const { return targets[e]; }
+
+    const P &payload(unsigned e) const { return payloads[e]; }
+
+    WeightType weight(unsigned e) const { return payloads[e].weight; }
+
+    size_t memoryBytes() const {
+        return sizeof(*this) + infos.capacity() * sizeof(T) + (offsets.capacity() + targets.capacity()) * sizeof(unsigned)
+               + payloads.capacity() * sizeof(P);
+    }
+
+private:
+    std::vector<T> infos;
+    std::vector<unsigned> offsets;   // edges of u: [offsets[u], offsets[u + 1])
+    std::vector<unsigned> targets;
+    std::vector<P> payloads;
+};
+
+template<class T, class P, class D>
+Graph<T, P, D, Csr>::Graph(const Graph<T, P, D, AdjacencyList> &g) {
+    size_t m = 0;
+    for (auto v : g.getVertexSet())
+        m += v->getAdj().size();
+    infos.reserve(g.getNumVertex());
+    offsets.reserve(g.getNumVertex() + 1);
+    targets.reserve(m);
+    payloads.reserve(m);
+    offsets.push_back(0);
+    for (auto v : g.getVertexSet()) {
+        infos.push_back(v->getInfo());
+        for (auto e : v->getAdj()) {
+            targets.push_back(e->getDest()->getId());
+            payloads.push_back(*e);
+        }
+        offsets.push_back(targets.size());
+    }
+}
+
+template<class T, class P, class D>
+int Graph<T, P, D, Csr>::findVertexId(const T &in) const {
+    for (size_t u = 0; u < infos.size(); u++)
+        if (infos[u] == in)
+            return u;
+    return -1;
+}
+
+}
+
+#endif /* CAL_GRAPH_GRAPH_H_ */
@@ -0,0 +1,373 @@
+/*
+ * GridFlow.h
+ * Maximum flow in 4-connected grid networks, as in image segmentation: a vertex per pixel,
+ * edges to its 4 neighbours, and terminal edges from the source and to the sink. The network
+ * is implicit: one residual capacity per pixel and direction (plus one for its terminal
+ * edges) in flat arrays, no vertex or edge objects, so it holds millions of pixels.
+ * Boykov-Kolmogorov algorithm: search trees grown from the source and from the sink meet in
+ * augmenting paths, and are kept from one augmentation to the next (the vertices cut off by
+ * a saturated edge, orphans, are adopted by another vertex of their tree or freed).
+ */
+#ifndef CAL_GRAPH_GRID_FLOW_H_
+#define CAL_GRAPH_GRID_FLOW_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "WeightTraits.h"
+#include "GraphStats.h"
+#include "Trace.h"
+
+namespace cal {
+
+/**
+ * rows x cols grid flow network, pixels numbered by rows (id = row * cols + col).
+ * W: capacity type (signed: the terminal edges of a pixel are kept as one difference).
+ */
+template<class W = int>
+class GridFlowNetwork {
+    static_assert(std::is_signed<W>::value, "GridFlowNetwork needs a signed capacity type");
+
+public:
+    using FlowType = DistOf<W>;
+
+    // Directions of the edges of a pixel; the opposite of d is d ^ 2
+    enum Direction : uint8_t { RIGHT = 0, DOWN = 1, LEFT = 2, UP = 3 };
+
+    GridFlowNetwork(unsigned rows, unsigned cols);
+
+    unsigned getRows() const { return rows; }
+
+    unsigned getCols() const { return cols; }
+
+    unsigned getNumVertex() const { return rows * cols; }
+
+    unsigned id(unsigned row, unsigned col) const { return row * cols + col; }
+
+    /*
+     * Capacity of the edge from v to its neighbour in direction d (none at the border of the
+     * grid, ignored). Before maxFlow: it sets the residual capacity.
+     */
+    void setCapacity(unsigned v, Direction d, W c) {
+        if (hasNeighbour(v, d))
+            residual[4 * (size_t) v + d] = c;
+    }
+
+    /*
+     * Adds capacity to the edges from the source to v and from v to the sink (also after
+     * maxFlow: the next one continues from the current flow).
+     */
+    void addTerminalCapacities(unsigned v, W fromSource, W toSink);
+
+    /*
+     * Maximum flow from the source to the sink; returns its value.
+     */
+    FlowType maxFlow();
+
+    /*
+     * After maxFlow: whether v is on the side of the source of the minimum cut (reachable from
+     * the source in the residual network).
+     */
+    bool inSourceSide(unsigned v) const { return parent[v] != FREE && !sinkTree[v]; }
+
+    W getResidual(unsigned v, Direction d) const { return residual[4 * (size_t) v + d]; }
+
+    size_t memoryBytes() const {
+        return sizeof(*this) + (residual.capacity() + terminal.capacity()) * sizeof(W)
+               + (parent.capacity() + sinkTree.capacity() + active.capacity()) * sizeof(uint8_t)
+               + (dist.capacity() + timestamp.capacity()) * sizeof(unsigned)
+               + (queue.size() + orphans.size()) * sizeof(unsigned);
+    }
+
+private:
+    // Parent of a vertex in its tree: the direction of the edge to it, or one of these
+    static constexpr uint8_t TERMINAL = 4, ORPHAN = 5, FREE = 6;
+    static constexpr unsigned NO_VERTEX = std::numeric_limits<unsigned>::max();
+    static constexpr unsigned INFINITE_DIST = std::numeric_limits<unsigned>::max();
+
+    unsigned rows, cols;
+    FlowType flow = WeightTraits<W>::zero();
+    std::vector<W> residual;  // 4 per pixel, by direction
+    std::vector<W> terminal;  // > 0: residual capacity from the source, < 0: to the sink
+
+    // Search trees: the parent of each vertex, its tree, and the distance to the terminal
+    // (valid if timestamp is the current time)
+    std::vector<uint8_t> parent, sinkTree, active;
+    std::vector<unsigned> dist, timestamp;
+    unsigned time = 0;
+    std::deque<unsigned> queue, orphans;
+
+    bool hasNeighbour(unsigned v, unsigned d) const {
+        switch (d) {
+            case RIGHT: return v % cols != cols - 1;
+            case DOWN: return v / cols != rows - 1;
+            case LEFT: return v % cols != 0;
+            default: return v >= cols;
+        }
+    }
+
+    unsigned neighbour(unsigned v, unsigned d) const {
+        switch (d) {
+            case RIGHT: return v + 1;
+            case DOWN: return v + cols;
+            case LEFT: return v - 1;
+            default: return v - cols;
+        }
+    }
+
+    // Index of the edge from v in direction d in residual, and of its reverse edge
+    static size_t edge(unsigned v, unsigned d) { return 4 * (size_t) v + d; }
+
+    size_t reverse(unsigned v, unsigned d) const { return edge(neighbour(v, d), d ^ 2); }
+
+    void setActive(unsigned v) {
+        if (!active[v]) {
+            active[v] = 1;
+            queue.push_back(v);
+        }
+    }
+
+    // Orphans of an augmentation go first, those of the adoptions after them
+    void setOrphan(unsigned v) {
+        parent[v] = ORPHAN;
+        orphans.push_front(v);
+    }
+
+    unsigned nextActive();
+
+    void initTrees();
+
+    /*
+     * Pushes the bottleneck capacity along the path source -> ... -> u -> v -> ... -> sink,
+     * where u is in the source tree and the edge from u in direction d reaches v, in the sink
+     * tree; the vertices whose parent edge is saturated become orphans.
+     */
+    void augment(unsigned u, unsigned d);
+
+    void adopt(unsigned v);
+};
+
+template<class W>
+GridFlowNetwork<W>::GridFlowNetwork(unsigned rows, unsigned cols)
+        : rows(rows), cols(cols), residual(4 * (size_t) rows * cols, W(0)), terminal((size_t) rows * cols, W(0)),
+          parent((size_t) rows * cols, FREE), sinkTree((size_t) rows * cols, 0), active((size_t) rows * cols, 0),
+          dist((size_t) rows * cols, 0), timestamp((size_t) rows * cols, 0) {
+}
+
+template<class W>
+void GridFlowNetwork<W>::addTerminalCapacities(unsigned v, W fromSource, W toSink) {
+    // Both terminal edges of v carry the smaller capacity straight away
+    W delta = terminal[v];
+    if (delta > W(0))
+        fromSource += delta;
+    else
+        toSink -= delta;
+    flow += std::min(fromSource, toSink);
+    terminal[v] = fromSource - toSink;
+}
+
+template<class W>
+void GridFlowNetwork<W>::initTrees() {
+    queue.clear();
+    orphans.clear();
+    time = 0;
+    for (unsigned v = 0; v < getNumVertex(); v++) {
+        active[v] = 0;
+        timestamp[v] = 0;
+        if (terminal[v] == W(0)) {
+            parent[v] = FREE;
+            continue;
+        }
+        parent[v] = TERMINAL;
+        sinkTree[v] = terminal[v] < W(0);
+        dist[v] = 1;
+        setActive(v);
+    }
+}
+
+template<class W>
+unsigned GridFlowNetwork<W>::nextActive() {
+    while (!queue.empty()) {
+        unsigned v = queue.front();
+        queue.pop_front();
+        active[v] = 0;
+        if (parent[v] != FREE)
+            return v;
+    }
+    return NO_VERTEX;
+}
+
+template<class W>
+typename GridFlowNetwork<W>::FlowType GridFlowNetwork<W>::maxFlow() {
+    TRACE_SCOPE("boykov_kolmogorov");
+    initTrees();
+    unsigned current = NO_VERTEX;
+    while (true) {
+        unsigned i = current;
+        if (i != NO_VERTEX && parent[i] == FREE)
+            i = NO_VERTEX;
+        if (i == NO_VERTEX && (i = nextActive()) == NO_VERTEX)
+            break;
+        GRAPH_STATS_INC(verticesSettled);
+
+        // Growth: the free neighbours of i join its tree, until a vertex of the other tree is met
+        unsigned from = NO_VERTEX, direction = 0;
+        for (unsigned d = 0; d < 4 && from == NO_VERTEX; d++) {
+            if (!hasNeighbour(i, d))
+                continue;
+            unsigned j = neighbour(i, d);
+            // Residual capacity in the direction of the flow: away from the source tree
+            W r = sinkTree[i] ? residual[reverse(i, d)] : residual[edge(i, d)];
+            if (r == W(0))
+                continue;
+            if (parent[j] == FREE) {
+                parent[j] = d ^ 2;
+                sinkTree[j] = sinkTree[i];
+                timestamp[j] = timestamp[i];
+                dist[j] = dist[i] + 1;
+                setActive(j);
+            } else if (sinkTree[j] != sinkTree[i]) {
+                from = sinkTree[i] ? j : i;
+                direction = sinkTree[i] ? d ^ 2 : d;
+            } else if (timestamp[j] <= timestamp[i] && dist[j] > dist[i]) {
+                // Shorter path to the terminal through i
+                parent[j] = d ^ 2;
+                timestamp[j] = timestamp[i];
+                dist[j] = dist[i] + 1;
+            }
+        }
+        if (from == NO_VERTEX) {
+            current = NO_VERTEX;
+            continue;
+        }
+        // Augmentation and adoption of the orphans; i goes on growing afterwards
+        current = i;
+        time++;
+        augment(from, direction);
+        while (!orphans.empty()) {
+            unsigned v = orphans.front();
+            orphans.pop_front();
+            adopt(v);
+        }
+    }
+    return flow;
+}
+
+template<class W>
+void GridFlowNetwork<W>::augment(unsigned u, unsigned d) {
+    GRAPH_STATS_INC(augmentingPaths);
+    unsigned v = neighbour(u, d);
+    W bottleneck = residual[edge(u, d)];
+    unsigned i;
+    for (i = u; parent[i] != TERMINAL; i = neighbour(i, parent[i]))
+        bottleneck = std::min(bottleneck, residual[reverse(i, parent[i])]);
+    bottleneck = std::min(bottleneck, terminal[i]);
+    for (i = v; parent[i] != TERMINAL; i = neighbour(i, parent[i]))
+        bottleneck = std::min(bottleneck, residual[edge(i, parent[i])]);
+    bottleneck = std::min(bottleneck, W(-terminal[i]));
+
+    residual[edge(u, d)] -= bottleneck;
+    residual[reverse(u, d)] += bottleneck;
+    // Source tree: the flow goes from the parent of each vertex to it
+    for (i = u;;) {
+        unsigned p = parent[i];
+        if (p == TERMINAL) {
+            if ((terminal[i] -= bottleneck) == W(0))
+                setOrphan(i);
+            break;
+        }
+        unsigned next = neighbour(i, p);
+        residual[edge(i, p)] += bottleneck;
+        if ((residual[reverse(i, p)] -= bottleneck) == W(0))
+            setOrphan(i);
+        i = next;
+    }
+    // Sink tree: from each vertex to its parent
+    for (i = v;;) {
+        unsigned p = parent[i];
+        if (p == TERMINAL) {
+            if ((terminal[i] += bottleneck) == W(0))
+                setOrphan(i);
+            break;
+        }
+        unsigned next = neighbour(i, p);
+        residual[reverse(i, p)] += bottleneck;
+        if ((residual[edge(i, p)] -= bottleneck) == W(0))
+            setOrphan(i);
+        i = next;
+    }
+    flow += bottleneck;
+}
+
+template<class W>
+void GridFlowNetwork<W>::adopt(unsigned v) {
+    const bool sink = sinkTree[v];
+    unsigned best = 4, bestDist = INFINITE_DIST;
+    for (unsigned d = 0; d < 4; d++) {
+        if (!hasNeighbour(v, d))
+            continue;
+        unsigned j = neighbour(v, d);
+        // The new parent must be able to send flow to v (receive it from v in the sink tree)
+        W r = sink ? residual[edge(v, d)] : residual[reverse(v, d)];
+        if (r == W(0) || parent[j] == FREE || sinkTree[j] != sink)
+            continue;
+        // Is j connected to the terminal? (distance by the parents, unless already known)
+        unsigned length = 0, k = j;
+        for (;;) {
+            if (timestamp[k] == time) {
+                length += dist[k];
+                break;
+            }
+            length++;
+            if (parent[k] == TERMINAL) {
+                timestamp[k] = time;
+                dist[k] = 1;
+                break;
+            }
+            if (parent[k] == ORPHAN) {
+                length = INFINITE_DIST;
+                break;
+            }
+            k = neighbour(k, parent[k]);
+        }
+        if (length == INFINITE_DIST)
+            continue;
+        if (length < bestDist) {
+            best = d;
+            bestDist = length;
+        }
+        for (k = j; timestamp[k] != time; k = neighbour(k, parent[k])) {
+            timestamp[k] = time;
+            dist[k] = length--;
+        }
+    }
+    if (best < 4) {
+        parent[v] = best;
+        timestamp[v] = time;
+        dist[v] = bestDist + 1;
+        return;
+    }
+    // No parent: v is freed, its children become orphans, and the neighbours that could
+    // reach it again are active
+    parent[v] = FREE;
+    for (unsigned d = 0; d < 4; d++) {
+        if (!hasNeighbour(v, d))
+            continue;
+        unsigned j = neighbour(v, d);
+        if (parent[j] == FREE || sinkTree[j] != sink)
+            continue;
+        if ((sink ? residual[edge(v, d)] : residual[reverse(v, d)]) > W(0))
+            setActive(j);
+        if (parent[j] < 4 && neighbour(j, parent[j]) == v) {
+            parent[j] = ORPHAN;
+            orphans.push_back(j);
+        }
+    }
+}
+
+}
+
+#endif /* CAL_GRAPH_GRID_FLOW_H_ */
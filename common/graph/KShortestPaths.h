@@ -0,0 +1,259 @@
+/*
+ * KShortestPaths.h
+ * The k shortest simple (loopless) paths between two vertices: Yen's algorithm ("Finding the
+ * k shortest loopless paths in a network", 1971), with Lawler's rule (a path only spurs from
+ * the vertices after the one where it left its parent) and one shortest path tree to the
+ * target, computed once per query on the reversed graph and reused by every spur search:
+ *   - if the tree path from the spur vertex avoids the vertices and edges the spur search must
+ *     not use, it is the best spur path, and there is no search (Martins, Pascoal and Santos);
+ *   - otherwise the search is A*, with the tree distances to the target as the heuristic (they
+ *     are still lower bounds with vertices and edges removed, and consistent), so it goes
+ *     almost straight to the target instead of spreading around the spur vertex.
+ */
+#ifndef CAL_GRAPH_K_SHORTEST_PATHS_H_
+#define CAL_GRAPH_K_SHORTEST_PATHS_H_
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <set>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "GraphStats.h"
+#include "SearchContext.h"
+#include "ShortestPaths.h"
+#include "Trace.h"
+#include "WeightTraits.h"
+
+namespace cal {
+
+namespace detail {
+
+/**
+ * Reversed copy of the edges of a graph (CSR), with the view read by the shortest path
+ * functions (getNumVertex, out, target, weight).
+ */
+template<class W>
+class ReverseCsr {
+    std::vector<unsigned> offsets, targets;
+    std::vector<W> weights;
+
+public:
+    using WeightType = W;
+    static constexpr bool directed = true;
+
+    template<class G>
+    explicit ReverseCsr(const G &g) {
+        unsigned n = g.getNumVertex();
+        offsets.assign(n + 1, 0);
+        for (unsigned u = 0; u < n; u++)
+            for (const auto &e : g.out(u))
+                offsets[g.target(e) + 1]++;
+        for (unsigned v = 0; v < n; v++)
+            offsets[v + 1] += offsets[v];
+        targets.resize(offsets[n]);
+        weights.resize(offsets[n]);
+        std::vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+        for (unsigned u = 0; u < n; u++)
+            for (const auto &e : g.out(u)) {
+                unsigned i = next[g.target(e)]++;
+                targets[i] = u;
+                weights[i] = g.weight(e);
+            }
+    }
+
+    int getNumVertex() const { return offsets.size() - 1; }
+
+    IndexRange out(unsigned u) const { return IndexRange(offsets[u], offsets[u + 1]); }
+
+    unsigned target(unsigned e) const { return targets[e]; }
+
+    W weight(unsigned e) const { return weights[e]; }
+};
+
+}
+
+/**
+ * k shortest paths queries on a graph g (which must outlive this object and not change).
+ * Keeps the reversed graph and the search contexts, so a query does not allocate O(|V|)
+ * memory; one object per thread for concurrent queries.
+ */
+template<class G>
+class KShortestPaths {
+public:
+    using WeightType = typename G::WeightType;
+    using Dist = DistOf<WeightType>;
+
+    struct Path {
+        std::vector<unsigned> vertices;  // ids, from the source to the target
+        Dist length;
+    };
+
+    explicit KShortestPaths(const G &g) : g(g), reverse(g) {}
+
+    /*
+     * Up to k shortest simple paths from s to t, by increasing length (ties in the order
+     * found). With reuseTree false, each spur path is found by a Dijkstra search from the
+     * spur vertex that stops at t (plain Yen, for comparison).
+     */
+    std::vector<Path> find(unsigned s, unsigned t, unsigned k, bool reuseTree = true);
+
+private:
+    using Traits = WeightTraits<WeightType>;
+    using Context = DistContext<WeightType>;
+
+    const G &g;
+    detail::ReverseCsr<WeightType> reverse;
+    Context tree, spur;  // shortest paths to t (path: next vertex towards t), and spur searches
+    std::vector<unsigned> blockedNext;
+
+    bool spurPath(unsigned v, unsigned t, bool reuseTree, std::vector<unsigned> &vertices, std::vector<Dist> &lengths);
+};
+
+template<class G>
+std::vector<typename KShortestPaths<G>::Path> KShortestPaths<G>::find(unsigned s, unsigned t, unsigned k,
+                                                                         bool reuseTree) {
+    TRACE_SCOPE("k_shortest_paths");
+    std::vector<Path> res;
+    dijkstra(reverse, t, tree);
+    if (k == 0 || tree.get(s).dist == Context::INFINITE_DIST)
+        return res;
+
+    // Paths found (res) and candidates, with the length up to each vertex and the index
+    // of the vertex where they leave the path they spurred from
+    struct Candidate {
+        std::vector<unsigned> vertices;
+        std::vector<Dist> lengths;
+        size_t deviation;
+    };
+    std::vector<Candidate> found, candidates;
+    std::priority_queue<std::pair<Dist, size_t>, std::vector<std::pair<Dist, size_t>>,
+            std::greater<std::pair<Dist, size_t>>> queue;  // candidates by length
+    std::set<std::vector<unsigned>> known;
+
+    Candidate first{{s}, {Traits::zero()}, 0};
+    for (unsigned v = s; v != t;) {
+        unsigned next = tree.get(v).path;
+        first.vertices.push_back(next);
+        first.lengths.push_back(tree.get(s).dist - tree.get(next).dist);
+        v = next;
+    }
+    known.insert(first.vertices);
+    found.push_back(std::move(first));
+
+    std::vector<unsigned> vertices;
+    std::vector<Dist> lengths;
+    while (found.size() < k) {
+        const Candidate &last = found.back();
+        for (size_t i = last.deviation; i + 1 < last.vertices.size(); i++) {
+            unsigned v = last.vertices[i];
+            // The spur path may not use the root vertices, nor the next edge of the paths found with the same root
+            spur.reset(g.getNumVertex());
+            for (size_t j = 0; j < i; j++)
+                spur[last.vertices[j]].visited = true;
+            blockedNext.clear();
+            for (const Candidate &p : found)
+                if (p.vertices.size() > i + 1 && std::equal(p.vertices.begin(), p.vertices.begin() + i + 1,
+                                                            last.vertices.begin()))
+                    blockedNext.push_back(p.vertices[i + 1]);
+            if (!spurPath(v, t, reuseTree, vertices, lengths))
+                continue;
+            Candidate c{std::vector<unsigned>(last.vertices.begin(), last.vertices.begin() + i),
+                        std::vector<Dist>(last.lengths.begin(), last.lengths.begin() + i), i};
+            for (size_t j = 0; j < vertices.size(); j++) {
+                c.vertices.push_back(vertices[j]);
+                c.lengths.push_back(last.lengths[i] + lengths[j]);
+            }
+            if (known.insert(c.vertices).second) {
+                queue.emplace(c.lengths.back(), candidates.size());
+                candidates.push_back(std::move(c));
+            }
+        }
+        if (queue.empty())
+            break;
+        found.push_back(std::move(candidates[queue.top().second]));
+        queue.pop();
+    }
+    for (Candidate &c : found)
+        res.push_back({std::move(c.vertices), c.lengths.back()});
+    return res;
+}
+
+/*
+ * Shortest path from v to t that avoids the vertices marked visited in the spur context and
+ * the edges from v to blockedNext: its vertices (from v) and the length up to each one.
+ * Returns false if there is none.
+ */
+template<class G>
+bool KShortestPaths<G>::spurPath(unsigned v, unsigned t, bool reuseTree, std::vector<unsigned> &vertices,
+                                 std::vector<Dist> &lengths) {
+    vertices.clear();
+    lengths.clear();
+    auto blocked = [&](unsigned u, unsigned w) {
+        return spur.get(w).visited || (u == v && std::find(blockedNext.begin(), blockedNext.end(), w) != blockedNext.end());
+    };
+    if (reuseTree) {
+        // Tree path, if it is allowed
+        if (tree.get(v).dist == Context::INFINITE_DIST)
+            return false;
+        bool allowed = true;
+        for (unsigned u = v; u != t && allowed; u = tree.get(u).path)
+            allowed = !blocked(u, tree.get(u).path);
+        if (allowed) {
+            for (unsigned u = v;; u = tree.get(u).path) {
+                vertices.push_back(u);
+                lengths.push_back(tree.get(v).dist - tree.get(u).dist);
+                if (u == t)
+                    return true;
+            }
+        }
+    }
+
+    // A* (Dijkstra if the tree is not used), with lazy deletion from the queue
+    auto estimate = [&](unsigned u) { return reuseTree ? tree.get(u).dist : Traits::zero(); };
+    std::priority_queue<std::pair<Dist, unsigned>, std::vector<std::pair<Dist, unsigned>>,
+            std::greater<std::pair<Dist, unsigned>>> queue;
+    spur[v].dist = Traits::zero();
+    queue.emplace(estimate(v), v);
+    while (!queue.empty()) {
+        unsigned u = queue.top().second;
+        queue.pop();
+        typename Context::State &state = spur[u];
+        if (state.processing)
+            continue;
+        state.processing = true;
+        GRAPH_STATS_INC(verticesSettled);
+        if (u == t)
+            break;
+        Dist dist = state.dist;
+        for (const auto &e : g.out(u)) {
+            unsigned w = g.target(e);
+            if (blocked(u, w) || (reuseTree && tree.get(w).dist == Context::INFINITE_DIST))
+                continue;
+            Dist newDist = Traits::add(dist, g.weight(e));
+            typename Context::State &next = spur[w];
+            if (next.dist > newDist) {
+                GRAPH_STATS_INC(relaxations);
+                next.dist = newDist;
+                next.path = u;
+                queue.emplace(newDist + estimate(w), w);
+            }
+        }
+    }
+    if (!spur.get(t).processing)
+        return false;
+    for (int u = t; u != Context::NONE; u = spur.get(u).path) {
+        vertices.push_back(u);
+        lengths.push_back(spur.get(u).dist);
+        if ((unsigned) u == v)
+            break;
+    }
+    std::reverse(vertices.begin(), vertices.end());
+    std::reverse(lengths.begin(), lengths.end());
+    return true;
+}
+
+}
+
+#endif /* CAL_GRAPH_K_SHORTEST_PATHS_H_ */
@@ -0,0 +1,176 @@
+/*
+ * PageRank.h
+ * PageRank (Brin and Page, 1998): the stationary distribution of a random walk that follows
+ * a random out-edge with probability "damping" and jumps to a random vertex otherwise (and
+ * always from vertices without out-edges).
+ *   - PageRank: power iteration, each vertex pulling the ranks of its in-neighbours from a
+ *     CSR of the in-edges (no write conflicts, so the vertices are split among threads);
+ *   - personalizedPageRank: the walk jumps back to one seed vertex; approximated by pushing
+ *     residual mass from the seed outwards (Andersen, Chung and Lang, 2006), which only
+ *     touches the vertices near the seed.
+ */
+#ifndef CAL_GRAPH_PAGE_RANK_H_
+#define CAL_GRAPH_PAGE_RANK_H_
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "GraphStats.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+
+namespace cal {
+
+struct PageRankOptions {
+    double damping = 0.85;
+    double tolerance = 1e-6;       // stops when the ranks change less than this (sum of the changes)
+    unsigned maxIterations = 100;
+};
+
+template<class Real>
+struct PageRankResult {
+    std::vector<Real> rank;        // by vertex id, summing to 1
+    unsigned iterations = 0;
+    double residual = 0;           // sum of the changes in the last iteration
+};
+
+/**
+ * In-edges of a graph (CSR) and the out-degrees of its vertices, built once and reused by
+ * every run. Real (double or float) is the type of the ranks and of their sums: float halves
+ * the memory traffic of the iterations, at the cost of precision (tolerances below about
+ * 1e-5 may not be reached).
+ */
+class PageRank {
+    std::vector<unsigned> offsets;   // in-edges of v: sources[offsets[v] .. offsets[v + 1])
+    std::vector<unsigned> sources;
+    std::vector<unsigned> outDegree;
+
+    static constexpr size_t GRAIN = 4096;
+
+public:
+    template<class G>
+    explicit PageRank(const G &g);
+
+    unsigned getNumVertex() const { return outDegree.size(); }
+
+    size_t getNumEdges() const { return sources.size(); }
+
+    template<class Real = double>
+    PageRankResult<Real> run(const PageRankOptions &options = {}, ThreadPool &pool = ThreadPool::global()) const;
+};
+
+template<class G>
+PageRank::PageRank(const G &g) {
+    TRACE_SCOPE("page_rank_csr");
+    unsigned n = g.getNumVertex();
+    offsets.assign(n + 1, 0);
+    outDegree.assign(n, 0);
+    for (unsigned u = 0; u < n; u++)
+        for (const auto &e : g.out(u)) {
+            offsets[g.target(e) + 1]++;
+            outDegree[u]++;
+        }
+    for (unsigned v = 0; v < n; v++)
+        offsets[v + 1] += offsets[v];
+    sources.resize(offsets[n]);
+    std::vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+    for (unsigned u = 0; u < n; u++)
+        for (const auto &e : g.out(u))
+            sources[next[g.target(e)]++] = u;
+}
+
+template<class Real>
+PageRankResult<Real> PageRank::run(const PageRankOptions &options, ThreadPool &pool) const {
+    TRACE_SCOPE("page_rank");
+    unsigned n = getNumVertex();
+    PageRankResult<Real> res;
+    if (n == 0)
+        return res;
+    const Real damping = options.damping;
+    std::vector<Real> rank(n, Real(1) / n), next(n), share(n);
+    auto plus = [](double a, double b) { return a + b; };
+    while (res.iterations < options.maxIterations) {
+        // Rank sent along each out-edge, and the total of the vertices without out-edges
+        double dangling = parallelReduce(0, n, 0.0, [&](size_t lo, size_t hi) {
+            double sum = 0;
+            for (size_t u = lo; u < hi; u++) {
+                if (outDegree[u] == 0)
+                    sum += rank[u];
+                else
+                    share[u] = rank[u] / outDegree[u];
+            }
+            return sum;
+        }, plus, GRAIN, pool);
+        const Real base = (1 - damping + damping * dangling) / n;
+        res.residual = parallelReduce(0, n, 0.0, [&](size_t lo, size_t hi) {
+            double change = 0;
+            for (size_t v = lo; v < hi; v++) {
+                Real sum = 0;
+                for (unsigned i = offsets[v]; i < offsets[v + 1]; i++)
+                    sum += share[sources[i]];
+                next[v] = base + damping * sum;
+                change += std::abs((double) next[v] - (double) rank[v]);
+            }
+            return change;
+        }, plus, GRAIN, pool);
+        rank.swap(next);
+        res.iterations++;
+        if (res.residual < options.tolerance)
+            break;
+    }
+    res.rank = std::move(rank);
+    return res;
+}
+
+/*
+ * Personalized PageRank of the vertices near seed (ids and scores, highest first), where the
+ * walk jumps back to seed (also from the vertices without out-edges). Each vertex u whose
+ * residual mass reaches epsilon times its out-degree keeps 1 - damping of it and pushes the
+ * rest to its out-neighbours; the scores are then within epsilon * out-degree of the exact
+ * ones, and only about 1 / ((1 - damping) * epsilon) pushes are needed, however large the graph.
+ */
+template<class G>
+std::vector<std::pair<unsigned, double>> personalizedPageRank(const G &g, unsigned seed, double damping = 0.85,
+                                                              double epsilon = 1e-7) {
+    TRACE_SCOPE("personalized_page_rank");
+    std::unordered_map<unsigned, double> estimate, residual;
+    auto threshold = [&](unsigned u) { return epsilon * std::max<size_t>(g.out(u).size(), 1); };
+    std::queue<unsigned> active;  // vertices whose residual reached their threshold
+    residual[seed] = 1;
+    active.push(seed);
+    auto add = [&](unsigned v, double mass) {
+        double &r = residual[v];
+        bool below = r < threshold(v);
+        r += mass;
+        if (below && r >= threshold(v))
+            active.push(v);
+    };
+    while (!active.empty()) {
+        unsigned u = active.front();
+        active.pop();
+        double mass = residual[u];
+        residual[u] = 0;
+        GRAPH_STATS_INC(verticesSettled);
+        estimate[u] += (1 - damping) * mass;
+        size_t degree = g.out(u).size();
+        if (degree == 0) {
+            add(seed, damping * mass);
+            continue;
+        }
+        double share = damping * mass / degree;
+        for (const auto &e : g.out(u))
+            add(g.target(e), share);
+    }
+    std::vector<std::pair<unsigned, double>> res(estimate.begin(), estimate.end());
+    std::sort(res.begin(), res.end(), [](const std::pair<unsigned, double> &a, const std::pair<unsigned, double> &b) {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    });
+    return res;
+}
+
+}
+
+#endif /* CAL_GRAPH_PAGE_RANK_H_ */
@@ -0,0 +1,241 @@
+/*
+ * Reachability.h
+ * Index for "is there a path from u to v" queries on a (fixed) directed graph, built on the
+ * DAG of its strongly connected components (numbered in topological order, see Components.h):
+ *   - Closure: transitive closure as one bit set per component (|C|^2 / 8 bytes), with
+ *     O(1) queries; for graphs of moderate size;
+ *   - Labels: interval labels of a few random depth-first traversals (GRAIL: Yildirim, Chaoji
+ *     and Zaki, 2010), O(|C|) space. A pair whose intervals are not nested is unreachable;
+ *     the other queries are answered by a depth-first search that skips the components
+ *     whose labels already rule them out.
+ * The index is not updated when the graph changes.
+ */
+#ifndef CAL_GRAPH_REACHABILITY_H_
+#define CAL_GRAPH_REACHABILITY_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+#include "Components.h"
+#include "SearchContext.h"
+#include "Trace.h"
+
+namespace cal {
+
+class ReachabilityIndex {
+public:
+    enum class Mode {
+        Auto,     // Closure up to CLOSURE_MAX_COMPONENTS components, Labels above
+        Closure,
+        Labels
+    };
+
+    static constexpr unsigned CLOSURE_MAX_COMPONENTS = 16384;  // 32 MB of bit sets
+
+    template<class G>
+    explicit ReachabilityIndex(const G &g, Mode mode = Mode::Auto, unsigned numLabels = 3, unsigned seed = 0);
+
+    /*
+     * True if there is a path from the vertex u to the vertex v (ids of the indexed graph).
+     * The searches of the Labels mode keep their state in ctx.
+     */
+    bool reaches(unsigned u, unsigned v, SearchContext &ctx = SearchContext::local()) const {
+        unsigned cu = component[u], cv = component[v];
+        if (cu == cv)
+            return true;
+        if (cu > cv)  // edges between components go to higher ids
+            return false;
+        if (mode == Mode::Closure)
+            return (closure[cu * words + cv / 64] >> (cv % 64)) & 1;
+        if (!contains(cu, cv))
+            return false;
+        return search(cu, cv, ctx);
+    }
+
+    Mode getMode() const { return mode; }
+
+    unsigned getNumComponents() const { return offsets.size() - 1; }
+
+    size_t memoryBytes() const {
+        return sizeof(*this) + (component.capacity() + offsets.capacity() + targets.capacity()) * sizeof(unsigned)
+               + closure.capacity() * sizeof(uint64_t) + intervals.capacity() * sizeof(std::pair<unsigned, unsigned>);
+    }
+
+private:
+    Mode mode;
+    std::vector<unsigned> component;         // component of each vertex
+    std::vector<unsigned> offsets, targets;  // edges of the DAG of components (CSR, no repeats)
+
+    // Closure: bit d of the row of c (words 64 bit words per row) is set if c reaches d
+    size_t words = 0;
+    std::vector<uint64_t> closure;
+
+    // Labels: interval of each traversal k for the component c at intervals[c * numLabels + k]
+    unsigned numLabels = 0;
+    std::vector<std::pair<unsigned, unsigned>> intervals;
+
+    /*
+     * True if the labels of d are nested in the ones of c in every traversal (required for c to reach d).
+     */
+    bool contains(unsigned c, unsigned d) const {
+        for (unsigned k = 0; k < numLabels; k++) {
+            const auto &lc = intervals[c * numLabels + k], &ld = intervals[d * numLabels + k];
+            if (ld.first < lc.first || ld.second > lc.second)
+                return false;
+        }
+        return true;
+    }
+
+    /*
+     * Depth-first search from the component c to d, only through the components that may reach d.
+     */
+    bool search(unsigned c, unsigned d, SearchContext &ctx) const {
+        ctx.reset(getNumComponents());
+        std::vector<unsigned> stack{c};
+        ctx[c].visited = true;
+        while (!stack.empty()) {
+            unsigned x = stack.back();
+            stack.pop_back();
+            GRAPH_STATS_INC(verticesSettled);
+            for (unsigned i = offsets[x]; i < offsets[x + 1]; i++) {
+                unsigned y = targets[i];
+                if (y == d)
+                    return true;
+                if (y < d && !ctx[y].visited && contains(y, d)) {
+                    ctx[y].visited = true;
+                    stack.push_back(y);
+                }
+            }
+        }
+        return false;
+    }
+
+    void buildClosure();
+
+    void buildLabels(unsigned seed);
+};
+
+template<class G>
+ReachabilityIndex::ReachabilityIndex(const G &g, Mode mode, unsigned numLabels, unsigned seed) : mode(mode) {
+    TRACE_SCOPE("reachability_index");
+    Components scc = tarjanScc(g);
+    component = std::move(scc.component);
+    unsigned numComponents = scc.count;
+    if (mode == Mode::Auto)
+        this->mode = numComponents <= CLOSURE_MAX_COMPONENTS ? Mode::Closure : Mode::Labels;
+
+    // DAG of the components, by counting sort of the vertices by component
+    std::vector<unsigned> first(numComponents + 1, 0), vertices(component.size());
+    for (unsigned c : component)
+        first[c + 1]++;
+    for (unsigned c = 0; c < numComponents; c++)
+        first[c + 1] += first[c];
+    {
+        std::vector<unsigned> next(first.begin(), first.end() - 1);
+        for (unsigned u = 0; u < component.size(); u++)
+            vertices[next[component[u]]++] = u;
+    }
+    const unsigned NONE = std::numeric_limits<unsigned>::max();
+    std::vector<unsigned> seen(numComponents, NONE);
+    offsets.reserve(numComponents + 1);
+    offsets.push_back(0);
+    for (unsigned c = 0; c < numComponents; c++) {
+        for (unsigned i = first[c]; i < first[c + 1]; i++)
+            for (const auto &e : g.out(vertices[i])) {
+                unsigned d = component[g.target(e)];
+                if (d != c && seen[d] != c) {
+                    seen[d] = c;
+                    targets.push_back(d);
+                }
+            }
+        offsets.push_back(targets.size());
+    }
+
+    if (this->mode == Mode::Closure) {
+        buildClosure();
+    } else {
+        this->numLabels = std::max(numLabels, 1u);
+        buildLabels(seed);
+    }
+}
+
+/*
+ * Rows in reverse topological order: each row is the union of the rows of the successors
+ * (which only have bits from their own component on).
+ */
+inline void ReachabilityIndex::buildClosure() {
+    TRACE_SCOPE("reachability_closure");
+    unsigned numComponents = getNumComponents();
+    words = (numComponents + 63) / 64;
+    closure.assign(numComponents * words, 0);
+    for (unsigned c = numComponents; c-- > 0;) {
+        uint64_t *row = &closure[c * words];
+        row[c / 64] |= uint64_t(1) << (c % 64);
+        for (unsigned i = offsets[c]; i < offsets[c + 1]; i++) {
+            unsigned d = targets[i];
+            const uint64_t *other = &closure[d * words];
+            for (size_t w = d / 64; w < words; w++)
+                row[w] |= other[w];
+        }
+    }
+}
+
+/*
+ * Each traversal numbers the components in post-order of a depth-first search from the
+ * sources of the DAG, with the edges of each component in random order. The interval of
+ * c is [lowest number of the components it reaches, its own number].
+ */
+inline void ReachabilityIndex::buildLabels(unsigned seed) {
+    TRACE_SCOPE("reachability_labels");
+    unsigned numComponents = getNumComponents();
+    intervals.assign((size_t) numComponents * numLabels, {0, 0});
+    std::vector<unsigned> indegree(numComponents, 0);
+    for (unsigned d : targets)
+        indegree[d]++;
+    std::mt19937 gen(seed);
+    std::vector<unsigned> order(targets), roots;
+    std::vector<char> visited(numComponents);
+    std::vector<std::pair<unsigned, unsigned>> stack;  // component, next edge to follow
+    for (unsigned k = 0; k < numLabels; k++) {
+        for (unsigned c = 0; c < numComponents; c++)
+            std::shuffle(order.begin() + offsets[c], order.begin() + offsets[c + 1], gen);
+        roots.clear();
+        for (unsigned c = 0; c < numComponents; c++)
+            if (indegree[c] == 0)
+                roots.push_back(c);
+        std::shuffle(roots.begin(), roots.end(), gen);
+        std::fill(visited.begin(), visited.end(), false);
+        unsigned next = 0;
+        for (unsigned r : roots) {
+            visited[r] = true;
+            stack.emplace_back(r, offsets[r]);
+            while (!stack.empty()) {
+                unsigned c = stack.back().first;
+                if (stack.back().second == offsets[c + 1]) {
+                    stack.pop_back();
+                    intervals[c * numLabels + k].second = next++;
+                    continue;
+                }
+                unsigned d = order[stack.back().second++];
+                if (!visited[d]) {
+                    visited[d] = true;
+                    stack.emplace_back(d, offsets[d]);
+                }
+            }
+        }
+        // Lowest number reached, in reverse topological order
+        for (unsigned c = numComponents; c-- > 0;) {
+            unsigned low = intervals[c * numLabels + k].second;
+            for (unsigned i = offsets[c]; i < offsets[c + 1]; i++)
+                low = std::min(low, intervals[targets[i] * numLabels + k].first);
+            intervals[c * numLabels + k].first = low;
+        }
+    }
+}
+
+}
+
+#endif /* CAL_GRAPH_REACHABILITY_H_ */
@@ -0,0 +1,161 @@
+/*
+ * Reorder.h
+ * Vertex orderings that improve the memory locality of traversals: vertices that are close
+ * in the graph (or in the plane) get close ids, so their data (search state, CSR rows,
+ * adjacency lists) is close in memory. Graph::reorder renumbers a graph with them.
+ *
+ * An ordering is a permutation "order" of the vertex ids: order[i] is the (current) id of
+ * the vertex that gets the id i.
+ */
+#ifndef CAL_GRAPH_REORDER_H_
+#define CAL_GRAPH_REORDER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace cal {
+
+enum class VertexOrder {
+    Bfs,                  // breadth-first order, from each unvisited vertex (by id)
+    ReverseCuthillMcKee,  // breadth-first by increasing degree, reversed (low bandwidth)
+    Hilbert               // position of the coordinates of each vertex along a Hilbert curve
+};
+
+/*
+ * Breadth-first order of all the vertices (outgoing edges), starting a new search at the
+ * first unvisited vertex.
+ */
+template<class G>
+std::vector<unsigned> bfsOrdering(const G &g) {
+    unsigned n = g.getNumVertex();
+    std::vector<unsigned> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    for (unsigned s = 0; s < n; s++) {
+        if (visited[s]) continue;
+        visited[s] = true;
+        order.push_back(s);
+        // order is also the queue: its elements from head on are still to be expanded
+        for (size_t head = order.size() - 1; head < order.size(); head++)
+            for (const auto &e : g.out(order[head])) {
+                unsigned v = g.target(e);
+                if (!visited[v]) {
+                    visited[v] = true;
+                    order.push_back(v);
+                }
+            }
+    }
+    return order;
+}
+
+/*
+ * Reverse Cuthill-McKee ordering: breadth-first order with the new neighbours of each
+ * vertex sorted by increasing degree, each search starting at an unvisited vertex of
+ * minimum degree, reversed at the end.
+ */
+template<class G>
+std::vector<unsigned> reverseCuthillMcKee(const G &g) {
+    unsigned n = g.getNumVertex();
+    std::vector<size_t> degree(n);
+    for (unsigned u = 0; u < n; u++)
+        degree[u] = g.out(u).size();
+    auto byDegree = [&](unsigned a, unsigned b) { return degree[a] < degree[b]; };
+    std::vector<unsigned> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), byDegree);
+
+    std::vector<unsigned> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    for (unsigned s : starts) {
+        if (visited[s]) continue;
+        visited[s] = true;
+        order.push_back(s);
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            size_t first = order.size();
+            for (const auto &e : g.out(order[head])) {
+                unsigned v = g.target(e);
+                if (!visited[v]) {
+                    visited[v] = true;
+                    order.push_back(v);
+                }
+            }
+            std::stable_sort(order.begin() + first, order.end(), byDegree);
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+/*
+ * Index of the cell (x, y) along a Hilbert curve through a 2^16 x 2^16 grid.
+ */
+inline uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+    const uint32_t N = 1u << 16;
+    uint64_t d = 0;
+    for (uint32_t s = N / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) != 0;
+        uint32_t ry = (y & s) != 0;
+        d += (uint64_t) s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {  // rotates the quadrant, so that the curve is continuous
+            if (rx == 1) {
+                x = N - 1 - x;
+                y = N - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+/*
+ * Order of the points (by vertex id) along a Hilbert curve through their bounding box.
+ */
+inline std::vector<unsigned> hilbertOrdering(const std::vector<std::pair<double, double>> &coordinates) {
+    unsigned n = coordinates.size();
+    std::vector<unsigned> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if (n == 0)
+        return order;
+    double minX = coordinates[0].first, maxX = minX, minY = coordinates[0].second, maxY = minY;
+    for (const auto &p : coordinates) {
+        minX = std::min(minX, p.first);
+        maxX = std::max(maxX, p.first);
+        minY = std::min(minY, p.second);
+        maxY = std::max(maxY, p.second);
+    }
+    // Same scale in both axes, so that the curve does not stretch the plane
+    double scale = 65535.0 / std::max(std::max(maxX - minX, maxY - minY), 1e-300);
+    std::vector<uint64_t> key(n);
+    for (unsigned u = 0; u < n; u++)
+        key[u] = hilbertIndex(uint32_t((coordinates[u].first - minX) * scale),
+                              uint32_t((coordinates[u].second - minY) * scale));
+    std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) { return key[a] < key[b]; });
+    return order;
+}
+
+/*
+ * Ordering of the vertices of g with the given strategy. Hilbert needs the coordinates of
+ * every vertex (by id); returns an empty vector if they are missing.
+ */
+template<class G>
+std::vector<unsigned> vertexOrdering(const G &g, VertexOrder strategy,
+                                     const std::vector<std::pair<double, double>> &coordinates = {}) {
+    switch (strategy) {
+        case VertexOrder::Bfs:
+            return bfsOrdering(g);
+        case VertexOrder::ReverseCuthillMcKee:
+            return reverseCuthillMcKee(g);
+        case VertexOrder::Hilbert:
+            if (coordinates.size() == (size_t) g.getNumVertex())
+                return hilbertOrdering(coordinates);
+    }
+    return {};
+}
+
+}
+
+#endif /* CAL_GRAPH_REORDER_H_ */
@@ -0,0 +1,72 @@
+/*
+ * RoadMap.h
+ * Reads the road maps of TP7_graphviewer/resources (e.g. map2) into a graph:
+ *   nodes.txt   number of nodes, then "id latitude longitude" per node
+ *   edges.txt   number of edges, then "id origin destination" per edge (node ids)
+ * The contents of the vertices are the node ids, and the edge weights the great-circle
+ * distances between their nodes, in meters.
+ */
+#ifndef CAL_GRAPH_ROAD_MAP_H_
+#define CAL_GRAPH_ROAD_MAP_H_
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cal {
+
+/*
+ * Distance in meters between two points given by their latitude and longitude in degrees
+ * (haversine formula).
+ */
+inline double haversine(double lat1, double lon1, double lat2, double lon2) {
+    const double EARTH_RADIUS = 6371000;
+    const double RADIANS = M_PI / 180;
+    double dLat = (lat2 - lat1) * RADIANS, dLon = (lon2 - lon1) * RADIANS;
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2)
+               + std::cos(lat1 * RADIANS) * std::cos(lat2 * RADIANS) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2 * EARTH_RADIUS * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+/*
+ * Adds the nodes and edges of the map in the directory dir to g (an empty graph, whose
+ * vertex contents are constructible from the node ids), and fills coordinates with the
+ * (latitude, longitude) of each vertex, by id. Edges to unknown nodes are skipped.
+ * Returns false if the files cannot be read.
+ */
+template<class G>
+bool readRoadMap(const std::string &dir, G &g, std::vector<std::pair<double, double>> &coordinates) {
+    using W = typename G::WeightType;
+    std::ifstream nodes(dir + "/nodes.txt");
+    std::ifstream edges(dir + "/edges.txt");
+    if (!nodes || !edges)
+        return false;
+    size_t n, m;
+    long long id, orig, dest;
+    double lat, lon;
+    std::unordered_map<long long, unsigned> ids;  // node id -> vertex id
+    nodes >> n;
+    coordinates.clear();
+    coordinates.reserve(n);
+    for (size_t i = 0; i < n && nodes >> id >> lat >> lon; i++) {
+        ids[id] = g.appendVertex(id)->getId();
+        coordinates.emplace_back(lat, lon);
+    }
+    edges >> m;
+    for (size_t i = 0; i < m && edges >> id >> orig >> dest; i++) {
+        auto u = ids.find(orig), v = ids.find(dest);
+        if (u == ids.end() || v == ids.end())
+            continue;
+        const auto &p = coordinates[u->second], &q = coordinates[v->second];
+        g.addEdgeById(u->second, v->second, W(haversine(p.first, p.second, q.first, q.second)));
+    }
+    return true;
+}
+
+}
+
+#endif /* CAL_GRAPH_ROAD_MAP_H_ */
@@ -0,0 +1,261 @@
+/*
+ * ShortestPaths.h
+ * Single source (BFS, Dijkstra, Bellman-Ford) and all pairs (Floyd-Warshall) shortest paths.
+ *
+ * The single source functions leave their results in a search context: the "dist" of each
+ * vertex (INFINITE_DIST if unreachable) and its predecessor ("path"). The distances have the
+ * type given by WeightTraits for the weights of the graph (exact sums for integer weights),
+ * so the context is a DistContext<W> (the usual SearchContext for double weights).
+ */
+#ifndef CAL_GRAPH_SHORTEST_PATHS_H_
+#define CAL_GRAPH_SHORTEST_PATHS_H_
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include "SearchContext.h"
+#include "WeightTraits.h"
+#include "GraphStats.h"
+#include "Trace.h"
+
+namespace cal {
+
+/*
+ * Shortest paths in number of edges (breadth-first search).
+ */
+template<class G>
+void unweightedShortestPaths(const G &g, unsigned s, DistContext<typename G::WeightType> &ctx) {
+    TRACE_SCOPE("unweighted_shortest_path");
+    using Context = DistContext<typename G::WeightType>;
+    using Dist = typename Context::DistType;
+    ctx.reset(g.getNumVertex());
+    std::queue<unsigned> q;
+    ctx[s].dist = Dist(0);
+    q.push(s);
+    while (!q.empty()) {
+        unsigned u = q.front();
+        q.pop();
+        GRAPH_STATS_INC(verticesSettled);
+        Dist dist = ctx[u].dist;
+        for (const auto &e : g.out(u)) {
+            unsigned v = g.target(e);
+            typename Context::State &w = ctx[v];
+            if (w.dist == Context::INFINITE_DIST) {
+                GRAPH_STATS_INC(relaxations);
+                w.dist = dist + Dist(1);
+                w.path = u;
+                q.push(v);
+            }
+        }
+    }
+}
+
+/*
+ * Dijkstra algorithm (non-negative weights), with the priority queue of the context.
+ */
+template<class G>
+void dijkstra(const G &g, unsigned s, DistContext<typename G::WeightType> &ctx) {
+    TRACE_SCOPE("dijkstra");
+    using Traits = WeightTraits<typename G::WeightType>;
+    using Context = DistContext<typename G::WeightType>;
+    using Dist = typename Context::DistType;
+    ctx.reset(g.getNumVertex());
+    ctx[s].dist = Traits::zero();
+    ctx.insert(s);
+    while (!ctx.empty()) {
+        unsigned u = ctx.extractMin();
+        GRAPH_STATS_INC(verticesSettled);
+        Dist dist = ctx[u].dist;
+        for (const auto &e : g.out(u)) {
+            unsigned v = g.target(e);
+            Dist newDist = Traits::add(dist, g.weight(e));
+            typename Context::State &w = ctx[v];
+            if (w.dist > newDist) {
+                GRAPH_STATS_INC(relaxations);
+                bool queued = w.dist != Context::INFINITE_DIST;
+                w.dist = newDist;
+                w.path = u;
+                if (queued)
+                    ctx.decreaseKey(v);
+                else
+                    ctx.insert(v);
+            }
+        }
+    }
+}
+
+/*
+ * Dijkstra search from s bounded by maxDist (isochrone): only the vertices at distance at most
+ * maxDist get a state in ctx (the others keep INFINITE_DIST): the ones beyond it are never
+ * queued, so the search stops once the ball is settled, and its cost (including the O(1) reset
+ * of the context) depends on the size of the ball, not of the graph.
+ * Returns the ids of the vertices reached, by increasing distance.
+ */
+template<class G>
+std::vector<unsigned> dijkstraWithin(const G &g, unsigned s, DistOf<typename G::WeightType> maxDist,
+                                     DistContext<typename G::WeightType> &ctx) {
+    TRACE_SCOPE("dijkstra_within");
+    using Traits = WeightTraits<typename G::WeightType>;
+    using Context = DistContext<typename G::WeightType>;
+    using Dist = typename Context::DistType;
+    std::vector<unsigned> reached;
+    ctx.reset(g.getNumVertex());
+    if (maxDist < Traits::zero())
+        return reached;
+    ctx[s].dist = Traits::zero();
+    ctx.insert(s);
+    while (!ctx.empty()) {
+        unsigned u = ctx.extractMin();
+        GRAPH_STATS_INC(verticesSettled);
+        reached.push_back(u);
+        Dist dist = ctx[u].dist;
+        for (const auto &e : g.out(u)) {
+            Dist newDist = Traits::add(dist, g.weight(e));
+            if (newDist > maxDist)
+                continue;
+            unsigned v = g.target(e);
+            typename Context::State &w = ctx[v];
+            if (w.dist > newDist) {
+                GRAPH_STATS_INC(relaxations);
+                bool queued = w.dist != Context::INFINITE_DIST;
+                w.dist = newDist;
+                w.path = u;
+                if (queued)
+                    ctx.decreaseKey(v);
+                else
+                    ctx.insert(v);
+            }
+        }
+    }
+    return reached;
+}
+
+/*
+ * Bellman-Ford algorithm (any weights).
+ * Returns false if there is a cycle of negative weight reachable from s
+ * (the distances are then meaningless).
+ */
+template<class G>
+bool bellmanFord(const G &g, unsigned s, DistContext<typename G::WeightType> &ctx) {
+    TRACE_SCOPE("bellman_ford");
+    using Traits = WeightTraits<typename G::WeightType>;
+    using Context = DistContext<typename G::WeightType>;
+    using Dist = typename Context::DistType;
+    unsigned n = g.getNumVertex();
+    ctx.reset(n);
+    ctx[s].dist = Traits::zero();
+    for (unsigned i = 1; i < n; i++) {
+        bool changed = false;
+        for (unsigned u = 0; u < n; u++) {
+            Dist dist = ctx[u].dist;
+            if (dist == Context::INFINITE_DIST) continue;
+            for (const auto &e : g.out(u)) {
+                typename Context::State &w = ctx[g.target(e)];
+                Dist newDist = Traits::add(dist, g.weight(e));
+                if (w.dist > newDist) {
+                    GRAPH_STATS_INC(relaxations);
+                    w.dist = newDist;
+                    w.path = u;
+                    changed = true;
+                }
+            }
+        }
+        if (!changed) break;  // no more changes in the following iterations either
+    }
+    TRACE_SCOPE("bellman_ford_negative_cycle_check");
+    for (unsigned u = 0; u < n; u++) {
+        Dist dist = ctx[u].dist;
+        if (dist == Context::INFINITE_DIST) continue;
+        for (const auto &e : g.out(u))
+            if (Traits::add(dist, g.weight(e)) < ctx[g.target(e)].dist)
+                return false;
+    }
+    return true;
+}
+
+/*
+ * Ids of the vertices in the path found by the last search of ctx, from its source to t
+ * (empty if t is unreachable).
+ */
+template<class Dist>
+std::vector<unsigned> pathTo(const BasicSearchContext<Dist> &ctx, unsigned t) {
+    std::vector<unsigned> res;
+    if (ctx.get(t).dist == BasicSearchContext<Dist>::INFINITE_DIST)
+        return res;
+    for (int v = t; v != BasicSearchContext<Dist>::NONE; v = ctx.get(v).path)
+        res.push_back(v);
+    std::reverse(res.begin(), res.end());
+    return res;
+}
+
+/**
+ * Distances and predecessors between all pairs of vertices (n x n matrices, by rows).
+ */
+template<class Dist = double>
+struct AllPairsShortestPaths {
+    unsigned n = 0;
+    std::vector<Dist> dist;
+    std::vector<int> pred;  // predecessor of j in the path from i (-1 if none)
+
+    Dist getDist(unsigned i, unsigned j) const { return dist[i * n + j]; }
+
+    int getPred(unsigned i, unsigned j) const { return pred[i * n + j]; }
+
+    /*
+     * Ids of the vertices in the path from i to j (empty if there is none).
+     */
+    std::vector<unsigned> path(unsigned i, unsigned j) const {
+        std::vector<unsigned> res;
+        if (getDist(i, j) == WeightTraits<Dist>::infinity())
+            return res;
+        for (int v = j; v != -1; v = getPred(i, v))
+            res.push_back(v);
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+};
+
+/*
+ * Floyd-Warshall algorithm, O(|V|^3).
+ */
+template<class G>
+AllPairsShortestPaths<DistOf<typename G::WeightType>> floydWarshall(const G &g) {
+    TRACE_SCOPE("floyd_warshall");
+    using Traits = WeightTraits<typename G::WeightType>;
+    using Dist = typename Traits::DistType;
+    const Dist INFINITE_DIST = Traits::infinity();
+    AllPairsShortestPaths<Dist> res;
+    unsigned n = res.n = g.getNumVertex();
+    res.dist.assign(n * n, INFINITE_DIST);
+    res.pred.assign(n * n, -1);
+    for (unsigned i = 0; i < n; i++) {
+        res.dist[i * n + i] = Traits::zero();
+        for (const auto &e : g.out(i)) {
+            unsigned j = g.target(e);
+            Dist w = Traits::add(Traits::zero(), g.weight(e));
+            if (w < res.dist[i * n + j]) {
+                res.dist[i * n + j] = w;
+                res.pred[i * n + j] = i;
+            }
+        }
+    }
+    for (unsigned k = 0; k < n; k++) {
+        for (unsigned i = 0; i < n; i++) {
+            Dist ik = res.dist[i * n + k];
+            if (ik == INFINITE_DIST) continue;
+            for (unsigned j = 0; j < n; j++) {
+                Dist kj = res.dist[k * n + j];
+                if (kj == INFINITE_DIST) continue;
+                if (ik + kj < res.dist[i * n + j]) {
+                    res.dist[i * n + j] = ik + kj;
+                    res.pred[i * n + j] = res.pred[k * n + j];
+                }
+            }
+        }
+    }
+    return res;
+}
+
+}
+
+#endif /* CAL_GRAPH_SHORTEST_PATHS_H_ */
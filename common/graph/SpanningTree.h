@@ -0,0 +1,129 @@
+/*
+ * SpanningTree.h
+ * Minimum spanning trees of undirected graphs (both directions of every edge in out()).
+ * The tree is left in a DistContext<W>: the parent of each vertex ("path", NONE in the
+ * root) and the weight of the edge to it ("dist"). Prim only reaches the component of the
+ * root (the other vertices keep INFINITE_DIST); Kruskal finds a spanning forest.
+ */
+#ifndef CAL_GRAPH_SPANNING_TREE_H_
+#define CAL_GRAPH_SPANNING_TREE_H_
+
+#include <algorithm>
+#include <vector>
+#include "SearchContext.h"
+#include "WeightTraits.h"
+#include "GraphStats.h"
+#include "Trace.h"
+#include "UnionFind.h"
+
+namespace cal {
+
+/*
+ * Prim's algorithm, growing the tree from root (no tree if root is not a vertex, e.g. in an
+ * empty graph).
+ */
+template<class G>
+void prim(const G &g, unsigned root, DistContext<typename G::WeightType> &ctx) {
+    TRACE_SCOPE("prim");
+    using Context = DistContext<typename G::WeightType>;
+    using Dist = typename Context::DistType;
+    ctx.reset(g.getNumVertex());
+    if (root >= (unsigned) g.getNumVertex())
+        return;
+    ctx[root].dist = WeightTraits<typename G::WeightType>::zero();
+    ctx.insert(root);
+    while (!ctx.empty()) {
+        unsigned u = ctx.extractMin();
+        ctx[u].visited = true;
+        GRAPH_STATS_INC(verticesSettled);
+        for (const auto &e : g.out(u)) {
+            unsigned v = g.target(e);
+            Dist weight = static_cast<Dist>(g.weight(e));
+            typename Context::State &w = ctx[v];
+            if (!w.visited && w.dist > weight) {
+                GRAPH_STATS_INC(relaxations);
+                bool queued = w.dist != Context::INFINITE_DIST;
+                w.dist = weight;
+                w.path = u;
+                if (queued)
+                    ctx.decreaseKey(v);
+                else
+                    ctx.insert(v);
+            }
+        }
+    }
+}
+
+/*
+ * Kruskal's algorithm, with a disjoint-set data structure to achieve a running time
+ * O(|E| log |V|). In disconnected graphs, the result is a minimum spanning forest: the tree
+ * of the component of root is rooted at root, and each other tree at its lowest vertex.
+ * As in prim, no forest if root is not a vertex.
+ */
+template<class G>
+void kruskal(const G &g, unsigned root, DistContext<typename G::WeightType> &ctx) {
+    TRACE_SCOPE("kruskal");
+    using W = typename G::WeightType;
+    using Dist = typename DistContext<W>::DistType;
+    unsigned n = g.getNumVertex();
+    if (root >= n) {
+        ctx.reset(n);
+        return;
+    }
+    struct Candidate {
+        W weight;
+        unsigned u, v;
+    };
+    std::vector<Candidate> edges;
+    {
+        TRACE_SCOPE("kruskal_make_sets");
+        for (unsigned u = 0; u < n; u++)
+            for (const auto &e : g.out(u))
+                if (u < g.target(e))
+                    edges.push_back({g.weight(e), u, g.target(e)});
+    }
+    {
+        TRACE_SCOPE("kruskal_sort");
+        std::stable_sort(edges.begin(), edges.end(), [](const Candidate &a, const Candidate &b) {
+            return a.weight < b.weight;
+        });
+    }
+    std::vector<std::vector<Candidate>> tree(n);
+    {
+        TRACE_SCOPE("kruskal_union_find");
+        UnionFind sets(n);
+        for (const Candidate &c : edges)
+            if (sets.unite(c.u, c.v)) {
+                tree[c.u].push_back(c);
+                tree[c.v].push_back({c.weight, c.v, c.u});
+            }
+    }
+    {
+        TRACE_SCOPE("kruskal_dfs_path");
+        ctx.reset(n);
+        std::vector<unsigned> stack;
+        for (unsigned r = root, next = 0; r < n; r = next++) {
+            if (ctx[r].visited) continue;
+            ctx[r].dist = WeightTraits<W>::zero();
+            ctx[r].visited = true;
+            stack.push_back(r);
+            while (!stack.empty()) {
+                unsigned u = stack.back();
+                stack.pop_back();
+                for (const Candidate &c : tree[u]) {
+                    auto &w = ctx[c.v];
+                    if (!w.visited) {
+                        w.visited = true;
+                        w.dist = static_cast<Dist>(c.weight);
+                        w.path = u;
+                        stack.push_back(c.v);
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
+
+#endif /* CAL_GRAPH_SPANNING_TREE_H_ */
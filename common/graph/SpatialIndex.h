@@ -0,0 +1,283 @@
+/*
+ * SpatialIndex.h
+ * Static index of the positions (latitude, longitude) of the vertices and edges of a map
+ * graph, to snap arbitrary coordinates to the closest vertex or to the closest point of an
+ * edge. The positions are projected to meters around the center of the map (equirectangular,
+ * accurate at city or region scale) and bucketed in a uniform grid (CSR of cells); a query
+ * scans rings of cells around its own until no closer item can be outside the rings seen.
+ */
+#ifndef CAL_GRAPH_SPATIAL_INDEX_H_
+#define CAL_GRAPH_SPATIAL_INDEX_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+#include "Trace.h"
+
+namespace cal {
+
+class SpatialIndex {
+public:
+    /**
+     * Closest point of an edge (from, to) to a query: at the given fraction of the edge
+     * from "from", with its coordinates and the distance to the query in meters.
+     */
+    struct EdgeSnap {
+        int from = -1, to = -1;  // -1 if there are no edges
+        double fraction = 0;
+        double lat = 0, lon = 0;
+        double distance = std::numeric_limits<double>::infinity();
+    };
+
+    /*
+     * Indexes the vertices of g at the given (latitude, longitude) by id, and its edges
+     * (each pair of vertices once, whatever the direction) as straight segments.
+     */
+    template<class G>
+    SpatialIndex(const G &g, const std::vector<std::pair<double, double>> &coordinates);
+
+    /*
+     * Id of the vertex closest to (lat, lon), -1 if there are none; its distance in meters
+     * in *distance, if given.
+     */
+    int nearestVertex(double lat, double lon, double *distance = nullptr) const;
+
+    EdgeSnap nearestEdge(double lat, double lon) const;
+
+    /*
+     * Snaps many (latitude, longitude) points, split among the threads of the pool.
+     */
+    std::vector<int> nearestVertices(const std::vector<std::pair<double, double>> &points,
+                                     ThreadPool &pool = ThreadPool::global()) const;
+
+    std::vector<EdgeSnap> nearestEdges(const std::vector<std::pair<double, double>> &points,
+                                       ThreadPool &pool = ThreadPool::global()) const;
+
+    size_t memoryBytes() const {
+        return sizeof(*this) + (x.capacity() + y.capacity()) * sizeof(double)
+               + (vertexStart.capacity() + vertexItems.capacity() + edgeStart.capacity() + edgeItems.capacity()) * sizeof(unsigned)
+               + edges.capacity() * sizeof(std::pair<unsigned, unsigned>);
+    }
+
+private:
+    static constexpr double METERS_PER_DEGREE = 6371000 * M_PI / 180;
+    static constexpr size_t GRAIN = 256;
+
+    double lat0 = 0, lon0 = 0, lonScale = 1;  // projection: x = (lon - lon0) * lonScale, y = (lat - lat0)
+    std::vector<double> x, y;                 // projected position of each vertex
+    std::vector<std::pair<unsigned, unsigned>> edges;
+
+    // Grid of cols x rows cells of cellSize meters from (minX, minY); items of the cell c:
+    // vertexItems[vertexStart[c] .. vertexStart[c + 1]) and the same for the edges
+    double minX = 0, minY = 0, cellSize = 1;
+    unsigned cols = 0, rows = 0;
+    std::vector<unsigned> vertexStart, vertexItems, edgeStart, edgeItems;
+
+    double projectX(double lon) const { return (lon - lon0) * lonScale; }
+
+    double projectY(double lat) const { return (lat - lat0) * METERS_PER_DEGREE; }
+
+    unsigned column(double px) const {
+        return (unsigned) std::min(std::max((px - minX) / cellSize, 0.0), cols - 1.0);
+    }
+
+    unsigned row(double py) const {
+        return (unsigned) std::min(std::max((py - minY) / cellSize, 0.0), rows - 1.0);
+    }
+
+    /*
+     * Distance from (px, py) to the segment of the edge e, and the fraction of the edge where it is closest.
+     */
+    double segmentDistance(unsigned e, double px, double py, double &fraction) const {
+        unsigned u = edges[e].first, v = edges[e].second;
+        double dx = x[v] - x[u], dy = y[v] - y[u];
+        double length2 = dx * dx + dy * dy;
+        fraction = length2 == 0 ? 0 : std::min(1.0, std::max(0.0, ((px - x[u]) * dx + (py - y[u]) * dy) / length2));
+        double cx = x[u] + fraction * dx - px, cy = y[u] + fraction * dy - py;
+        return std::sqrt(cx * cx + cy * cy);
+    }
+
+    /*
+     * Calls visit(c) for the cells of the rings around the cell of (px, py), nearest ring first,
+     * while the items outside the rings visited may be closer than bound() (items that overlap
+     * cells of several rings are visited more than once).
+     */
+    template<class Visit, class Bound>
+    void scanRings(double px, double py, Visit visit, Bound bound) const;
+
+    /*
+     * CSR of the items of each cell, given the range of cells (col0, row0) .. (col1, row1) of each item.
+     */
+    template<class Range>
+    void bucket(size_t numItems, Range range, std::vector<unsigned> &start, std::vector<unsigned> &items) const;
+};
+
+template<class G>
+SpatialIndex::SpatialIndex(const G &g, const std::vector<std::pair<double, double>> &coordinates) {
+    TRACE_SCOPE("spatial_index");
+    unsigned n = std::min<size_t>(g.getNumVertex(), coordinates.size());
+    if (n == 0)
+        return;
+    double minLat = coordinates[0].first, maxLat = minLat, minLon = coordinates[0].second, maxLon = minLon;
+    for (unsigned u = 0; u < n; u++) {
+        minLat = std::min(minLat, coordinates[u].first);
+        maxLat = std::max(maxLat, coordinates[u].first);
+        minLon = std::min(minLon, coordinates[u].second);
+        maxLon = std::max(maxLon, coordinates[u].second);
+    }
+    lat0 = (minLat + maxLat) / 2;
+    lon0 = (minLon + maxLon) / 2;
+    lonScale = METERS_PER_DEGREE * std::cos(lat0 * M_PI / 180);
+    x.resize(n);
+    y.resize(n);
+    for (unsigned u = 0; u < n; u++) {
+        x[u] = projectX(coordinates[u].second);
+        y[u] = projectY(coordinates[u].first);
+    }
+    for (unsigned u = 0; u < n; u++)
+        for (const auto &e : g.out(u)) {
+            unsigned v = g.target(e);
+            if (v < n && v != u)
+                edges.emplace_back(std::min(u, v), std::max(u, v));
+        }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    // About two vertices per cell, if they were spread evenly
+    minX = projectX(minLon);
+    minY = projectY(minLat);
+    double width = projectX(maxLon) - minX, height = projectY(maxLat) - minY;
+    cellSize = std::max(std::sqrt(width * height * 2 / n), 1.0);
+    cols = (unsigned) (width / cellSize) + 1;
+    rows = (unsigned) (height / cellSize) + 1;
+    bucket(n, [&](size_t u, unsigned *r) {
+        r[0] = r[2] = column(x[u]);
+        r[1] = r[3] = row(y[u]);
+    }, vertexStart, vertexItems);
+    bucket(edges.size(), [&](size_t e, unsigned *r) {
+        unsigned u = edges[e].first, v = edges[e].second;
+        r[0] = column(std::min(x[u], x[v]));
+        r[1] = row(std::min(y[u], y[v]));
+        r[2] = column(std::max(x[u], x[v]));
+        r[3] = row(std::max(y[u], y[v]));
+    }, edgeStart, edgeItems);
+}
+
+template<class Range>
+void SpatialIndex::bucket(size_t numItems, Range range, std::vector<unsigned> &start,
+                          std::vector<unsigned> &items) const {
+    start.assign((size_t) cols * rows + 1, 0);
+    unsigned r[4];
+    for (size_t i = 0; i < numItems; i++) {
+        range(i, r);
+        for (unsigned row = r[1]; row <= r[3]; row++)
+            for (unsigned col = r[0]; col <= r[2]; col++)
+                start[(size_t) row * cols + col + 1]++;
+    }
+    for (size_t c = 0; c + 1 < start.size(); c++)
+        start[c + 1] += start[c];
+    items.resize(start.back());
+    std::vector<unsigned> next(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < numItems; i++) {
+        range(i, r);
+        for (unsigned row = r[1]; row <= r[3]; row++)
+            for (unsigned col = r[0]; col <= r[2]; col++)
+                items[next[(size_t) row * cols + col]++] = i;
+    }
+}
+
+template<class Visit, class Bound>
+void SpatialIndex::scanRings(double px, double py, Visit visit, Bound bound) const {
+    if (cols == 0)
+        return;
+    int cx = column(px), cy = row(py);
+    int maxRing = std::max(std::max(cx, (int) cols - 1 - cx), std::max(cy, (int) rows - 1 - cy));
+    for (int ring = 0; ring <= maxRing; ring++) {
+        for (int r = cy - ring; r <= cy + ring; r++) {
+            if (r < 0 || r >= (int) rows)
+                continue;
+            bool edgeRow = r == cy - ring || r == cy + ring;
+            for (int c = cx - ring; c <= cx + ring; c += edgeRow ? 1 : 2 * ring) {
+                if (c >= 0 && c < (int) cols)
+                    visit((size_t) r * cols + c);
+                if (ring == 0)
+                    break;
+            }
+        }
+        // Distance from the query to the outside of the rings seen (0 if it is outside them)
+        double left = px - (minX + (cx - ring) * cellSize), right = minX + (cx + ring + 1) * cellSize - px;
+        double bottom = py - (minY + (cy - ring) * cellSize), top = minY + (cy + ring + 1) * cellSize - py;
+        double outside = std::min(std::min(left, right), std::min(bottom, top));
+        if (outside > 0 && bound() <= outside)
+            return;
+    }
+}
+
+inline int SpatialIndex::nearestVertex(double lat, double lon, double *distance) const {
+    double px = projectX(lon), py = projectY(lat);
+    int best = -1;
+    double best2 = std::numeric_limits<double>::infinity();
+    scanRings(px, py, [&](size_t c) {
+        for (unsigned i = vertexStart[c]; i < vertexStart[c + 1]; i++) {
+            unsigned u = vertexItems[i];
+            double dx = x[u] - px, dy = y[u] - py, d2 = dx * dx + dy * dy;
+            if (d2 < best2 || (d2 == best2 && (int) u < best)) {
+                best2 = d2;
+                best = u;
+            }
+        }
+    }, [&]() { return std::sqrt(best2); });
+    if (distance != nullptr)
+        *distance = std::sqrt(best2);
+    return best;
+}
+
+inline SpatialIndex::EdgeSnap SpatialIndex::nearestEdge(double lat, double lon) const {
+    double px = projectX(lon), py = projectY(lat);
+    EdgeSnap res;
+    int best = -1;
+    scanRings(px, py, [&](size_t c) {
+        for (unsigned i = edgeStart[c]; i < edgeStart[c + 1]; i++) {
+            unsigned e = edgeItems[i];
+            double fraction, d = segmentDistance(e, px, py, fraction);
+            if (d < res.distance || (d == res.distance && (int) e < best)) {
+                res.distance = d;
+                res.fraction = fraction;
+                best = e;
+            }
+        }
+    }, [&]() { return res.distance; });
+    if (best >= 0) {
+        unsigned u = edges[best].first, v = edges[best].second;
+        res.from = u;
+        res.to = v;
+        res.lon = lon0 + (x[u] + res.fraction * (x[v] - x[u])) / lonScale;
+        res.lat = lat0 + (y[u] + res.fraction * (y[v] - y[u])) / METERS_PER_DEGREE;
+    }
+    return res;
+}
+
+inline std::vector<int> SpatialIndex::nearestVertices(const std::vector<std::pair<double, double>> &points,
+                                                      ThreadPool &pool) const {
+    TRACE_SCOPE("nearest_vertices");
+    std::vector<int> res(points.size());
+    parallelFor(0, points.size(), [&](size_t i) { res[i] = nearestVertex(points[i].first, points[i].second); },
+                GRAIN, pool);
+    return res;
+}
+
+inline std::vector<SpatialIndex::EdgeSnap> SpatialIndex::nearestEdges(
+        const std::vector<std::pair<double, double>> &points, ThreadPool &pool) const {
+    TRACE_SCOPE("nearest_edges");
+    std::vector<EdgeSnap> res(points.size());
+    parallelFor(0, points.size(), [&](size_t i) { res[i] = nearestEdge(points[i].first, points[i].second); },
+                GRAIN, pool);
+    return res;
+}
+
+}
+
+#endif /* CAL_GRAPH_SPATIAL_INDEX_H_ */
@@ -0,0 +1,140 @@
+/*
+ * Traversal.h
+ * Depth-first and breadth-first traversals, topological sorting (see Graph.h for the
+ * graph interface used). Vertices are identified by their ids, and the search state is
+ * kept in a SearchContext.
+ */
+#ifndef CAL_GRAPH_TRAVERSAL_H_
+#define CAL_GRAPH_TRAVERSAL_H_
+
+#include <queue>
+#include <utility>
+#include <vector>
+#include "SearchContext.h"
+
+namespace cal {
+
+/*
+ * Ids of the vertices in depth-first order, starting the search at each unvisited vertex
+ * (by id). The edges of each vertex are followed in order, as in the recursive version;
+ * the stack is explicit, so deep graphs don't overflow the call stack.
+ */
+template<class G>
+std::vector<unsigned> dfsOrder(const G &g, SearchContext &ctx) {
+    unsigned n = g.getNumVertex();
+    ctx.reset(n);
+    std::vector<unsigned> res;
+    std::vector<std::pair<unsigned, size_t>> stack;  // vertex, next edge to follow
+    for (unsigned s = 0; s < n; s++) {
+        if (ctx[s].visited) continue;
+        ctx[s].visited = true;
+        res.push_back(s);
+        stack.emplace_back(s, 0);
+        while (!stack.empty()) {
+            unsigned u = stack.back().first;
+            const auto &adj = g.out(u);
+            if (stack.back().second == adj.size()) {
+                stack.pop_back();
+                continue;
+            }
+            unsigned v = g.target(adj[stack.back().second++]);
+            if (!ctx[v].visited) {
+                ctx[v].visited = true;
+                res.push_back(v);
+                stack.emplace_back(v, 0);
+            }
+        }
+    }
+    return res;
+}
+
+/*
+ * Ids of the vertices reachable from s, in breadth-first order.
+ */
+template<class G>
+std::vector<unsigned> bfsOrder(const G &g, unsigned s, SearchContext &ctx) {
+    ctx.reset(g.getNumVertex());
+    std::vector<unsigned> res;
+    std::queue<unsigned> q;
+    ctx[s].visited = true;
+    q.push(s);
+    while (!q.empty()) {
+        unsigned u = q.front();
+        q.pop();
+        res.push_back(u);
+        for (const auto &e : g.out(u)) {
+            unsigned v = g.target(e);
+            if (!ctx[v].visited) {
+                ctx[v].visited = true;
+                q.push(v);
+            }
+        }
+    }
+    return res;
+}
+
+/*
+ * Ids of the vertices in topological order (Kahn's algorithm, with a FIFO queue),
+ * or an empty vector if the graph has cycles.
+ */
+template<class G>
+std::vector<unsigned> topologicalOrder(const G &g, SearchContext &ctx) {
+    unsigned n = g.getNumVertex();
+    ctx.reset(n);
+    for (unsigned u = 0; u < n; u++)
+        for (const auto &e : g.out(u))
+            ctx[g.target(e)].indegree++;
+    std::queue<unsigned> q;
+    for (unsigned u = 0; u < n; u++)
+        if (ctx[u].indegree == 0)
+            q.push(u);
+    std::vector<unsigned> res;
+    while (!q.empty()) {
+        unsigned u = q.front();
+        q.pop();
+        res.push_back(u);
+        for (const auto &e : g.out(u))
+            if (--ctx[g.target(e)].indegree == 0)
+                q.push(g.target(e));
+    }
+    if (res.size() != n)
+        res.clear();
+    return res;
+}
+
+/*
+ * True if the graph has no cycles: depth-first search that stops at the first edge
+ * to a vertex still in the stack.
+ */
+template<class G>
+bool isAcyclic(const G &g, SearchContext &ctx) {
+    unsigned n = g.getNumVertex();
+    ctx.reset(n);
+    std::vector<std::pair<unsigned, size_t>> stack;
+    for (unsigned s = 0; s < n; s++) {
+        if (ctx[s].visited) continue;
+        ctx[s].visited = ctx[s].processing = true;
+        stack.emplace_back(s, 0);
+        while (!stack.empty()) {
+            unsigned u = stack.back().first;
+            const auto &adj = g.out(u);
+            if (stack.back().second == adj.size()) {
+                ctx[u].processing = false;
+                stack.pop_back();
+                continue;
+            }
+            unsigned v = g.target(adj[stack.back().second++]);
+            if (ctx[v].processing)
+                return false;
+            if (!ctx[v].visited) {
+                ctx[v].visited = ctx[v].processing = true;
+                stack.emplace_back(v, 0);
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+#endif /* CAL_GRAPH_TRAVERSAL_H_ */
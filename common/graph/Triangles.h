@@ -0,0 +1,242 @@
+/*
+ * Triangles.h
+ * Triangles of a graph, taken as undirected and simple (edge directions, repeated edges and
+ * self loops are ignored), and the local clustering coefficient of each vertex: the fraction
+ * of the pairs of its neighbours that are adjacent.
+ * Each edge is oriented from the endpoint of lower degree to the one of higher degree (ties
+ * by id), so that every triangle is found once and no vertex has more than O(sqrt(m))
+ * out-neighbours (Schank and Wagner, 2005); the triangles through an edge u -> v are the
+ * common out-neighbours of u and v, found by merging their sorted lists (CSR, with the
+ * vertices renumbered in that order), four elements of each list at a time with SSE2.
+ */
+#ifndef CAL_GRAPH_TRIANGLES_H_
+#define CAL_GRAPH_TRIANGLES_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "ThreadPool.h"
+#include "Trace.h"
+
+namespace cal {
+
+struct Triangles {
+    uint64_t total = 0;
+    std::vector<uint64_t> count;     // triangles through each vertex
+    std::vector<double> clustering;  // local clustering coefficient of each vertex (0 below 2 neighbours)
+
+    double averageClustering() const {
+        double sum = 0;
+        for (double c : clustering)
+            sum += c;
+        return clustering.empty() ? 0 : sum / clustering.size();
+    }
+};
+
+namespace detail {
+
+/*
+ * Calls found(x) for each x in both sorted lists (without repeats) [a, a + na) and
+ * [b, b + nb), merging them without branches on the comparisons (they are unpredictable).
+ */
+template<class F>
+void mergeSorted(const unsigned *a, size_t na, const unsigned *b, size_t nb, F found) {
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        unsigned x = a[i], y = b[j];
+        if (x == y)
+            found(x);
+        i += x <= y;
+        j += y <= x;
+    }
+}
+
+#ifdef __SSE2__
+/*
+ * mergeSorted by blocks of four: each block of a is compared with the four rotations of the
+ * block of b, and the block with the smaller last element is passed (both, if equal), as
+ * none of its elements can be in the rest of the other list. The tails are merged one by one.
+ */
+template<class F>
+void mergeSortedSse2(const unsigned *a, size_t na, const unsigned *b, size_t nb, F found) {
+    size_t i = 0, j = 0;
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i x = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *) (b + j));
+        __m128i y1 = _mm_shuffle_epi32(y, _MM_SHUFFLE(0, 3, 2, 1));
+        __m128i y2 = _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2));
+        __m128i y3 = _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 1, 0, 3));
+        __m128i equal = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(x, y), _mm_cmpeq_epi32(x, y1)),
+                                     _mm_or_si128(_mm_cmpeq_epi32(x, y2), _mm_cmpeq_epi32(x, y3)));
+        for (int mask = _mm_movemask_ps(_mm_castsi128_ps(equal)); mask != 0; mask &= mask - 1)
+            found(a[i + __builtin_ctz(mask)]);
+        unsigned lastA = a[i + 3], lastB = b[j + 3];
+        i += lastA <= lastB ? 4 : 0;
+        j += lastB <= lastA ? 4 : 0;
+    }
+    mergeSorted(a + i, na - i, b + j, nb - j, found);
+}
+#endif
+
+/*
+ * Calls found(x) for each x in both sorted lists (without repeats) [a, a + na) and
+ * [b, b + nb), in increasing order: by merging them, or, when one list is much longer, by
+ * looking the elements of the shorter one up in it by binary search.
+ */
+template<class F>
+void intersectSorted(const unsigned *a, size_t na, const unsigned *b, size_t nb, F found) {
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (na * 32 < nb) {
+        const unsigned *from = b, *end = b + nb;
+        for (size_t i = 0; i < na && from != end; i++) {
+            from = std::lower_bound(from, end, a[i]);
+            if (from != end && *from == a[i])
+                found(a[i]);
+        }
+        return;
+    }
+#ifdef __SSE2__
+    mergeSortedSse2(a, na, b, nb, found);
+#else
+    mergeSorted(a, na, b, nb, found);
+#endif
+}
+
+}
+
+/*
+ * Triangles through each vertex of g (by id), with the vertices split among the threads of
+ * the pool (each chunk of vertices adding to counters that no other running chunk uses,
+ * summed at the end).
+ */
+template<class G>
+Triangles countTriangles(const G &g, ThreadPool &pool = ThreadPool::global()) {
+    TRACE_SCOPE("triangles");
+    unsigned n = g.getNumVertex();
+    const size_t GRAIN = 256;
+
+    // Neighbours of each vertex in both directions, then sorted without repeats
+    std::vector<size_t> first(n + 1, 0);
+    for (unsigned u = 0; u < n; u++)
+        for (const auto &e : g.out(u)) {
+            unsigned v = g.target(e);
+            if (v != u) {
+                first[u + 1]++;
+                first[v + 1]++;
+            }
+        }
+    for (unsigned u = 0; u < n; u++)
+        first[u + 1] += first[u];
+    std::vector<unsigned> all(first[n]);
+    {
+        std::vector<size_t> next(first.begin(), first.end() - 1);
+        for (unsigned u = 0; u < n; u++)
+            for (const auto &e : g.out(u)) {
+                unsigned v = g.target(e);
+                if (v != u) {
+                    all[next[u]++] = v;
+                    all[next[v]++] = u;
+                }
+            }
+    }
+    std::vector<unsigned> degree(n);
+    parallelFor(0, n, [&](size_t u) {
+        auto begin = all.begin() + first[u], end = all.begin() + first[u + 1];
+        std::sort(begin, end);
+        degree[u] = std::unique(begin, end) - begin;
+    }, GRAIN, pool);
+
+    // Renumbers the vertices by increasing degree (ties by id, counting sort): the edges go
+    // from lower to higher numbers, and the lists of the vertices of high degree are short
+    unsigned maxDegree = n == 0 ? 0 : *std::max_element(degree.begin(), degree.end());
+    std::vector<unsigned> rank(n), byRank(n), start(maxDegree + 2, 0);
+    for (unsigned u = 0; u < n; u++)
+        start[degree[u] + 1]++;
+    for (unsigned d = 0; d <= maxDegree; d++)
+        start[d + 1] += start[d];
+    for (unsigned u = 0; u < n; u++) {
+        rank[u] = start[degree[u]]++;
+        byRank[rank[u]] = u;
+    }
+    std::vector<size_t> offsets(n + 1, 0);
+    for (unsigned r = 0; r < n; r++) {
+        unsigned u = byRank[r], out = 0;
+        for (size_t i = first[u]; i < first[u] + degree[u]; i++)
+            out += rank[all[i]] > r;
+        offsets[r + 1] = offsets[r] + out;
+    }
+    std::vector<unsigned> targets(offsets[n]);
+    parallelFor(0, n, [&](size_t r) {
+        unsigned u = byRank[r];
+        size_t k = offsets[r];
+        for (size_t i = first[u]; i < first[u] + degree[u]; i++)
+            if (rank[all[i]] > r)
+                targets[k++] = rank[all[i]];
+        std::sort(targets.begin() + offsets[r], targets.begin() + k);
+    }, GRAIN, pool);
+    std::vector<unsigned>().swap(all);
+
+    // Each chunk takes a set of counters from the idle ones (or a new set) and gives it back at
+    // the end: not one set per thread, as a chunk may run on any thread, including threads
+    // outside the pool that help while waiting for their own tasks. The third vertex w of a
+    // triangle r -> v -> w is after v in the list of r.
+    std::mutex idleLock;
+    std::vector<std::unique_ptr<std::vector<uint64_t>>> counters;
+    std::vector<std::vector<uint64_t> *> idle;
+    Triangles res;
+    res.total = parallelReduce(0, n, uint64_t(0), [&](size_t lo, size_t hi) {
+        std::vector<uint64_t> *count;
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+            if (idle.empty()) {
+                counters.emplace_back(new std::vector<uint64_t>(n, 0));
+                idle.push_back(counters.back().get());
+            }
+            count = idle.back();
+            idle.pop_back();
+        }
+        uint64_t total = 0;
+        for (size_t r = lo; r < hi; r++) {
+            const unsigned *out = targets.data() + offsets[r];
+            size_t outDegree = offsets[r + 1] - offsets[r];
+            for (size_t i = 0; i + 1 < outDegree; i++) {
+                unsigned v = out[i];
+                uint64_t found = 0;
+                detail::intersectSorted(out + i + 1, outDegree - i - 1, targets.data() + offsets[v],
+                                        offsets[v + 1] - offsets[v], [&](unsigned w) {
+                                            (*count)[w]++;
+                                            found++;
+                                        });
+                (*count)[r] += found;
+                (*count)[v] += found;
+                total += found;
+            }
+        }
+        std::lock_guard<std::mutex> guard(idleLock);
+        idle.push_back(count);
+        return total;
+    }, [](uint64_t a, uint64_t b) { return a + b; }, GRAIN, pool);
+
+    res.count.assign(n, 0);
+    for (const auto &c : counters)
+        for (unsigned u = 0; u < n; u++)
+            res.count[u] += (*c)[rank[u]];
+    res.clustering.assign(n, 0);
+    for (unsigned u = 0; u < n; u++)
+        if (degree[u] >= 2)
+            res.clustering[u] = 2.0 * res.count[u] / ((double) degree[u] * (degree[u] - 1));
+    return res;
+}
+
+}
+
+#endif /* CAL_GRAPH_TRIANGLES_H_ */
@@ -0,0 +1,414 @@
+/*
+ * Tsp.h
+ * Short tours through a set of stops (traveling salesman heuristics), on the matrix of the
+ * costs between them, which need not be symmetric (e.g. the shortest path distances of a road
+ * map, see distanceMatrix):
+ *   - construction: nearest neighbour, or greedy edge (the cheapest connections from the
+ *     neighbour lists that leave every stop with at most one successor and one predecessor and
+ *     close no cycle, then the resulting paths joined, each end to the nearest free start);
+ *   - improvement: 2-opt (two connections replaced, reversing the stops between them) and
+ *     Or-opt (up to 3 consecutive stops moved elsewhere, possibly reversed), until no move
+ *     improves the tour. The moves tried from a stop only connect it to its nearest stops
+ *     (neighbour lists), and a stop is only tried again once a connection next to it changed
+ *     (don't-look bits). The cost of a stretch of the tour in either direction comes from
+ *     prefix sums, so the asymmetric costs of the reversed stretches are exact;
+ *   - restarts: from the improved tour, chains of random double bridges (two short consecutive
+ *     stretches swapped) each followed by a local search from the stops next to the changes,
+ *     keeping the tour when it gets shorter (iterated local search); the chains are split
+ *     among threads, and the best tour is kept.
+ */
+#ifndef CAL_GRAPH_TSP_H_
+#define CAL_GRAPH_TSP_H_
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "SearchContext.h"
+#include "ShortestPaths.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include "UnionFind.h"
+
+namespace cal {
+
+enum class TspConstruction { NearestNeighbour, GreedyEdge };
+
+struct TspOptions {
+    TspConstruction construction = TspConstruction::GreedyEdge;
+    bool twoOpt = true;
+    bool orOpt = true;
+    unsigned restarts = 1;  // independent chains of perturbations, split among threads
+    unsigned kicks = 100;   // perturbations tried by each chain
+    unsigned seed = 0;
+};
+
+struct TspTour {
+    std::vector<unsigned> order;  // stops, from stop 0 (the tour returns to it)
+    double cost = 0;              // infinite if it uses a missing connection
+};
+
+/*
+ * Costs (k x k matrix, by rows) of the shortest paths in g between the k given vertices,
+ * infinite where there is no path: one Dijkstra search per stop, split among the threads of
+ * the pool.
+ */
+template<class G>
+std::vector<double> distanceMatrix(const G &g, const std::vector<unsigned> &stops,
+                                   ThreadPool &pool = ThreadPool::global()) {
+    TRACE_SCOPE("distance_matrix");
+    using Context = DistContext<typename G::WeightType>;
+    size_t k = stops.size();
+    std::vector<double> res(k * k);
+    parallelFor(0, k, [&](size_t i) {
+        Context &ctx = Context::local();
+        dijkstra(g, stops[i], ctx);
+        for (size_t j = 0; j < k; j++) {
+            auto dist = ctx.get(stops[j]).dist;
+            res[i * k + j] = dist == Context::INFINITE_DIST ? std::numeric_limits<double>::infinity() : (double) dist;
+        }
+    }, 1, pool);
+    return res;
+}
+
+/**
+ * Tours through the n stops of an n x n cost matrix (by rows; it must outlive the solver and
+ * not change), with the given number of nearest stops of each one as the candidates of the moves.
+ * Missing connections (infinite costs) are taken as more expensive than any tour without them.
+ */
+class TspSolver {
+public:
+    explicit TspSolver(const std::vector<double> &costs, unsigned numNeighbours = 10,
+                       ThreadPool &pool = ThreadPool::global());
+
+    unsigned getNumStops() const { return n; }
+
+    std::vector<unsigned> construct(TspConstruction construction) const;
+
+    /*
+     * Improves the tour (a permutation of the stops) with the moves enabled, until none applies.
+     */
+    void improve(std::vector<unsigned> &tour, bool twoOpt = true, bool orOpt = true) const;
+
+    double tourCost(const std::vector<unsigned> &tour) const;
+
+    TspTour solve(const TspOptions &options = {}, ThreadPool &pool = ThreadPool::global()) const;
+
+private:
+    struct Search;
+
+    const std::vector<double> &costs;
+    unsigned n;
+    double missing = 1;                  // cost of the missing connections
+    unsigned numNeighbours;
+    std::vector<unsigned> neighbours;    // of the stop i: [i * numNeighbours, (i + 1) * numNeighbours), nearest first
+
+    double cost(unsigned i, unsigned j) const {
+        double c = costs[(size_t) i * n + j];
+        return c < missing ? c : missing;
+    }
+
+    const unsigned *neighboursOf(unsigned i) const { return neighbours.data() + (size_t) i * numNeighbours; }
+};
+
+inline TspSolver::TspSolver(const std::vector<double> &costs, unsigned numNeighbours, ThreadPool &pool)
+        : costs(costs), n(std::sqrt((double) costs.size()) + 0.5) {
+    double maxCost = 0;
+    for (double c : costs)
+        if (c != std::numeric_limits<double>::infinity())
+            maxCost = std::max(maxCost, c);
+    missing = (maxCost + 1) * (n + 1);
+    this->numNeighbours = std::min(numNeighbours, n == 0 ? 0 : n - 1);
+    neighbours.resize((size_t) n * this->numNeighbours);
+    parallelFor(0, n, [&](size_t i) {
+        std::vector<unsigned> others;
+        for (unsigned j = 0; j < n; j++)
+            if (j != i)
+                others.push_back(j);
+        auto nearer = [&](unsigned a, unsigned b) { return cost(i, a) < cost(i, b) || (cost(i, a) == cost(i, b) && a < b); };
+        std::partial_sort(others.begin(), others.begin() + this->numNeighbours, others.end(), nearer);
+        std::copy(others.begin(), others.begin() + this->numNeighbours, neighbours.begin() + i * this->numNeighbours);
+    }, 64, pool);
+}
+
+inline std::vector<unsigned> TspSolver::construct(TspConstruction construction) const {
+    TRACE_SCOPE("tsp_construct");
+    std::vector<unsigned> tour;
+    if (n == 0)
+        return tour;
+    if (construction == TspConstruction::NearestNeighbour) {
+        std::vector<bool> used(n, false);
+        unsigned u = 0;
+        used[0] = true;
+        tour.push_back(0);
+        while (tour.size() < n) {
+            unsigned best = n;
+            for (unsigned v = 0; v < n; v++)
+                if (!used[v] && (best == n || cost(u, v) < cost(u, best)))
+                    best = v;
+            used[best] = true;
+            tour.push_back(best);
+            u = best;
+        }
+        return tour;
+    }
+
+    // Greedy edge: paths of the cheapest candidate connections
+    std::vector<std::tuple<double, unsigned, unsigned>> candidates;
+    for (unsigned u = 0; u < n; u++)
+        for (unsigned k = 0; k < numNeighbours; k++)
+            candidates.emplace_back(cost(u, neighboursOf(u)[k]), u, neighboursOf(u)[k]);
+    std::sort(candidates.begin(), candidates.end());
+    const unsigned NONE = n;
+    std::vector<unsigned> next(n, NONE), prev(n, NONE);
+    UnionFind paths(n);
+    for (const auto &c : candidates) {
+        unsigned u = std::get<1>(c), v = std::get<2>(c);
+        if (next[u] == NONE && prev[v] == NONE && paths.unite(u, v)) {
+            next[u] = v;
+            prev[v] = u;
+        }
+    }
+    // Joins the paths: from the end of the one of stop 0 to the nearest start of the others
+    std::vector<unsigned> starts;
+    for (unsigned u = 0; u < n; u++)
+        if (prev[u] == NONE)
+            starts.push_back(u);
+    unsigned start = 0;
+    while (prev[start] != NONE)
+        start = prev[start];
+    starts.erase(std::find(starts.begin(), starts.end(), start));
+    for (;;) {
+        for (unsigned u = start; u != NONE; u = next[u])
+            tour.push_back(u);
+        if (starts.empty())
+            break;
+        unsigned last = tour.back(), best = 0;
+        for (unsigned i = 1; i < starts.size(); i++)
+            if (cost(last, starts[i]) < cost(last, starts[best]))
+                best = i;
+        start = starts[best];
+        starts[best] = starts.back();
+        starts.pop_back();
+    }
+    std::rotate(tour.begin(), std::find(tour.begin(), tour.end(), 0u), tour.end());
+    return tour;
+}
+
+/**
+ * Local search on one tour: positions of the stops, the cost of the tour from its first stop
+ * up to each one (forward) and back from each one to it (backward), and the stops to try.
+ */
+struct TspSolver::Search {
+    const TspSolver &s;
+    std::vector<unsigned> &tour;
+    unsigned n;
+    std::vector<unsigned> pos;
+    std::vector<double> forward, backward;
+    std::deque<unsigned> queue;
+    std::vector<bool> queued;
+    double epsilon;  // smallest improvement taken, against rounding errors
+
+    // Tries the stops given (all if none)
+    Search(const TspSolver &s, std::vector<unsigned> &tour, const std::vector<unsigned> *start)
+            : s(s), tour(tour), n(tour.size()), pos(n), forward(n, 0), backward(n, 0), queued(n, start == nullptr) {
+        update(0);
+        if (start == nullptr)
+            queue.assign(tour.begin(), tour.end());
+        else
+            for (unsigned u : *start)
+                wake(u);
+        epsilon = 1e-9 * (cost() / n + 1);
+    }
+
+    double cost() const { return forward[n - 1] + s.cost(tour[n - 1], tour[0]); }
+
+    double run(bool twoOpt, bool orOpt) {
+        while (!queue.empty()) {
+            unsigned a = queue.front();
+            queue.pop_front();
+            queued[a] = false;
+            if ((twoOpt && tryTwoOpt(a)) || (orOpt && tryOrOpt(a)))
+                wake(a);
+        }
+        return cost();
+    }
+
+    unsigned at(long i) const { return tour[((i % n) + n) % n]; }
+
+    // Cost of the stretch of the tour from the position i to j (i <= j), forward or backward
+    double stretch(unsigned i, unsigned j) const { return forward[j] - forward[i]; }
+
+    double reversed(unsigned i, unsigned j) const { return backward[j] - backward[i]; }
+
+    void update(unsigned from) {
+        for (unsigned k = from; k < n; k++) {
+            pos[tour[k]] = k;
+            if (k > 0) {
+                forward[k] = forward[k - 1] + s.cost(tour[k - 1], tour[k]);
+                backward[k] = backward[k - 1] + s.cost(tour[k], tour[k - 1]);
+            }
+        }
+    }
+
+    void wake(unsigned u) {
+        if (!queued[u]) {
+            queued[u] = true;
+            queue.push_back(u);
+        }
+    }
+
+    /*
+     * Replaces the connections after the positions i and j (i < j) by tour[i] -> tour[j] and
+     * tour[i + 1] -> tour[j + 1], reversing the stops in between, if that is shorter.
+     */
+    bool twoOpt(unsigned i, unsigned j) {
+        if (i > j)
+            std::swap(i, j);
+        if (j < i + 2)
+            return false;
+        unsigned a = tour[i], b = tour[i + 1], c = tour[j], d = at(j + 1);
+        double delta = s.cost(a, c) + s.cost(b, d) - s.cost(a, b) - s.cost(c, d) + reversed(i + 1, j) - stretch(i + 1, j);
+        if (delta >= -epsilon)
+            return false;
+        std::reverse(tour.begin() + i + 1, tour.begin() + j + 1);
+        update(i + 1);
+        for (unsigned u : {a, b, c, d})
+            wake(u);
+        return true;
+    }
+
+    bool tryTwoOpt(unsigned a) {
+        unsigned i = pos[a];
+        double limit = std::max(s.cost(a, at(i + 1)), s.cost(at((long) i - 1), a));
+        const unsigned *near = s.neighboursOf(a);
+        for (unsigned k = 0; k < s.numNeighbours && s.cost(a, near[k]) < limit; k++) {
+            unsigned j = pos[near[k]];
+            // Connecting a to near[k] after both, or before both
+            if (twoOpt(i, j) || twoOpt((i + n - 1) % n, (j + n - 1) % n))
+                return true;
+        }
+        return false;
+    }
+
+    /*
+     * Moves the stops at the positions first .. last (first > 0) between the positions k and
+     * k + 1 (outside them), in the same or in the reverse order, if that is shorter.
+     */
+    bool orOpt(unsigned first, unsigned last, unsigned k, double removed) {
+        if (k + 1 >= first && k <= last)
+            return false;
+        unsigned head = tour[first], tail = tour[last], x = tour[k], y = at(k + 1);
+        double same = s.cost(x, head) + s.cost(tail, y) - s.cost(x, y) - removed;
+        double reverse = s.cost(x, tail) + s.cost(head, y) - s.cost(x, y) + reversed(first, last) - stretch(first, last)
+                         - removed;
+        if (std::min(same, reverse) >= -epsilon)
+            return false;
+        unsigned before = tour[first - 1], after = at(last + 1), from;
+        if (k > last) {
+            std::rotate(tour.begin() + first, tour.begin() + last + 1, tour.begin() + k + 1);
+            from = first;
+            first = k - (last - first);
+            last = k;
+        } else {
+            std::rotate(tour.begin() + k + 1, tour.begin() + first, tour.begin() + last + 1);
+            from = k + 1;
+            last = k + 1 + (last - first);
+            first = k + 1;
+        }
+        if (reverse < same)
+            std::reverse(tour.begin() + first, tour.begin() + last + 1);
+        update(from);
+        for (unsigned u : {head, tail, before, after, x, y})
+            wake(u);
+        return true;
+    }
+
+    bool tryOrOpt(unsigned a) {
+        const unsigned *near = s.neighboursOf(a);
+        for (unsigned length = 1; length <= 3 && length + 2 <= n; length++)
+            // The stretches that start at a, then the ones that end at it
+            for (unsigned end = 0; end < (length == 1 ? 1 : 2); end++) {
+                if (end == 1 && pos[a] + 1 < length)
+                    continue;
+                unsigned first = end == 0 ? pos[a] : pos[a] + 1 - length, last = first + length - 1;
+                if (first == 0 || last >= n)
+                    continue;
+                double removed = s.cost(tour[first - 1], tour[first]) + s.cost(tour[last], at(last + 1))
+                                 - s.cost(tour[first - 1], at(last + 1));
+                if (removed <= epsilon)
+                    continue;
+                for (unsigned k = 0; k < s.numNeighbours && s.cost(a, near[k]) < removed; k++) {
+                    unsigned j = pos[near[k]];
+                    if (orOpt(first, last, j, removed) || orOpt(first, last, (j + n - 1) % n, removed))
+                        return true;
+                }
+            }
+        return false;
+    }
+};
+
+inline void TspSolver::improve(std::vector<unsigned> &tour, bool twoOpt, bool orOpt) const {
+    TRACE_SCOPE("tsp_improve");
+    if (tour.size() >= 3)
+        Search(*this, tour, nullptr).run(twoOpt, orOpt);
+}
+
+inline double TspSolver::tourCost(const std::vector<unsigned> &tour) const {
+    double res = 0;
+    for (size_t k = 0; k < tour.size(); k++)
+        res += costs[(size_t) tour[k] * n + tour[(k + 1) % tour.size()]];
+    return res;
+}
+
+inline TspTour TspSolver::solve(const TspOptions &options, ThreadPool &pool) const {
+    TRACE_SCOPE("tsp");
+    std::vector<unsigned> initial = construct(options.construction);
+    improve(initial, options.twoOpt, options.orOpt);
+    std::vector<std::vector<unsigned>> tours(std::max(options.restarts, 1u), initial);
+    const unsigned MAX_STRETCH = 50;
+    if (n >= 8 && options.kicks > 0)
+        parallelFor(0, tours.size(), [&](size_t r) {
+            std::vector<unsigned> &tour = tours[r], kicked, changed;
+            double cost = Search(*this, tour, &changed).cost();
+            std::mt19937 gen(options.seed + r);
+            for (unsigned kick = 0; kick < options.kicks; kick++) {
+                // Swaps the stretches [first, middle) and [middle, last)
+                unsigned length = std::min(MAX_STRETCH, (n - 1) / 2);
+                unsigned a = std::uniform_int_distribution<unsigned>(1, length)(gen);
+                unsigned b = std::uniform_int_distribution<unsigned>(1, length)(gen);
+                unsigned first = std::uniform_int_distribution<unsigned>(1, n - a - b)(gen);
+                unsigned middle = first + a, last = middle + b;
+                kicked = tour;
+                changed = {kicked[first - 1], kicked[first], kicked[middle - 1], kicked[middle], kicked[last - 1],
+                           kicked[last % n]};
+                std::rotate(kicked.begin() + first, kicked.begin() + middle, kicked.begin() + last);
+                double kickedCost = Search(*this, kicked, &changed).run(options.twoOpt, options.orOpt);
+                if (kickedCost < cost) {
+                    cost = kickedCost;
+                    tour.swap(kicked);
+                }
+            }
+        }, 1, pool);
+
+    TspTour res;
+    size_t best = 0;
+    std::vector<double> cost(tours.size());
+    for (size_t r = 0; r < tours.size(); r++) {
+        cost[r] = tourCost(tours[r]);
+        if (cost[r] < cost[best])
+            best = r;
+    }
+    res.order = std::move(tours[best]);
+    res.cost = cost[best];
+    if (!res.order.empty())
+        std::rotate(res.order.begin(), std::find(res.order.begin(), res.order.end(), 0u), res.order.end());
+    return res;
+}
+
+}
+
+#endif /* CAL_GRAPH_TSP_H_ */
@@ -0,0 +1,56 @@
+/*
+ * UnionFind.h
+ * Disjoint sets of the ids 0 .. n-1 (page 571, Introduction to Algorithms):
+ * union by rank and path compression.
+ */
+#ifndef CAL_GRAPH_UNION_FIND_H_
+#define CAL_GRAPH_UNION_FIND_H_
+
+#include <vector>
+
+namespace cal {
+
+class UnionFind {
+    std::vector<unsigned> parent;
+    std::vector<unsigned char> rank;
+
+public:
+    explicit UnionFind(unsigned n) : parent(n), rank(n, 0) {
+        for (unsigned i = 0; i < n; i++)
+            parent[i] = i;
+    }
+
+    unsigned find(unsigned x) {
+        unsigned root = x;
+        while (parent[root] != root)
+            root = parent[root];
+        while (parent[x] != root) {
+            unsigned next = parent[x];
+            parent[x] = root;
+            x = next;
+        }
+        return root;
+    }
+
+    /*
+     * Joins the sets of x and y; returns false if they were already the same set.
+     */
+    bool unite(unsigned x, unsigned y) {
+        x = find(x);
+        y = find(y);
+        if (x == y)
+            return false;
+        if (rank[x] > rank[y])
+            parent[y] = x;
+        else {
+            parent[x] = y;
+            if (rank[x] == rank[y])
+                rank[y]++;
+        }
+        return true;
+    }
+};
+
+}
+
+#endif /* CAL_GRAPH_UNION_FIND_H_ */
@@ -0,0 +1,155 @@
+/*
+ * WeightTraits.h
+ * Types of edge weights (and capacities, flows, costs) of the graph library, and the type
+ * of the path lengths computed with them:
+ *   - floating point (double, float): lengths of the same type;
+ *   - integers (e.g. uint32_t): 64 bit lengths, exact and saturating at infinity();
+ *   - Fixed<FRAC_BITS>: fixed point (32 bit, FRAC_BITS fractional bits), 64 bit lengths.
+ */
+#ifndef CAL_GRAPH_WEIGHT_TRAITS_H_
+#define CAL_GRAPH_WEIGHT_TRAITS_H_
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace cal {
+
+/**
+ * Fixed point number: value = raw / 2^FRAC_BITS, stored in Rep (a signed integer).
+ */
+template<unsigned FRAC_BITS, class Rep = int32_t>
+class Fixed {
+    static_assert(std::is_signed<Rep>::value && FRAC_BITS < sizeof(Rep) * 8 - 1, "invalid fixed point format");
+
+public:
+    using RepType = Rep;
+    static constexpr unsigned FRACTION_BITS = FRAC_BITS;
+
+    constexpr Fixed() = default;
+
+    Fixed(double value) : raw(Rep(std::llround(value * (double) ONE))) {}
+
+    template<class R>
+    constexpr explicit Fixed(const Fixed<FRAC_BITS, R> &other) : raw(Rep(other.getRaw())) {}
+
+    static constexpr Fixed fromRaw(Rep raw) {
+        Fixed f;
+        f.raw = raw;
+        return f;
+    }
+
+    constexpr Rep getRaw() const { return raw; }
+
+    constexpr double toDouble() const { return (double) raw / (double) ONE; }
+
+    constexpr explicit operator double() const { return toDouble(); }
+
+    constexpr Fixed operator+(Fixed other) const { return fromRaw(raw + other.raw); }
+
+    constexpr Fixed operator-(Fixed other) const { return fromRaw(raw - other.raw); }
+
+    constexpr Fixed operator-() const { return fromRaw(-raw); }
+
+    Fixed &operator+=(Fixed other) {
+        raw += other.raw;
+        return *this;
+    }
+
+    Fixed &operator-=(Fixed other) {
+        raw -= other.raw;
+        return *this;
+    }
+
+    constexpr bool operator<(Fixed other) const { return raw < other.raw; }
+
+    constexpr bool operator>(Fixed other) const { return raw > other.raw; }
+
+    constexpr bool operator<=(Fixed other) const { return raw <= other.raw; }
+
+    constexpr bool operator>=(Fixed other) const { return raw >= other.raw; }
+
+    constexpr bool operator==(Fixed other) const { return raw == other.raw; }
+
+    constexpr bool operator!=(Fixed other) const { return raw != other.raw; }
+
+private:
+    static constexpr Rep ONE = Rep(1) << FRAC_BITS;
+    Rep raw = 0;
+};
+
+/**
+ * WeightTraits<W>::DistType   type of the path lengths (sums of weights)
+ * WeightTraits<W>::infinity() length of the paths to unreachable vertices
+ * WeightTraits<W>::add(d, w)  d + w, saturating at infinity()
+ * WeightTraits<W>::toDouble(d) for the interfaces that report lengths as double
+ *                              (infinity() as std::numeric_limits<double>::max())
+ */
+template<class W, class Enable = void>
+struct WeightTraits;
+
+template<class W>
+struct WeightTraits<W, typename std::enable_if<std::is_floating_point<W>::value>::type> {
+    using DistType = W;
+
+    static constexpr DistType infinity() { return std::numeric_limits<W>::max(); }
+
+    static constexpr DistType zero() { return 0; }
+
+    static DistType add(DistType d, W w) {
+        return d == infinity() ? d : d + w;
+    }
+
+    static double toDouble(DistType d) {
+        return d == infinity() ? std::numeric_limits<double>::max() : (double) d;
+    }
+};
+
+template<class W>
+struct WeightTraits<W, typename std::enable_if<std::is_integral<W>::value>::type> {
+    using DistType = typename std::conditional<std::is_signed<W>::value, int64_t, uint64_t>::type;
+
+    static constexpr DistType infinity() { return std::numeric_limits<DistType>::max(); }
+
+    static constexpr DistType zero() { return 0; }
+
+    static DistType add(DistType d, W w) {
+        if (d == infinity() || (w > 0 && d > infinity() - (DistType) w))
+            return infinity();
+        return d + w;
+    }
+
+    static double toDouble(DistType d) {
+        return d == infinity() ? std::numeric_limits<double>::max() : (double) d;
+    }
+};
+
+template<unsigned FRAC_BITS, class Rep>
+struct WeightTraits<Fixed<FRAC_BITS, Rep>> {
+    using DistType = Fixed<FRAC_BITS, int64_t>;
+
+    static constexpr DistType infinity() { return DistType::fromRaw(std::numeric_limits<int64_t>::max()); }
+
+    static constexpr DistType zero() { return DistType(); }
+
+    static DistType add(DistType d, Fixed<FRAC_BITS, Rep> w) {
+        if (d == infinity() || (w.getRaw() > 0 && d.getRaw() > infinity().getRaw() - w.getRaw()))
+            return infinity();
+        return DistType::fromRaw(d.getRaw() + w.getRaw());
+    }
+
+    static double toDouble(DistType d) {
+        return d == infinity() ? std::numeric_limits<double>::max() : d.toDouble();
+    }
+};
+
+/*
+ * Type of the path lengths with weights of type W (its own WeightTraits use the same type).
+ */
+template<class W>
+using DistOf = typename WeightTraits<W>::DistType;
+
+}
+
+#endif /* CAL_GRAPH_WEIGHT_TRAITS_H_ */